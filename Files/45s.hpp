@@ -1,15 +1,13 @@
 // Copyright Andrew Bernal 2023
 #pragma once
-#include <algorithm>
-#include <string>
-#include <vector>
-#include <utility>
-#include "deck.hpp"
-#include "card.hpp"
+#include <functional>
+#include "basicX45s.hpp"
 #include "player.hpp"
 
 // start with an x because I can't start with a number
-class x45s {
+// The engine with players chosen at runtime. Every call to a player goes through its virtual
+// functions. For a fixed line-up of players, basic_x45s with the player types is faster.
+class x45s : public basic_x45s<PlayerRef, PlayerRef, PlayerRef, PlayerRef> {
  public:
         // no default constructor, have to give it the players at initalization
         x45s() = delete;
@@ -19,75 +17,18 @@ class x45s {
         x45s(Player* p1, Player* p2, Player* p3, Player* p4);
         ~x45s() {
                 if (initalizedPlayersWithNew) {
-                        for (auto player : players) {
-                                delete player;
-                        }
+                        delete &getPlayer(0);
+                        delete &getPlayer(1);
+                        delete &getPlayer(2);
+                        delete &getPlayer(3);
                 }
         }
-        void deal_players();
-        void shuffle();
-        void reset();
-        // deal the kiddie to the player who won the bid. (0-3)
-        void deal_kiddie(int winner);
-        // evaluate the trick thrown by all four players. Returns the winning card
-        Card evaluate_trick(
-                const Card& card1, const Card& card2, const Card& card3, const Card& card4);
-        Card evaluate_trick(std::vector<Card> c);
 
-        // Increments the team's score by 5 (team is either 0 or 1)
-        void updateScores(int team);
-
-        bool hasWon();
-        // Returns the number of the player that has won the game (from 0 to 3).
-        // Returns -1 if no one has won
-        int whichTeamWon();
-        // calls the player discard method for each player
-        void havePlayersDiscard();
-        // getters
-        int getBidAmount() { return bidAmount; }
-        int getBidder() { return bidder; }
-
-        // Has each player bid & returns the player who won the bid (0, 1, 2, 3)
-        void biddingPhase();
-        // returns the trump
-        Suit::Suit getTrump() { return trump; }
-
-        int getHandSize(int playerNum) {
-                return players[playerNum]->getSize();
-        }
-        int getNumPlayers() {
-                return players.size();
-        }
+        using basic_x45s::getPlayer;
         const Player& getPlayer(int playerNum) {
-                return *(players[playerNum]);
+                return withPlayer(playerNum, [](PlayerRef& p) -> Player& { return p.get(); });
         }
 
-        bool deductAfterBid();
-        int getTeamScore(int player);
-
-        std::pair<int, bool> dealBidAndFullFiveTricks();
-
-        // returns the cards the players played
-        std::vector<Card> havePlayersPlayCards(int playerLeading);
-        // have players play their cards and returns the player who won the trick
-        std::pair<Card, int> havePlayersPlayCardsAndEvaluate(int playerLeading);
-
  private:
-        Deck deck;
-        // Array of pointers to an abstract class
-        std::vector<Player*> players;
-        // stores the max bid amounts, so players can use it in their decisions
-        std::vector<int> bidHistory;
-        // only two player scores because there are two teams
-        int teamScores[2];
-        int teamScoresThisHand[2];
-
-        int bidAmount;
-        int bidder;
-
-        Suit::Suit trump;
-        Suit::Suit suitLed;
-
-        int playerDealing;
         bool initalizedPlayersWithNew;
 };
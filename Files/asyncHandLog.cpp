@@ -0,0 +1,184 @@
+// Copyright Andrew Bernal 2023
+#include "asyncHandLog.hpp"
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+AsyncHandLog::Producer::Producer(AsyncHandLog& inpLog) : log(&inpLog), buffer(-1) {
+        if (log->producers.fetch_add(1) >= log->options.maxBuffers - 1) {
+                log->producers--;
+                throw std::invalid_argument("a log with " +
+                        std::to_string(log->options.maxBuffers) + " buffers can only have " +
+                        std::to_string(log->options.maxBuffers - 1) + " producers");
+        }
+}
+
+AsyncHandLog::Producer::~Producer() {
+        flush();
+        log->producers--;
+}
+
+void AsyncHandLog::Producer::append(const HandRecord& record) {
+        if (buffer < 0) {
+                buffer = log->acquire();
+                if (buffer < 0) {
+                        log->dropped++;
+                        return;
+                }
+        }
+        int& count = log->counts[buffer];
+        log->records[static_cast<size_t>(buffer) * log->options.bufferRecords + count] = record;
+        if (++count == log->options.bufferRecords) {
+                log->submit(buffer);
+                buffer = -1;
+        }
+}
+
+void AsyncHandLog::Producer::flush() {
+        if (buffer < 0) {
+                return;
+        }
+        if (log->counts[buffer] > 0) {
+                log->submit(buffer);
+        } else {
+                log->release(buffer);
+        }
+        buffer = -1;
+}
+
+AsyncHandLog::AsyncHandLog(const std::string& inpPath, const Options& inpOptions)
+        : path(inpPath), options(inpOptions), fd(-1), end(0),
+        freeBuffers(std::max(inpOptions.maxBuffers, 2)),
+        fullBuffers(std::max(inpOptions.maxBuffers, 2)) {
+        if (options.bufferRecords < 1 || options.maxBuffers < 2) {
+                throw std::invalid_argument("a log needs at least 2 buffers of at least 1 record");
+        }
+        records.resize(static_cast<size_t>(options.bufferRecords) * options.maxBuffers);
+        counts.resize(options.maxBuffers);
+        for (int b = 0; b < options.maxBuffers; b++) {
+                freeBuffers.tryPush(b);
+        }
+        fd = HandLog::openForAppend(path, end);
+        writer = std::thread([this] { writeLoop(); });
+}
+
+AsyncHandLog::~AsyncHandLog() {
+        {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+        }
+        changed.notify_all();
+        writer.join();
+        close(fd);
+}
+
+void AsyncHandLog::flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this] { return completed == submitted; });
+        if (failed) {
+                throw std::runtime_error("can't write the hand log " + path);
+        }
+}
+
+int AsyncHandLog::acquire() {
+        int buffer;
+        if (freeBuffers.tryPop(buffer)) {
+                return buffer;
+        }
+        if (options.overflow == Overflow::DROP) {
+                return -1;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this, &buffer] { return freeBuffers.tryPop(buffer); });
+        return buffer;
+}
+
+void AsyncHandLog::submit(int buffer) {
+        // there are only maxBuffers buffers, so the queue always has room
+        fullBuffers.tryPush(buffer);
+        {
+                std::lock_guard<std::mutex> lock(mutex);
+                submitted++;
+        }
+        changed.notify_all();
+}
+
+void AsyncHandLog::release(int buffer) {
+        freeBuffers.tryPush(buffer);
+        {
+                // a producer waiting for a buffer checks for one with the mutex held
+                std::lock_guard<std::mutex> lock(mutex);
+        }
+        changed.notify_all();
+}
+
+void AsyncHandLog::writeLoop() {
+        std::vector<int> batch;
+        int64_t taken = 0;
+        while (true) {
+                batch.clear();
+                int buffer;
+                while (static_cast<int>(batch.size()) < kMaxBatch &&
+                        fullBuffers.tryPop(buffer)) {
+                        batch.push_back(buffer);
+                }
+                if (batch.empty()) {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        changed.wait(lock, [this, taken] {
+                                return stopping || submitted != taken;
+                        });
+                        if (stopping && submitted == taken) {
+                                return;
+                        }
+                        continue;
+                }
+                taken += batch.size();
+
+                bool ok = writeBatch(batch);
+                for (int b : batch) {
+                        counts[b] = 0;
+                        freeBuffers.tryPush(b);
+                }
+                {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        completed += batch.size();
+                        failed |= !ok;
+                }
+                changed.notify_all();
+        }
+}
+
+bool AsyncHandLog::writeBatch(const std::vector<int>& batch) {
+        iovec parts[kMaxBatch];
+        int64_t batchRecords = 0;
+        for (size_t i = 0; i < batch.size(); i++) {
+                parts[i].iov_base = &records[static_cast<size_t>(batch[i]) *
+                        options.bufferRecords];
+                parts[i].iov_len = counts[batch[i]] * sizeof(HandRecord);
+                batchRecords += counts[batch[i]];
+        }
+        // pwritev can write less than it was asked to, so go on from where it stopped
+        iovec* next = parts;
+        int left = static_cast<int>(batch.size());
+        while (left > 0) {
+                ssize_t done = pwritev(fd, next, left, end);
+                if (done < 0) {
+                        return false;
+                }
+                end += done;
+                while (left > 0 && static_cast<size_t>(done) >= next->iov_len) {
+                        done -= next->iov_len;
+                        next++;
+                        left--;
+                }
+                if (left > 0) {
+                        next->iov_base = static_cast<char*>(next->iov_base) + done;
+                        next->iov_len -= done;
+                }
+        }
+        written += batchRecords;
+        return true;
+}
@@ -0,0 +1,107 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "boundedQueue.hpp"
+#include "handLog.hpp"
+
+// A hand log written by a background thread, so the engines that log to it never wait on the
+// disk. Every engine thread logs to its own Producer, which fills a buffer of records without
+// any locking. A full buffer goes to the writer thread through a lock free queue, and the writer
+// writes every full buffer it has with one pwritev and hands the buffers back through another.
+// The memory is bounded: there are maxBuffers buffers in all, and when a producer needs one and
+// none are free it either waits for the writer (BLOCK) or drops the record and counts it (DROP).
+// The file is the same as HandLogWriter's, so it is read with HandLogReader. The records of a
+// producer are in the order it appended them, but the producers' buffers are interleaved.
+class AsyncHandLog {
+ public:
+        enum class Overflow { BLOCK, DROP };
+        struct Options {
+                int bufferRecords = 1024;
+                // more than the number of producers, since each one can hold a buffer
+                int maxBuffers = 64;
+                Overflow overflow = Overflow::BLOCK;
+        };
+
+        // The buffer of one engine thread. Only one thread may use it at a time, and it has to
+        // be destroyed before the log. Give it to the engine with setHandLog
+        class Producer : public HandLogSink {
+         public:
+                // throws std::invalid_argument if the log already has maxBuffers - 1 producers
+                explicit Producer(AsyncHandLog& inpLog);
+                // hands off the records that are left
+                ~Producer() override;
+                Producer(const Producer&) = delete;
+                Producer& operator=(const Producer&) = delete;
+
+                void append(const HandRecord& record) override;
+                // hands the records buffered so far to the writer
+                void flush();
+
+         private:
+                AsyncHandLog* log;
+                // the buffer being filled, -1 until the next append takes one
+                int buffer;
+        };
+
+        // opens the log like HandLogWriter and starts the writer thread. Throws
+        // std::invalid_argument if a buffer has no records or there are fewer than 2 buffers, and
+        // std::runtime_error if the file can't be opened
+        explicit AsyncHandLog(const std::string& inpPath) : AsyncHandLog(inpPath, Options()) {}
+        AsyncHandLog(const std::string& inpPath, const Options& inpOptions);
+        // writes every buffer that was handed off and stops the writer
+        ~AsyncHandLog();
+        AsyncHandLog(const AsyncHandLog&) = delete;
+        AsyncHandLog& operator=(const AsyncHandLog&) = delete;
+
+        // waits until every buffer handed off so far is in the file. Throws std::runtime_error if
+        // a write failed. Records still in a producer's buffer aren't written, flush it first
+        void flush();
+        // the records written to the file, and the records DROP threw away
+        int64_t getWritten() const { return written; }
+        int64_t getDropped() const { return dropped; }
+
+ private:
+        // writes at most this many buffers with one pwritev
+        static constexpr int kMaxBatch = 64;
+
+        std::string path;
+        Options options;
+        int fd;
+        // where the next batch goes
+        int64_t end;
+        // buffer b is records[b * bufferRecords] to records[b * bufferRecords + counts[b]]
+        std::vector<HandRecord> records;
+        std::vector<int> counts;
+        BoundedQueue<int> freeBuffers;
+        BoundedQueue<int> fullBuffers;
+
+        // the writer, producers waiting for a buffer and flush wait on changed. Only the slow
+        // paths take the mutex: handing off a buffer, waiting, and the writer finishing a batch
+        std::mutex mutex;
+        std::condition_variable changed;
+        // buffers handed to the writer and buffers it has written, both only changed with mutex
+        int64_t submitted = 0;
+        int64_t completed = 0;
+        bool stopping = false;
+        bool failed = false;
+        std::atomic<int64_t> written{0};
+        std::atomic<int64_t> dropped{0};
+        std::atomic<int> producers{0};
+        std::thread writer;
+
+        // a free buffer. -1 if there isn't one and the overflow is DROP
+        int acquire();
+        // gives a buffer with records to the writer
+        void submit(int buffer);
+        // gives a buffer with no records back
+        void release(int buffer);
+        void writeLoop();
+        // writes the buffers at end. False if the write failed
+        bool writeBatch(const std::vector<int>& batch);
+};
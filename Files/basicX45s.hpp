@@ -0,0 +1,492 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include "deck.hpp"
+#include "card.hpp"
+#include "cardSet.hpp"
+#include "fixedVector.hpp"
+#include "gameState.hpp"
+#include "handLog.hpp"
+#include "span.hpp"
+#include "suit.hpp"
+#include "trick.hpp"
+#include "trickState.hpp"
+
+// The 45s engine, with the four players held by value.
+// A player type needs the same members as Player: dealCard, getSize, getHandSet, resetHand,
+// discard, getBid, bagged, setLegalPlays, playCard, seated, bidWon and trickPlayed. Because the
+// engine knows the exact type of every player, their calls can be inlined into the game loop. If
+// a player derives from Player, mark it final.
+// x45s is this engine with four PlayerRefs, which call a Player through its virtual functions.
+// The rules state lives in a GameState, and the engine moves it forward with the functions in
+// gameState.hpp. The engine only adds the deck, the players and the bid history.
+template <class P0, class P1, class P2, class P3>
+class basic_x45s {
+ public:
+        // the players must be default constructible to use this
+        basic_x45s() : basic_x45s(P0(), P1(), P2(), P3()) {}
+        basic_x45s(P0 p0, P1 p1, P2 p2, P3 p3)
+                : players(std::move(p0), std::move(p1), std::move(p2), std::move(p3)) {
+                for (int i = 0; i < 4; i++) {
+                        withPlayer(i, [i](auto& p) { p.seated(i); });
+                }
+        }
+
+        void deal_players();
+        // shuffles the deck once
+        void shuffle();
+        // seeds the deck's generator, so the game deals the same hands every time
+        void seed(uint64_t seed) { deck.seed(seed); }
+        // puts the cards on top of the deck, so they are dealt first and in order. Call it after
+        // reset, instead of shuffle, to deal a hand again (see HandRecord::dealOrder)
+        void stackDeck(Span<const Card> top) { deck.stack(top); }
+        void reset();
+        // deal the kiddie to the player who won the bid. (0-3)
+        void deal_kiddie(int winner);
+        // evaluate the trick thrown by all four players. Returns the winning card
+        // precondition: suitLed and trump have been set. Ties go to the earlier card
+        Card evaluate_trick(
+                const Card& card1, const Card& card2, const Card& card3, const Card& card4);
+        Card evaluate_trick(Span<const Card> c);
+        // cardsPlayed is indexed by player. Returns the winning card and the player who played it
+        std::pair<Card, int> evaluate_trick(
+                Span<const Card> cardsPlayed, int playerLeading);
+
+        // Increments the team's score by 5 (team is either 0 or 1)
+        void updateScores(int team);
+        // Increments the team's score for this hand by 5, for a trick or the high card
+        void updateScoresThisHand(int team);
+
+        bool hasWon();
+        // Returns the number of the player that has won the game (from 0 to 3).
+        // Returns -1 if no one has won
+        int whichTeamWon();
+        // calls the player discard method for each player
+        void havePlayersDiscard();
+        // getters
+        int getBidAmount() { return state.bidAmount; }
+        int getBidder() { return state.bidder; }
+
+        // Has each player bid & returns the player who won the bid (0, 1, 2, 3)
+        void biddingPhase();
+        // returns the trump
+        Suit::Suit getTrump() { return state.play.trump; }
+
+        int getHandSize(int playerNum) {
+                return withPlayer(playerNum, [](auto& p) { return p.getSize(); });
+        }
+        int getNumPlayers() {
+                return 4;
+        }
+        // the player at seat I (0-3)
+        template <int I>
+        auto& getPlayer() {
+                return std::get<I>(players);
+        }
+        template <int I>
+        const auto& getPlayer() const {
+                return std::get<I>(players);
+        }
+        // calls f with the player at the seat. f is instantiated for all four player types
+        template <class F>
+        decltype(auto) withPlayer(int seat, F&& f) {
+                switch (seat) {
+                        case 0: return f(std::get<0>(players));
+                        case 1: return f(std::get<1>(players));
+                        case 2: return f(std::get<2>(players));
+                        default: return f(std::get<3>(players));
+                }
+        }
+        // the cards played in the tricks of this hand so far
+        CardSet getCardsPlayedThisHand() { return state.played; }
+        // the rules state of the game. Copy it to look ahead without touching the game
+        const GameState& getState() const { return state; }
+        // the trick being played, or the last one played
+        const TrickState& getTrickState() const { return trick; }
+        // dealBidAndFullFiveTricks appends the record of every hand to log, until it is set to
+        // nullptr. The engine doesn't own it
+        void setHandLog(HandLogSink* log) { handLog = log; }
+        // the record of the hand being played, or the last one played
+        const HandRecord& getHandRecord() const { return record; }
+
+        bool deductAfterBid();
+        int getTeamScore(int player);
+
+        std::pair<int, bool> dealBidAndFullFiveTricks();
+        // resets, shuffles and plays hands until a team has won. Returns the number of hands
+        int playGame();
+        // sets both scores to 0 and makes player 0 the dealer, so the engine can play another game
+        void newGame();
+
+        // returns the cards the players played, indexed by player. Every player is told their
+        // legal cards first, and a player who plays anything else makes it throw
+        // std::invalid_argument
+        std::array<Card, 4> havePlayersPlayCards(int playerLeading);
+        // have players play their cards and returns the player who won the trick
+        std::pair<Card, int> havePlayersPlayCardsAndEvaluate(int playerLeading);
+
+ private:
+        Deck deck;
+        std::tuple<P0, P1, P2, P3> players;
+        // stores the max bid amounts, so players can use it in their decisions
+        // at most one bid per player, so it is stored inline
+        FixedVector<int, 4> bidHistory;
+        // the scores, the bid, the trump, the hands and the trick in progress
+        GameState state;
+        // what the players see of the trick in progress, updated as each card is played
+        TrickState trick;
+        // the hand so far, for the hand log. It is filled in whether or not there is a log, since
+        // that costs a few stores
+        HandRecord record = {};
+        int recordDealt = 0;
+        // set until the first hand of a game has been played
+        bool startsGame = true;
+        HandLogSink* handLog = nullptr;
+
+        // throws std::invalid_argument unless the bid is an amount a player can bid, and a bid
+        // that isn't a pass is in a real suit
+        static void checkBid(int seat, const std::pair<int, Suit::Suit>& bid) {
+                if (!isBidAmount(bid.first)) {
+                        throw std::invalid_argument("player " + std::to_string(seat) + " bid " +
+                                std::to_string(bid.first) + ", bids are 0, 15, 20, 25 or 30");
+                }
+                if (bid.first != 0 && (bid.second < Suit::HEARTS || bid.second > Suit::SPADES)) {
+                        throw std::invalid_argument("player " + std::to_string(seat) +
+                                " bid in a suit that doesn't exist");
+                }
+        }
+        // deals the top card of the deck to the player
+        template <class P>
+        void dealTo(int seat, P& p) {
+                Card c = deck.pop_back();
+                p.dealCard(c);
+                state.play.hands[seat].insert(c);
+                if (recordDealt < HandRecord::kDealt) {
+                        record.dealt[recordDealt++] = static_cast<uint8_t>(c.getIndex());
+                }
+        }
+};
+
+// shuffles the deck. One Fisher-Yates pass is uniform, so once is enough
+template <class P0, class P1, class P2, class P3>
+void basic_x45s<P0, P1, P2, P3>::shuffle() {
+        deck.shuffle();
+}
+
+// deals players until each has 5 cards
+template <class P0, class P1, class P2, class P3>
+void basic_x45s<P0, P1, P2, P3>::deal_players() {
+        // make sure each player is dealt until their hand is 5 cards
+        for (int i = 0; i < 4; i++) {
+                withPlayer(i, [this, i](auto& p) {
+                        while (p.getSize() < 5) {
+                                dealTo(i, p);
+                        }
+                });
+        }
+}
+
+// deals the kiddie (3 cards) to the player who won the bid.
+// Need to input the number of the player who won the bid
+template <class P0, class P1, class P2, class P3>
+void basic_x45s<P0, P1, P2, P3>::deal_kiddie(int winner) {
+        if (winner < 0 || winner > 3) {
+                throw std::invalid_argument("Invalid winnder of bid. Player should 0, 1, 2, or 3");
+        }
+        // winner gets 3 cards from the deck
+        withPlayer(winner, [this, winner](auto& p) {
+                for (int i = 0; i < 3; i++) {
+                        dealTo(winner, p);
+                }
+        });
+}
+
+// evaluates the cards thrown by all four players. Returns the winning card
+// precondition: suit led and trump have been previously set
+template <class P0, class P1, class P2, class P3>
+Card basic_x45s<P0, P1, P2, P3>::evaluate_trick(
+        const Card& card1, const Card& card2, const Card& card3, const Card& card4) {
+        Card c[4] = {card1, card2, card3, card4};
+        return c[trickWinner(c, state.suitLed, state.play.trump)];
+}
+
+// evaluates the cards thrown by all four players. Returns the winning card
+template <class P0, class P1, class P2, class P3>
+Card basic_x45s<P0, P1, P2, P3>::evaluate_trick(Span<const Card> c) {
+        if (c.size() != 4) {
+                throw std::invalid_argument("evaluate_trick needs 4 cards, got " +
+                std::to_string(c.size()));
+        }
+        return c[trickWinner(c.data(), state.suitLed, state.play.trump)];
+}
+
+// evaluates a trick stored by player number. The cards are compared in the order they were
+// played, so the player leading wins a tie
+template <class P0, class P1, class P2, class P3>
+std::pair<Card, int> basic_x45s<P0, P1, P2, P3>::evaluate_trick(
+        Span<const Card> cardsPlayed, int playerLeading) {
+        Card inPlayOrder[4];
+        for (int i = 0; i < 4; i++) {
+                inPlayOrder[i] = cardsPlayed[(playerLeading + i) % 4];
+        }
+        int position = trickWinner(inPlayOrder, state.suitLed, state.play.trump);
+        int winner = (playerLeading + position) % 4;
+        return {cardsPlayed[winner], winner};
+}
+
+// Increments the team's score by 5 (team is either 0 or 1)
+template <class P0, class P1, class P2, class P3>
+void basic_x45s<P0, P1, P2, P3>::updateScores(int team) {
+        if (team != 0 && team != 1) {
+                throw std::invalid_argument("Invalid player " + std::to_string(team) +
+                " in updateScores. Must be 0 or 1");
+        }
+        state.teamScores[team] += 5;
+}
+
+// Increments the team's score for this hand by 5 (team is either 0 or 1)
+template <class P0, class P1, class P2, class P3>
+void basic_x45s<P0, P1, P2, P3>::updateScoresThisHand(int team) {
+        if (team != 0 && team != 1) {
+                throw std::invalid_argument("Invalid player " + std::to_string(team) +
+                " in updateScoresThisHand. Must be 0 or 1");
+        }
+        state.handScores[team] += 5;
+}
+
+// returns the score of the team input (team 0 or 1)
+template <class P0, class P1, class P2, class P3>
+int basic_x45s<P0, P1, P2, P3>::getTeamScore(int team) {
+        if (team != 0 && team != 1) {
+                throw std::invalid_argument("Invalid player " +
+                std::to_string(team) + " in updateScores. Must be 0 or 1");
+        }
+        return state.teamScores[team];
+}
+
+// returns true if either team has won
+template <class P0, class P1, class P2, class P3>
+bool basic_x45s<P0, P1, P2, P3>::hasWon() {
+        // if either team has 120 points or greater, then they have won
+        return winningTeam(state) != -1;
+}
+
+// Returns the number of the team that won the game (0 or 1).
+// Returns -1 if no one has won
+template <class P0, class P1, class P2, class P3>
+int basic_x45s<P0, P1, P2, P3>::whichTeamWon() {
+        return winningTeam(state);
+}
+
+// calls each player's discard method
+template <class P0, class P1, class P2, class P3>
+void basic_x45s<P0, P1, P2, P3>::havePlayersDiscard() {
+        for (int i = 0; i < 4; i++) {
+                withPlayer(i, [this, i](auto& p) {
+                        p.discard();
+                        state.play.hands[i] = p.getHandSet();
+                });
+        }
+        // flag the dealt cards that were kept, the kiddie is held by the bidder
+        for (int i = 0; i < recordDealt; i++) {
+                int holder = i < 20 ? i / 5 : state.bidder;
+                if (state.play.hands[holder].contains(record.dealtCard(i))) {
+                        record.dealt[i] |= HandRecord::kKept;
+                }
+        }
+}
+
+// returns the player who bid and if they won the bid or not
+template <class P0, class P1, class P2, class P3>
+std::pair<int, bool> basic_x45s<P0, P1, P2, P3>::dealBidAndFullFiveTricks() {
+        // initial deal
+        recordDealt = 0;
+        deal_players();
+
+        // have players bid
+        biddingPhase();
+
+        // deal the kiddie to the player who won the bid
+        deal_kiddie(state.bidder);
+
+        // let the players discard. Then deal them more cards
+        havePlayersDiscard();
+        deal_players();
+
+        // the bidder leads the first trick, then the winner of each trick leads the next.
+        // The tricks and the high card are scored as the cards are played
+        state.play.leader = state.bidder;
+        for (int i = 0; i < kTricksPerHand; i++) {
+                havePlayersPlayCardsAndEvaluate(state.play.leader);
+        }
+
+        bool made = deductAfterBid();
+        if (handLog != nullptr) {
+                handLog->append(record);
+        }
+        startsGame = false;
+        return {state.bidder, made};
+}
+
+template <class P0, class P1, class P2, class P3>
+int basic_x45s<P0, P1, P2, P3>::playGame() {
+        int hands = 0;
+        while (!hasWon()) {
+                reset();
+                shuffle();
+                dealBidAndFullFiveTricks();
+                hands++;
+        }
+        return hands;
+}
+
+template <class P0, class P1, class P2, class P3>
+void basic_x45s<P0, P1, P2, P3>::newGame() {
+        reset();
+        state.teamScores[0] = 0;
+        state.teamScores[1] = 0;
+        state.dealer = 0;
+        startsGame = true;
+}
+
+// gets the bids for each player and increments the dealer. A bid that isn't 0, 15, 20, 25 or 30,
+// or isn't in a real suit, makes it throw std::invalid_argument
+template <class P0, class P1, class P2, class P3>
+void basic_x45s<P0, P1, P2, P3>::biddingPhase() {
+        // start the hand with a fresh bid history
+        bidHistory.clear();
+
+        // bid is <value, suit>
+        std::pair<int, Suit::Suit> currentBid;
+        // initalize maxBid to something small, so it is replaced immediately
+        std::pair<int, Suit::Suit> maxBid = {INT32_MIN, Suit::INVALID};
+        int playerWinningBid = -1;
+        auto getBid = [this](auto& p) { return p.getBid(Span<const int>(bidHistory)); };
+
+        // the dealing player bids last, and can possiblly be bagged
+        int playerDealing = state.dealer;
+        for (int i = playerDealing + 1; i < playerDealing + 4; i++) {
+                // get the player's bid. Pass them the bidHistory
+                currentBid = withPlayer(i % 4, getBid);
+                checkBid(i % 4, currentBid);
+                // save the bid history
+                bidHistory.push_back(currentBid.first);
+                record.bids[i - playerDealing - 1] = static_cast<int8_t>(currentBid.first);
+                if (currentBid.first > maxBid.first) {
+                        // save the bid value, suit
+                        maxBid = currentBid;
+                        // save the player # who bid the most
+                        playerWinningBid = i % 4;
+                }
+        }
+
+        // dealer's bid. Either bagged or normal
+        if (maxBid.first <= 0) {
+                // dealer is bagged
+                // player bids 15, gets to pick the suit
+                currentBid = {15, withPlayer(playerDealing, [](auto& p) { return p.bagged(); })};
+                checkBid(playerDealing, currentBid);
+                maxBid = currentBid;
+                playerWinningBid = playerDealing;
+                record.bids[3] = 15;
+        // otherwise the dealer bids like normal
+        } else {
+                currentBid = withPlayer(playerDealing, getBid);
+                checkBid(playerDealing, currentBid);
+                record.bids[3] = static_cast<int8_t>(currentBid.first);
+                // .first is the value
+                if (currentBid.first != 0) {
+                        bidHistory.push_back(currentBid.first);
+                        if (currentBid.first > maxBid.first) {
+                                maxBid = currentBid;
+                                playerWinningBid = playerDealing;
+                        }
+                }
+        }
+
+        state.bidAmount = static_cast<int8_t>(maxBid.first);
+        state.play.trump = maxBid.second;
+
+        // increment the player dealing mod 4
+        state.dealer = static_cast<int8_t>((playerDealing + 1) % 4);
+
+        state.bidder = static_cast<int8_t>(playerWinningBid);
+        record.setInfo(playerDealing, playerWinningBid, maxBid.second, startsGame);
+
+        for (int i = 0; i < 4; i++) {
+                withPlayer(i, [this](auto& p) {
+                        p.bidWon(state.bidder, state.bidAmount, state.play.trump);
+                });
+        }
+}
+
+template <class P0, class P1, class P2, class P3>
+bool basic_x45s<P0, P1, P2, P3>::deductAfterBid() {
+        bool wonBid = madeBid(state);
+        // opposing team always gets their score added, and the bidder's team loses their bid
+        // if they did not make it
+        state = scoreHand(state);
+        return wonBid;
+}
+
+template <class P0, class P1, class P2, class P3>
+void basic_x45s<P0, P1, P2, P3>::reset() {
+        for (int i = 0; i < 4; i++) {
+                withPlayer(i, [](auto& p) { p.resetHand(); });
+        }
+        deck.reset();
+        state = startHand(state);
+}
+
+// returns the cards played by each player
+template <class P0, class P1, class P2, class P3>
+std::array<Card, 4> basic_x45s<P0, P1, P2, P3>::havePlayersPlayCards(int playerLeading) {
+        trick = TrickState(state.play.trump, playerLeading % 4, state.tricksPlayed, state.played);
+        CardSet legal;
+        auto playCard = [this, &legal](auto& p) {
+                p.setLegalPlays(legal);
+                return p.playCard(trick);
+        };
+
+        // the cards go through the game state, which sets the suit led and scores the trick
+        state.play.leader = static_cast<int8_t>(playerLeading % 4);
+        while (!trick.complete()) {
+                int seat = trick.toPlay();
+                // the engine's copy of the hands decides, not what the player says it holds
+                legal = legalMoves(state);
+                Card c = withPlayer(seat, playCard);
+                if (!c.isValid() || !legal.contains(c)) {
+                        throw std::invalid_argument("player " + std::to_string(seat) +
+                                " played a card they can't play");
+                }
+                if (trick.trickNumber < kTricksPerHand) {
+                        record.plays[4 * trick.trickNumber + trick.size] =
+                                static_cast<uint8_t>(c.getIndex());
+                }
+                trick.play(c);
+                state = applyMove(state, c);
+        }
+        // the winner of the trick is leading the next one
+        for (int i = 0; i < 4; i++) {
+                withPlayer(i, [this, playerLeading](auto& p) {
+                        p.trickPlayed(Span<const Card>(trick.cards), playerLeading % 4,
+                                state.play.leader);
+                });
+        }
+        return trick.cards;
+}
+
+// have players play their cards, returns the Card & Player who won the trick
+template <class P0, class P1, class P2, class P3>
+std::pair<Card, int> basic_x45s<P0, P1, P2, P3>::havePlayersPlayCardsAndEvaluate(
+        int playerLeading) {
+        havePlayersPlayCards(playerLeading);
+        // the trick state already knows the winner
+        return {trick.winningCard, trick.winner};
+}
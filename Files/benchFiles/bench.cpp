@@ -0,0 +1,575 @@
+// Copyright Andrew Bernal 2023
+// Benchmarks for the hot paths of the engine. Prints the results as JSON, so runs from
+// different releases can be compared. Every random input comes from a fixed seed.
+//
+// usage: benchmarks [--min-time=seconds] [--filter=part of a name] [output.json]
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../45s.hpp"
+#include "../asyncHandLog.hpp"
+#include "../basicX45s.hpp"
+#include "../card.hpp"
+#include "../dealGenerator.hpp"
+#include "../deck.hpp"
+#include "../gameBatch.hpp"
+#include "../handArchive.hpp"
+#include "../handLog.hpp"
+#include "../handReplay.hpp"
+#include "../handTracker.hpp"
+#include "../player.hpp"
+#include "../parallel.hpp"
+#include "../parallelSolver.hpp"
+#include "../random.hpp"
+#include "../ranking.hpp"
+#include "../rules.hpp"
+#include "../solver.hpp"
+#include "../suit.hpp"
+#include "../trickKernels.hpp"
+#include "benchmark.hpp"
+
+namespace {
+constexpr uint64_t kSeed = 45;
+
+// discards down to 5 cards and plays the last legal card of its hand
+class referencePlayer : public Player {
+public:
+        void discard() override {
+                while (hand.size() > 5) {
+                        hand.erase(hand.begin());
+                }
+        }
+        Card playCard([[maybe_unused]] const TrickState& trick) override {
+                return playLastLegalCard();
+        }
+};
+
+// never bids, so the dealer is always bagged
+class nonBidder final : public referencePlayer {
+public:
+        std::pair<int, Suit::Suit> getBid([[maybe_unused]] Span<const int> bidHistory) override {
+                return {0, Suit::SPADES};
+        }
+        Suit::Suit bagged() override {
+                return Suit::SPADES;
+        }
+};
+
+// always bids 30 in clubs
+class bigBidder final : public referencePlayer {
+public:
+        std::pair<int, Suit::Suit> getBid([[maybe_unused]] Span<const int> bidHistory) override {
+                return {30, Suit::CLUBS};
+        }
+        Suit::Suit bagged() override {
+                return Suit::CLUBS;
+        }
+};
+
+using templatedGame = basic_x45s<bigBidder, nonBidder, nonBidder, nonBidder>;
+
+x45s makeRuntimeGame() {
+        return x45s([]{return new bigBidder;}, []{return new nonBidder;},
+                []{return new nonBidder;}, []{return new nonBidder;});
+}
+
+const char* suitName(int suit) {
+        static const char* names[] = {"", "hearts", "diamonds", "clubs", "spades"};
+        return names[suit];
+}
+
+// 4096 random pairs of cards, the same on every run
+std::vector<std::pair<Card, Card>> randomPairs() {
+        Xoshiro256StarStar rng(kSeed);
+        std::vector<std::pair<Card, Card>> pairs(4096);
+        for (auto& p : pairs) {
+                p = {Card::fromIndex(boundedRandom(rng, Card::kNumCards)),
+                        Card::fromIndex(boundedRandom(rng, Card::kNumCards))};
+        }
+        return pairs;
+}
+
+void benchLessThan(BenchmarkRunner& runner) {
+        std::vector<std::pair<Card, Card>> pairs = randomPairs();
+        for (int trump = Suit::HEARTS; trump <= Suit::SPADES; trump++) {
+                for (int led = Suit::HEARTS; led <= Suit::SPADES; led++) {
+                        Suit::Suit t = static_cast<Suit::Suit>(trump);
+                        Suit::Suit l = static_cast<Suit::Suit>(led);
+                        size_t i = 0;
+                        runner.run(std::string("lessThan/trump=") + suitName(trump) + "/led=" +
+                                suitName(led), [&] {
+                                const auto& p = pairs[i++ & 4095];
+                                doNotOptimize(lessThan(p.first, p.second, l, t));
+                        });
+                }
+        }
+}
+
+// the legal cards of random hands, with a random led card and trump
+void benchLegalPlays(BenchmarkRunner& runner) {
+        Xoshiro256StarStar rng(kSeed);
+        struct Decision {
+                CardSet hand;
+                Card led;
+                Suit::Suit trump;
+        };
+        std::vector<Decision> decisions(4096);
+        for (Decision& d : decisions) {
+                CardSet deck = CardSet::all();
+                d.led = Card::fromIndex(__builtin_ctzll(takeRandom(deck, 1, rng).getMask()));
+                d.hand = takeRandom(deck, 5, rng);
+                d.trump = static_cast<Suit::Suit>(Suit::HEARTS + boundedRandom(rng, 4));
+        }
+        size_t i = 0;
+        runner.run("Rules::legalPlays", [&] {
+                const Decision& d = decisions[i++ & 4095];
+                doNotOptimize(Rules::legalPlays(d.hand, d.led, d.trump));
+        });
+}
+
+// random tricks of 4 different cards
+std::vector<std::array<Card, 4>> randomTricks() {
+        Deck deck(kSeed);
+        std::vector<std::array<Card, 4>> tricks(1024);
+        for (auto& trick : tricks) {
+                deck.reset();
+                deck.shuffle();
+                for (Card& c : trick) {
+                        c = deck.pop_back();
+                }
+        }
+        return tricks;
+}
+
+void benchEvaluateTrick(BenchmarkRunner& runner) {
+        // play one hand so the engine has a trump and a suit led
+        templatedGame game;
+        game.seed(kSeed);
+        game.shuffle();
+        game.dealBidAndFullFiveTricks();
+
+        std::vector<std::array<Card, 4>> tricks = randomTricks();
+        size_t i = 0;
+        runner.run("evaluate_trick(cards)", [&] {
+                doNotOptimize(game.evaluate_trick(Span<const Card>(tricks[i++ & 1023])));
+        });
+        i = 0;
+        runner.run("evaluate_trick(cardsPlayed, playerLeading)", [&] {
+                doNotOptimize(game.evaluate_trick(Span<const Card>(tricks[i & 1023]), i & 3));
+                i++;
+        });
+}
+
+void benchDeck(BenchmarkRunner& runner) {
+        Deck deck(kSeed);
+        runner.run("Deck::shuffle", [&] {
+                deck.shuffle();
+                doNotOptimize(deck.peek_back());
+        });
+
+        // remove the cards in a shuffled order, so removeCard has to search
+        deck.reset();
+        deck.shuffle();
+        std::vector<Card> order = deck.getPack();
+        runner.run("Deck::removeCard (reset + 52 removes)", [&] {
+                deck.reset();
+                for (const Card& c : order) {
+                        deck.removeCard(c);
+                }
+                doNotOptimize(deck.getSize());
+        });
+}
+
+// ops_per_second is batches of 1024 deals per second. The baseline deals the way x45s does
+void benchDeals(BenchmarkRunner& runner) {
+        const int kCount = 1024;
+        Deck deck(kSeed);
+        std::vector<CardSet> hands(4 * kCount);
+        runner.run("Deck::reset + shuffle + 20 pop_back (1024 deals)", [&] {
+                for (int k = 0; k < kCount; k++) {
+                        deck.reset();
+                        deck.shuffle();
+                        for (int i = 0; i < DealGenerator::kDealt; i++) {
+                                hands[4 * k + i / DealGenerator::kHandSize].insert(deck.pop_back());
+                        }
+                }
+                doNotOptimize(hands[0]);
+        });
+
+        DealGenerator generator(kSeed);
+        std::vector<uint64_t> masks[4];
+        for (auto& mask : masks) {
+                mask.resize(kCount);
+        }
+        uint64_t* const columns[4] = {masks[0].data(), masks[1].data(), masks[2].data(),
+                masks[3].data()};
+        std::vector<uint64_t> decks(kCount);
+        runner.run("DealGenerator::deal (1024 deals, masks)", [&] {
+                generator.deal(kCount, columns, decks.data());
+                doNotOptimize(decks[0]);
+        }, "Deck::reset + shuffle + 20 pop_back (1024 deals)");
+        std::vector<uint8_t> cards(kCount * Card::kNumCards);
+        runner.run("DealGenerator::deal (1024 deals, bytes)", [&] {
+                generator.deal(kCount, cards.data());
+                doNotOptimize(cards[0]);
+        }, "Deck::reset + shuffle + 20 pop_back (1024 deals)");
+}
+
+void benchRanking(BenchmarkRunner& runner) {
+        uint64_t index = 0;
+        runner.run("Ranking::unrank + rank (5 cards)", [&] {
+                index = (index + 7919) % Ranking::kNumHands;
+                doNotOptimize(Ranking::rank(Ranking::unrank(index, 5)));
+        });
+        uint64_t kiddieIndex = 0;
+        runner.run("Ranking::unrank + rank (8 cards)", [&] {
+                kiddieIndex = (kiddieIndex + 104729) % Ranking::kNumKiddieHands;
+                doNotOptimize(Ranking::rank(Ranking::unrank(kiddieIndex, 8)));
+        });
+        Ranking::DealRank deal = 0;
+        runner.run("Ranking::unrankDeal + rankDeal", [&] {
+                deal = (deal + 0x9e3779b97f4a7c15ULL) % Ranking::kNumDeals;
+                doNotOptimize(static_cast<uint64_t>(Ranking::rankDeal(Ranking::unrankDeal(deal))));
+        });
+        CardSet hand = Ranking::unrank(0, 5);
+        runner.run("Ranking::nextCombination", [&] {
+                hand = Ranking::nextCombination(hand);
+                if (hand.getMask() >> Card::kNumCards) {
+                        hand = Ranking::unrank(0, 5);
+                }
+                doNotOptimize(hand.getMask());
+        });
+}
+
+// bids on a new deal every time. The runner can't leave the deal out of the time, so the deal
+// alone is timed first, and the bidding takes the difference between the two
+void benchBidding(BenchmarkRunner& runner) {
+        x45s game = makeRuntimeGame();
+        game.seed(kSeed);
+        runner.run("x45s::reset + shuffle + deal_players", [&] {
+                game.reset();
+                game.shuffle();
+                game.deal_players();
+                doNotOptimize(game.getBidder());
+        });
+        game.seed(kSeed);
+        runner.run("x45s::reset + shuffle + deal_players + biddingPhase", [&] {
+                game.reset();
+                game.shuffle();
+                game.deal_players();
+                game.biddingPhase();
+                doNotOptimize(game.getBidder());
+        });
+}
+
+// solves a new deal every time (the time includes shuffling and dealing it).
+// The table is kept between deals, like a batch analysis
+void benchSolver(BenchmarkRunner& runner) {
+        Deck deck(kSeed);
+        DoubleDummySolver solver;
+        int deals = 0;
+        runner.run("DoubleDummySolver::solve (5 card hands)", [&] {
+                deck.reset();
+                deck.shuffle();
+                std::array<CardSet, 4> hands;
+                for (CardSet& hand : hands) {
+                        for (int i = 0; i < 5; i++) {
+                                hand.insert(deck.pop_back());
+                        }
+                }
+                deals++;
+                doNotOptimize(solver.solve(hands, static_cast<Suit::Suit>(1 + deals % 4),
+                        deals % 4));
+        });
+}
+
+// deals the next hand of the corpus: 5 cards each, and the kiddie to extra if it is 0-3.
+// Every benchmark starts the corpus from the same seed, so they all solve the same deals
+std::array<CardSet, 4> nextDeal(Deck& deck, int extra = -1) {
+        deck.reset();
+        deck.shuffle();
+        std::array<CardSet, 4> hands;
+        for (int player = 0; player < 4; player++) {
+                for (int i = 0; i < (player == extra ? 8 : 5); i++) {
+                        hands[player].insert(deck.pop_back());
+                }
+        }
+        return hands;
+}
+
+// the speedup of the parallel searches over one thread, up to the number of cores (at least 8)
+void benchParallelSolver(BenchmarkRunner& runner) {
+        int maxThreads = std::max(8, resolveThreadCount(0));
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+                std::string suffix = "/threads=" + std::to_string(threads);
+                ParallelSolver solver(threads, 20);
+                Deck deck(kSeed);
+                int deals = 0;
+                runner.run("ParallelSolver::solve" + suffix, [&] {
+                        deals++;
+                        doNotOptimize(solver.solve(nextDeal(deck),
+                                static_cast<Suit::Suit>(1 + deals % 4), deals % 4));
+                }, "ParallelSolver::solve/threads=1");
+
+                deck.seed(kSeed);
+                deals = 0;
+                runner.run("ParallelSolver::analyzeDiscards" + suffix, [&] {
+                        deals++;
+                        int bidder = deals % 4;
+                        doNotOptimize(solver.analyzeDiscards(nextDeal(deck, bidder), bidder,
+                                static_cast<Suit::Suit>(1 + deals % 4)));
+                }, "ParallelSolver::analyzeDiscards/threads=1");
+        }
+}
+// every version of the trick kernels the CPU has, on the same 4096 random tricks, compared with
+// the scalar version. ops_per_second is batches of 4096 tricks (or hands) per second
+void benchTrickKernels(BenchmarkRunner& runner) {
+        const int kCount = 4096;
+        Xoshiro256StarStar rng(kSeed);
+        std::vector<uint8_t> cards[4];
+        std::vector<uint8_t> trumps(kCount);
+        std::vector<uint64_t> hands(kCount);
+        for (int g = 0; g < kCount; g++) {
+                CardSet deck = CardSet::all();
+                for (int i = 0; i < 4; i++) {
+                        uint64_t card = takeRandom(deck, 1, rng).getMask();
+                        cards[i].push_back(static_cast<uint8_t>(__builtin_ctzll(card)));
+                }
+                trumps[g] = static_cast<uint8_t>(Suit::HEARTS + boundedRandom(rng, 4));
+                hands[g] = takeRandom(deck, 5, rng).getMask();
+        }
+        const uint8_t* const columns[4] = {cards[0].data(), cards[1].data(), cards[2].data(),
+                cards[3].data()};
+        std::vector<uint8_t> winners(kCount);
+        std::vector<uint64_t> legal(kCount);
+
+        TrickKernels::Isa best = TrickKernels::bestIsa();
+        for (int i = 0; i <= static_cast<int>(best); i++) {
+                TrickKernels::Isa isa = static_cast<TrickKernels::Isa>(i);
+                TrickKernels::setIsa(isa);
+                std::string suffix = std::string(" (4096, ") + TrickKernels::isaName(isa) + ")";
+                runner.run("TrickKernels::trickWinners" + suffix, [&] {
+                        TrickKernels::trickWinners(columns, trumps.data(), kCount, winners.data());
+                        doNotOptimize(winners[0]);
+                }, i == 0 ? "" : "TrickKernels::trickWinners (4096, scalar)");
+                // legalPlays has no SSE4.2 version, so that would time the scalar one again
+                if (isa == TrickKernels::Isa::SSE42) {
+                        continue;
+                }
+                runner.run("TrickKernels::legalPlays" + suffix, [&] {
+                        TrickKernels::legalPlays(hands.data(), cards[0].data(), trumps.data(),
+                                kCount, legal.data());
+                        doNotOptimize(legal[0]);
+                }, i == 0 ? "" : "TrickKernels::legalPlays (4096, scalar)");
+        }
+        TrickKernels::setIsa(best);
+}
+
+
+// the batch version of the reference players: bids 30 in clubs from seat 0 and passes from the
+// others, keeps its trumps and plays its highest legal card
+class referenceBatchPolicy final : public BatchPolicy {
+public:
+        void bid(const GameBatch& batch, Span<int8_t> amounts, Span<uint8_t> trumps) override {
+                Span<const uint8_t> seats = batch.getSeats();
+                for (std::size_t g = 0; g < amounts.size(); g++) {
+                        amounts[g] = seats[g] == 0 ? 30 : 0;
+                        trumps[g] = Suit::CLUBS;
+                }
+        }
+        void discard(const GameBatch& batch, Span<uint64_t> keep) override {
+                Span<const uint64_t> choices = batch.getChoices();
+                uint64_t clubs = CardSet::trumpMask(Suit::CLUBS).getMask();
+                for (std::size_t g = 0; g < keep.size(); g++) {
+                        keep[g] = choices[g] & clubs;
+                        while (__builtin_popcountll(keep[g]) > 5) {
+                                keep[g] &= keep[g] - 1;
+                        }
+                }
+        }
+        void play(const GameBatch& batch, Span<uint8_t> cards) override {
+                Span<const uint64_t> choices = batch.getChoices();
+                for (std::size_t g = 0; g < cards.size(); g++) {
+                        cards[g] = static_cast<uint8_t>(63 - __builtin_clzll(choices[g] | 1));
+                }
+        }
+};
+
+// ops_per_second is batches of 1024 games per second
+void benchGameBatch(BenchmarkRunner& runner) {
+        GameBatch batch(1024, kSeed);
+        referenceBatchPolicy policy;
+        uint64_t batches = 0;
+        runner.run("GameBatch::playGames (1024 games to 120)", [&] {
+                batch.newGames(kSeed + batches++);
+                doNotOptimize(batch.playGames(policy));
+        });
+}
+
+// plays hand after hand, starting a new game whenever one is won
+template <class Game>
+void benchHands(BenchmarkRunner& runner, const std::string& name, Game& game) {
+        game.seed(kSeed);
+        runner.run(name, [&] {
+                if (game.hasWon()) {
+                        game.newGame();
+                }
+                game.reset();
+                game.shuffle();
+                doNotOptimize(game.dealBidAndFullFiveTricks());
+        });
+}
+
+// keeps the last 1024 records, so logging costs what a sink in memory costs
+class ringSink : public HandLogSink {
+ public:
+        std::array<HandRecord, 1024> records;
+        size_t count = 0;
+        void append(const HandRecord& record) override { records[count++ & 1023] = record; }
+};
+
+// the records over and over in an archive of 64 blocks, queried on one thread
+void benchHandArchive(BenchmarkRunner& runner, const std::vector<HandRecord>& records) {
+        const std::string prefix = "benchHandArchive";
+        std::vector<HandRecord> tiled;
+        while (tiled.size() < 64 * HandArchive::kBlockRows) {
+                tiled.insert(tiled.end(), records.begin(), records.end());
+        }
+        HandArchive::write(prefix, Span<const HandRecord>(tiled), 0);
+        {
+                HandArchive archive(prefix);
+                // clubs bid by a bidder holding the 5 and jack of clubs
+                HandQuery query;
+                query.minBid = 20;
+                query.trumps = 1 << (Suit::CLUBS - 1);
+                query.bidderHolds.insert(Card(5, Suit::CLUBS));
+                query.bidderHolds.insert(Card(11, Suit::CLUBS));
+                // the archive only has a scalar and an AVX2 version
+                TrickKernels::Isa best = TrickKernels::bestIsa();
+                TrickKernels::setIsa(TrickKernels::Isa::SCALAR);
+                runner.run("HandArchive::count (262144 hands, scalar)", [&] {
+                        doNotOptimize(archive.count(query, 1).matches);
+                });
+                if (best == TrickKernels::Isa::AVX2) {
+                        TrickKernels::setIsa(best);
+                        runner.run("HandArchive::count (262144 hands, avx2)", [&] {
+                                doNotOptimize(archive.count(query, 1).matches);
+                        }, "HandArchive::count (262144 hands, scalar)");
+                }
+                TrickKernels::setIsa(best);
+        }
+        HandArchive::remove(prefix);
+}
+
+void benchHandLog(BenchmarkRunner& runner) {
+        templatedGame game;
+        ringSink sink;
+        game.setHandLog(&sink);
+        benchHands(runner, "basic_x45s::dealBidAndFullFiveTricks (logged)", game);
+        // the same to a file, written by the engine's thread and by a background thread
+        const std::string path = "benchHandLog.bin";
+        {
+                HandLogWriter writer(path);
+                game.setHandLog(&writer);
+                benchHands(runner, "basic_x45s::dealBidAndFullFiveTricks (HandLogWriter)", game);
+        }
+        {
+                AsyncHandLog log(path);
+                AsyncHandLog::Producer producer(log);
+                game.setHandLog(&producer);
+                benchHands(runner, "basic_x45s::dealBidAndFullFiveTricks (AsyncHandLog)", game);
+        }
+        std::remove(path.c_str());
+        game.setHandLog(&sink);
+
+        // 1024 hands in order, from the start of a game, to analyze and replay
+        game.newGame();
+        sink.count = 0;
+        while (sink.count < sink.records.size()) {
+                if (game.hasWon()) {
+                        game.newGame();
+                }
+                game.reset();
+                game.shuffle();
+                game.dealBidAndFullFiveTricks();
+        }
+        game.setHandLog(nullptr);
+        std::vector<HandRecord> records(sink.records.begin(), sink.records.end());
+        runner.run("HandRecord::points (1024 records)", [&] {
+                int total = 0;
+                for (const HandRecord& record : records) {
+                        total += record.points()[0];
+                }
+                doNotOptimize(total);
+        });
+        ReplayGame replay;
+        runner.run("replayHand (1024 records)", [&] {
+                for (const HandRecord& record : records) {
+                        doNotOptimize(replayHand(replay, record));
+                }
+        });
+        benchHandArchive(runner, records);
+}
+
+// ops_per_second of these is games per second
+template <class Game>
+void benchGames(BenchmarkRunner& runner, const std::string& name, Game& game) {
+        game.seed(kSeed);
+        runner.run(name, [&] {
+                game.newGame();
+                doNotOptimize(game.playGame());
+        });
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+        double minSeconds = 0.25;
+        std::string outputPath;
+        std::string filter;
+        for (int i = 1; i < argc; i++) {
+                std::string arg = argv[i];
+                if (arg.rfind("--min-time=", 0) == 0) {
+                        minSeconds = std::atof(arg.c_str() + 11);
+                } else if (arg.rfind("--filter=", 0) == 0) {
+                        filter = arg.substr(9);
+                } else {
+                        outputPath = arg;
+                }
+        }
+
+        BenchmarkRunner runner(minSeconds, filter);
+        benchLessThan(runner);
+        benchLegalPlays(runner);
+        benchEvaluateTrick(runner);
+        benchTrickKernels(runner);
+        benchDeck(runner);
+        benchDeals(runner);
+        benchRanking(runner);
+        benchBidding(runner);
+        benchSolver(runner);
+        benchParallelSolver(runner);
+
+        x45s runtimeGame = makeRuntimeGame();
+        templatedGame game;
+        benchHands(runner, "x45s::dealBidAndFullFiveTricks", runtimeGame);
+        benchHands(runner, "basic_x45s::dealBidAndFullFiveTricks", game);
+        benchGames(runner, "x45s::playGame (to 120)", runtimeGame);
+        benchGames(runner, "basic_x45s::playGame (to 120)", game);
+        benchGameBatch(runner);
+        benchHandLog(runner);
+
+        if (outputPath.empty()) {
+                runner.writeJson(std::cout, kSeed);
+        } else {
+                std::ofstream out(outputPath);
+                runner.writeJson(out, kSeed);
+        }
+        return 0;
+}
@@ -0,0 +1,93 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// stops the compiler from optimizing away a value that is never used
+template <class T>
+inline void doNotOptimize(const T& value) {
+        __asm__ __volatile__("" : : "r,m"(value) : "memory");
+}
+
+struct BenchmarkResult {
+        std::string name;
+        int64_t iterations;
+        double nsPerOp;
+        // the benchmark this one is compared with, or empty
+        std::string baseline;
+};
+
+// Times f, which does one operation per call, and records the result.
+// f is run in batches that double in size until a batch takes at least minSeconds,
+// and the time of that last batch is reported. Everything random in f should use a fixed seed.
+// Only benchmarks with the filter in their name are run.
+class BenchmarkRunner {
+ public:
+        explicit BenchmarkRunner(double inpMinSeconds = 0.25, std::string inpFilter = "")
+                : minSeconds(inpMinSeconds), filter(std::move(inpFilter)) {}
+
+        // true if the benchmark passes the filter
+        bool wanted(const std::string& name) const {
+                return name.find(filter) != std::string::npos;
+        }
+
+        // baseline is the name of an earlier benchmark doing the same work, like the same
+        // search on one thread. The JSON then has the speedup over it
+        template <class F>
+        void run(const std::string& name, F f, const std::string& baseline = "") {
+                if (!wanted(name)) {
+                        return;
+                }
+                using Clock = std::chrono::steady_clock;
+                // warm up the caches and the branch predictor
+                for (int i = 0; i < 16; i++) {
+                        f();
+                }
+                int64_t iterations = 1;
+                while (true) {
+                        auto start = Clock::now();
+                        for (int64_t i = 0; i < iterations; i++) {
+                                f();
+                        }
+                        std::chrono::duration<double> elapsed = Clock::now() - start;
+                        if (elapsed.count() >= minSeconds || iterations >= (int64_t{1} << 40)) {
+                                results.push_back({name, iterations,
+                                        elapsed.count() * 1e9 / iterations, baseline});
+                                return;
+                        }
+                        iterations *= 2;
+                }
+        }
+
+        const std::vector<BenchmarkResult>& getResults() const { return results; }
+
+        // writes the results as JSON: {"seed": ..., "benchmarks": [{"name", "iterations",
+        // "ns_per_op", "ops_per_second", and "speedup" if it has a baseline}, ...]}
+        void writeJson(std::ostream& out, uint64_t seed) const {
+                out << "{\n  \"seed\": " << seed << ",\n  \"benchmarks\": [";
+                for (size_t i = 0; i < results.size(); i++) {
+                        const BenchmarkResult& r = results[i];
+                        out << (i == 0 ? "\n" : ",\n")
+                                << "    {\"name\": \"" << r.name << "\", "
+                                << "\"iterations\": " << r.iterations << ", "
+                                << "\"ns_per_op\": " << r.nsPerOp << ", "
+                                << "\"ops_per_second\": " << 1e9 / r.nsPerOp;
+                        for (const BenchmarkResult& base : results) {
+                                if (!r.baseline.empty() && base.name == r.baseline) {
+                                        out << ", \"speedup\": " << base.nsPerOp / r.nsPerOp;
+                                }
+                        }
+                        out << "}";
+                }
+                out << "\n  ]\n}\n";
+        }
+
+ private:
+        double minSeconds;
+        std::string filter;
+        std::vector<BenchmarkResult> results;
+};
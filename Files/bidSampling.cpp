@@ -0,0 +1,67 @@
+// Copyright Andrew Bernal 2023
+#include "bidSampling.hpp"
+#include "handTracker.hpp"
+
+CardSet BidSampling::strongestFive(CardSet cards, Suit::Suit trump) {
+        CardSet keep;
+        cards.forEachByStrength(trump, [&keep](const Card& c) {
+                if (keep.size() < 5) {
+                        keep.insert(c);
+                }
+        });
+        return keep;
+}
+
+void BidSampling::redraw(std::array<CardSet, 4>& hands, int seat, CardSet rest, Suit::Suit trump,
+        Xoshiro256StarStar& rng) {
+        for (int p = 0; p < 4; p++) {
+                if (p == seat) {
+                        continue;
+                }
+                hands[p] &= CardSet::trumpMask(trump);
+                hands[p] |= takeRandom(rest, 5 - hands[p].size(), rng);
+        }
+}
+
+namespace {
+// the other hands and the kiddie. unknown is left with the cards that weren't dealt
+std::array<CardSet, 4> dealOthers(CardSet hand, CardSet& unknown, CardSet& kiddie,
+        Xoshiro256StarStar& rng) {
+        unknown = ~hand;
+        std::array<CardSet, 4> dealt;
+        for (int p = 1; p < 4; p++) {
+                dealt[p] = takeRandom(unknown, 5, rng);
+        }
+        kiddie = takeRandom(unknown, 3, rng);
+        return dealt;
+}
+
+// the bidder is player 0, so the solver's points are already the bidder's team's
+int pointsWith(CardSet hand, std::array<CardSet, 4> hands, CardSet kiddie, CardSet unknown,
+        Suit::Suit trump, DoubleDummySolver& solver, Xoshiro256StarStar& rng) {
+        hands[0] = BidSampling::strongestFive(hand | kiddie, trump);
+        BidSampling::redraw(hands, 0, unknown, trump, rng);
+        return solver.solve(hands, trump, 0);
+}
+}  // namespace
+
+std::array<int, 4> BidSampling::samplePoints(CardSet hand, DoubleDummySolver& solver,
+        Xoshiro256StarStar& rng) {
+        CardSet unknown;
+        CardSet kiddie;
+        std::array<CardSet, 4> dealt = dealOthers(hand, unknown, kiddie, rng);
+        std::array<int, 4> points;
+        for (int s = Suit::HEARTS; s <= Suit::SPADES; s++) {
+                points[s - 1] = pointsWith(hand, dealt, kiddie, unknown,
+                        static_cast<Suit::Suit>(s), solver, rng);
+        }
+        return points;
+}
+
+int BidSampling::samplePoints(CardSet hand, Suit::Suit trump, DoubleDummySolver& solver,
+        Xoshiro256StarStar& rng) {
+        CardSet unknown;
+        CardSet kiddie;
+        std::array<CardSet, 4> dealt = dealOthers(hand, unknown, kiddie, rng);
+        return pointsWith(hand, dealt, kiddie, unknown, trump, solver, rng);
+}
@@ -0,0 +1,27 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <array>
+#include "cardSet.hpp"
+#include "random.hpp"
+#include "solver.hpp"
+#include "suit.hpp"
+
+// Monte Carlo estimates of what a hand is worth to the player who wins the bid with it.
+// A sample deals the other hands and the kiddie at random, the bidder keeps its 5 strongest
+// cards, the other players keep their trumps and draw, and the double dummy solver plays it out.
+namespace BidSampling {
+        // the 5 strongest cards for the trump: the trumps from the strongest down, then the others
+        CardSet strongestFive(CardSet cards, Suit::Suit trump);
+        // the players who aren't seat keep their trumps and draw back up to 5 cards from rest,
+        // like the engine's discard and second deal
+        void redraw(std::array<CardSet, 4>& hands, int seat, CardSet rest, Suit::Suit trump,
+                Xoshiro256StarStar& rng);
+        // one sample for the 5 card hand. points[trump - 1] is the points out of 30 the
+        // bidder's team takes with that trump, when the bidder leads.
+        // Every trump gets the same deal
+        std::array<int, 4> samplePoints(CardSet hand, DoubleDummySolver& solver,
+                Xoshiro256StarStar& rng);
+        // the same with only one trump
+        int samplePoints(CardSet hand, Suit::Suit trump, DoubleDummySolver& solver,
+                Xoshiro256StarStar& rng);
+}
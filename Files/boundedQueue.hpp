@@ -0,0 +1,84 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// A fixed size queue that any number of threads can push to and pop from without a lock
+// (Vyukov's bounded MPMC queue). Every cell has a sequence number that says whether it is ready
+// to be pushed to or popped from on this lap of the ring, so a push or pop is one compare and
+// swap on the head or the tail.
+template <class T>
+class BoundedQueue {
+ public:
+        // the capacity is rounded up to a power of 2
+        explicit BoundedQueue(std::size_t capacity) {
+                std::size_t size = 2;
+                while (size < capacity) {
+                        size *= 2;
+                }
+                cells = std::make_unique<Cell[]>(size);
+                mask = size - 1;
+                for (std::size_t i = 0; i < size; i++) {
+                        cells[i].sequence.store(i, std::memory_order_relaxed);
+                }
+        }
+
+        // false if the queue is full
+        bool tryPush(const T& item) {
+                std::size_t position = tail.load(std::memory_order_relaxed);
+                while (true) {
+                        Cell& cell = cells[position & mask];
+                        std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                        if (sequence == position) {
+                                if (tail.compare_exchange_weak(position, position + 1,
+                                        std::memory_order_relaxed)) {
+                                        cell.item = item;
+                                        cell.sequence.store(position + 1,
+                                                std::memory_order_release);
+                                        return true;
+                                }
+                        } else if (sequence < position) {
+                                return false;
+                        } else {
+                                position = tail.load(std::memory_order_relaxed);
+                        }
+                }
+        }
+
+        // false if the queue is empty
+        bool tryPop(T& item) {
+                std::size_t position = head.load(std::memory_order_relaxed);
+                while (true) {
+                        Cell& cell = cells[position & mask];
+                        std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                        if (sequence == position + 1) {
+                                if (head.compare_exchange_weak(position, position + 1,
+                                        std::memory_order_relaxed)) {
+                                        item = cell.item;
+                                        cell.sequence.store(position + mask + 1,
+                                                std::memory_order_release);
+                                        return true;
+                                }
+                        } else if (sequence < position + 1) {
+                                return false;
+                        } else {
+                                position = head.load(std::memory_order_relaxed);
+                        }
+                }
+        }
+
+        std::size_t capacity() const { return mask + 1; }
+
+ private:
+        struct Cell {
+                std::atomic<std::size_t> sequence;
+                T item;
+        };
+
+        std::unique_ptr<Cell[]> cells;
+        std::size_t mask;
+        // pushes and pops are on different cache lines, so they don't slow each other down
+        alignas(64) std::atomic<std::size_t> tail{0};
+        alignas(64) std::atomic<std::size_t> head{0};
+};
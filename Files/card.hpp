@@ -1,68 +1,194 @@
 // Copyright Andrew Bernal 2023
 #pragma once
+#include <array>
+#include <cstdint>
 #include <iostream>
+#include <stdexcept>
 #include <string>
 #include "suit.hpp"
-// Could store 1 card in 1 char to save space, each only needs values 1-13 and 0-4 (value and suit)
-// That would be an evil monstrosity, but if I need to save space, it could be done...
+
+// A Card is stored in a single byte.
+// Real cards keep their index (0-51) in the low 6 bits: index = (suit - 1) * 13 + (value - 1),
+// so the ace of hearts is index 0 and the king of spades is index 51.
+// Anything else (the default Card, or a card that only has its value or its suit set) has the
+// top bit set and keeps the suit in bits 4-6 and the value in bits 0-3, so the setters still work.
 
 // These cards are programmed to follow 45s rules for <, >, ==, etc.
 // Comparison operators require knowledge of the current trump and suit
 class Card {
-    int value;
-    Suit::Suit suit;
-    bool isAceOfHearts;
+    uint8_t code;
+
+    static constexpr uint8_t kPartial = 0x80;
+
+    static constexpr uint8_t encode(int value, int suit) {
+        // the ace of hearts can be passed as either 1 or 0xACE. 0xACE of any other suit isn't a
+        // card, so it only keeps the suit
+        if (value == 0xACE && suit == Suit::HEARTS) {
+            value = 1;
+        }
+        bool validValue = value >= 1 && value <= 13;
+        bool validSuit = suit >= Suit::HEARTS && suit <= Suit::SPADES;
+        if (validValue && validSuit) {
+            return static_cast<uint8_t>((suit - 1) * 13 + value - 1);
+        }
+        int suitBits = validSuit ? suit << 4 : 0;
+        return static_cast<uint8_t>(kPartial | suitBits | (validValue ? value : 0));
+    }
+
+    int rawValue() const {
+        return code & kPartial ? code & 0xF : code % 13 + 1;
+    }
+    int rawSuit() const {
+        return code & kPartial ? (code >> 4) & 0x7 : code / 13 + 1;
+    }
 
  public:
+    static constexpr int kNumCards = 52;
+
     // I need a default constructor so I can make pairs of cards
-    Card() : value(-1000), suit(Suit::INVALID) {}
+    // The value of a default card is -1000, and the suit is Suit::INVALID
+    Card() : code(kPartial) {}
     // value, suit
-    Card(int inpValue, int inpSuit) : value(inpValue), suit(static_cast<Suit::Suit>(inpSuit)) {
-        isAceOfHearts = value == 1 && suit == Suit::HEARTS;
-        value = isAceOfHearts ? 0xACE : value;
-    }
-    Card(int inpValue, Suit::Suit inpSuit) : value(inpValue), suit(inpSuit) {
-        isAceOfHearts = value == 1 && suit == Suit::HEARTS;
-        value = isAceOfHearts ? 0xACE : value;
+    Card(int inpValue, int inpSuit) : code(encode(inpValue, inpSuit)) {}
+    Card(int inpValue, Suit::Suit inpSuit) : code(encode(inpValue, inpSuit)) {}
+
+    // builds a card from its index (0-51)
+    static Card fromIndex(int index) {
+        Card c;
+        c.code = static_cast<uint8_t>(index);
+        return c;
     }
 
     // outputs the card in string format, e.g. "King of Hearts, "
     friend std::ostream& operator<<(std::ostream& out, const Card& c);
 
+    // true for the 52 real cards, false for default or partially set cards
+    bool isValid() const {
+        return code < kNumCards;
+    }
+
+    // returns the index of the card (0-51), or -1 if it is not a real card
+    int getIndex() const {
+        return isValid() ? code : -1;
+    }
+
+    bool isAceOfHearts() const {
+        return code == 0;
+    }
+
     int getValue() const {
-        return value;
+        if (isAceOfHearts()) {
+            return 0xACE;
+        }
+        int value = rawValue();
+        return value == 0 ? -1000 : value;
     }
 
     Suit::Suit getSuit() const {
-        return suit;
+        int suit = rawSuit();
+        return suit == 0 ? Suit::INVALID : static_cast<Suit::Suit>(suit);
     }
 
     void setSuit(int inpSuit) {
-        suit = static_cast<Suit::Suit>(inpSuit);
+        code = encode(rawValue(), inpSuit);
     }
     void setSuit(Suit::Suit inpSuit) {
-        suit = inpSuit;
+        code = encode(rawValue(), inpSuit);
     }
 
     void setValue(int inpValue) {
-        value = inpValue;
+        code = encode(inpValue, rawSuit());
     }
 
     bool isTrump(Suit::Suit trump) const {
-        return suit == trump || isAceOfHearts;
+        return getSuit() == trump || isAceOfHearts();
     }
 
     bool isSuitLed(Suit::Suit suitLed) const {
-        return suit == suitLed;
+        return getSuit() == suitLed;
     }
 
-    // compares two card. Uses evaluateOffSuit if they are offSuit
-    friend bool lessThan(
-        const Card& card1, const Card& card2, Suit::Suit suitLed, Suit::Suit trump);
-    friend bool evaluateOffSuit(const Card& lhs, const Card& rhs, Suit::Suit suitLed);
+    friend bool operator==(const Card& lhs, const Card& rhs);
 };
 
+static_assert(sizeof(Card) == 1, "Card should fit in a single byte");
+
+// Strength of every card for each (trump, suitLed) pair.
+// Comparing two cards is one load from the table for each card and one integer compare.
+// Trump cards are 2-15 (the 5 of trump is 15), cards of the suit led are 1, everything else is 0.
+// Like evaluateOffSuit, two non-trump cards of the suit led have the same strength.
+namespace CardRank {
+        // trump orders from highest to lowest. 0xACE is the ace of hearts
+        constexpr int kHeartsOrder[14] = {5, 11, 0xACE, 13, 12, 10, 9, 8, 7, 6, 4, 3, 2, 0};
+        constexpr int kDiamondsOrder[14] = {5, 11, 0xACE, 1, 13, 12, 10, 9, 8, 7, 6, 4, 3, 2};
+        constexpr int kBlackOrder[14] = {5, 11, 0xACE, 1, 13, 12, 2, 3, 4, 6, 7, 8, 9, 10};
+
+        // slots 52-63 of each row are for cards that are not real cards, and are always 0
+        constexpr int kRowSize = 64;
+        using Row = std::array<uint8_t, kRowSize>;
+        // indexed by [trump - 1][suitLed], where suitLed 0 means no (valid) suit was led
+        using Table = std::array<std::array<Row, 5>, 4>;
+
+        constexpr uint8_t strengthOf(int index, int suitLed, int trump) {
+                int suit = index / 13 + 1;
+                int value = index == 0 ? 0xACE : index % 13 + 1;
+                if (suit == trump || index == 0) {
+                        const int* order = trump == Suit::HEARTS ? kHeartsOrder :
+                                trump == Suit::DIAMONDS ? kDiamondsOrder : kBlackOrder;
+                        int position = 0;
+                        while (order[position] != value) {
+                                position++;
+                        }
+                        return static_cast<uint8_t>(15 - position);
+                }
+                return suit == suitLed ? 1 : 0;
+        }
+
+        constexpr Table buildTable() {
+                Table table{};
+                for (int trump = Suit::HEARTS; trump <= Suit::SPADES; trump++) {
+                        for (int suitLed = 0; suitLed <= Suit::SPADES; suitLed++) {
+                                for (int i = 0; i < Card::kNumCards; i++) {
+                                        table[trump - 1][suitLed][i] =
+                                                strengthOf(i, suitLed, trump);
+                                }
+                        }
+                }
+                return table;
+        }
+
+        inline constexpr Table kStrength = buildTable();
+
+        // the row of strengths to use for the trump and the suit led. Throws if trump is invalid
+        inline const Row& row(Suit::Suit suitLed, Suit::Suit trump) {
+                if (trump < Suit::HEARTS || trump > Suit::SPADES) {
+                        throw std::invalid_argument("trump is not valid!");
+                }
+                int led = suitLed >= Suit::HEARTS && suitLed <= Suit::SPADES ? suitLed : 0;
+                return kStrength[trump - 1][led];
+        }
+
+        // slot of a card in a row. Cards that are not real cards share slot 52
+        inline int slot(const Card& c) {
+                int index = c.getIndex();
+                return index < 0 ? Card::kNumCards : index;
+        }
+
+        inline int strength(const Card& c, Suit::Suit suitLed, Suit::Suit trump) {
+                return row(suitLed, trump)[slot(c)];
+        }
+}
+
+// compares two cards of the same trick. Throws if trump is invalid
+inline bool lessThan(const Card& lhs, const Card& rhs, Suit::Suit suitLed, Suit::Suit trump) {
+        const CardRank::Row& strengths = CardRank::row(suitLed, trump);
+        return strengths[CardRank::slot(lhs)] < strengths[CardRank::slot(rhs)];
+}
+
+// compares two cards that are not trump. Returns true if only rhs is of the suit led
+bool evaluateOffSuit(const Card& lhs, const Card& rhs, Suit::Suit suitLed);
+
 // inspired from https://stackoverflow.com/questions/4421706/what-are-the-basic-rules-and-idioms-for-operator-overloading
-inline bool operator==(const Card& lhs, const Card& rhs) { return lhs.getSuit() == rhs.getSuit()
-&& rhs.getValue() == lhs.getValue(); }
+// every (value, suit) pair has exactly one encoding, so comparing the bytes is enough
+inline bool operator==(const Card& lhs, const Card& rhs) { return lhs.code == rhs.code; }
 inline bool operator!=(const Card& lhs, const Card& rhs) { return !operator==(lhs, rhs); }
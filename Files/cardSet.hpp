@@ -0,0 +1,157 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+#include "card.hpp"
+#include "span.hpp"
+#include "suit.hpp"
+
+// A set of cards stored as a 64 bit mask. Bit i is set if the card with index i is in the set,
+// so membership, insertion and removal are single instructions, and there is no heap traffic.
+class CardSet {
+        uint64_t mask;
+
+ public:
+        static constexpr uint64_t kAllCards = (uint64_t{1} << Card::kNumCards) - 1;
+
+        constexpr CardSet() : mask(0) {}
+        constexpr explicit CardSet(uint64_t inpMask) : mask(inpMask) {}
+        template <class... Cards>
+        explicit CardSet(Card c, Cards... cards) : mask(0) {
+                insert(c);
+                (insert(cards), ...);
+        }
+        // cards that are not real cards (like the default Card) are skipped
+        explicit CardSet(Span<const Card> cards) : mask(0) {
+                for (const Card& c : cards) {
+                        if (c.isValid()) {
+                                insert(c);
+                        }
+                }
+        }
+
+        // all 52 cards
+        static constexpr CardSet all() {
+                return CardSet(kAllCards);
+        }
+
+        // the 13 cards of a suit (1-4). The ace of hearts is in the hearts mask
+        static constexpr CardSet suitMask(Suit::Suit suit) {
+                return CardSet(uint64_t{0x1FFF} << ((suit - 1) * 13));
+        }
+
+        // the cards that are trump: the suit and the ace of hearts
+        static constexpr CardSet trumpMask(Suit::Suit trump) {
+                return CardSet(suitMask(trump).mask | 1);
+        }
+
+        // the cards that follow the suit led. If trump was led that is every trump, otherwise
+        // it is the suit without the ace of hearts (which is always trump)
+        static constexpr CardSet followMask(Suit::Suit suitLed, Suit::Suit trump) {
+                if (suitLed == trump) {
+                        return trumpMask(trump);
+                }
+                return CardSet(suitMask(suitLed).mask & ~uint64_t{1});
+        }
+
+        constexpr uint64_t getMask() const {
+                return mask;
+        }
+
+        bool contains(const Card& c) const {
+                return c.isValid() && (mask >> c.getIndex()) & 1;
+        }
+        // the card must be a real card
+        void insert(const Card& c) {
+                mask |= uint64_t{1} << c.getIndex();
+        }
+        void remove(const Card& c) {
+                mask &= ~(uint64_t{1} << c.getIndex());
+        }
+        void clear() {
+                mask = 0;
+        }
+
+        int size() const {
+                return __builtin_popcountll(mask);
+        }
+        bool empty() const {
+                return mask == 0;
+        }
+
+        // the card with the smallest index. The set must not be empty
+        Card lowest() const {
+                return Card::fromIndex(__builtin_ctzll(mask));
+        }
+
+        CardSet operator&(CardSet other) const { return CardSet(mask & other.mask); }
+        CardSet operator|(CardSet other) const { return CardSet(mask | other.mask); }
+        // the cards in this set that are not in other
+        CardSet operator-(CardSet other) const { return CardSet(mask & ~other.mask); }
+        // the cards that are not in this set, out of the 52
+        CardSet operator~() const { return CardSet(~mask & kAllCards); }
+        CardSet& operator&=(CardSet other) { mask &= other.mask; return *this; }
+        CardSet& operator|=(CardSet other) { mask |= other.mask; return *this; }
+        CardSet& operator-=(CardSet other) { mask &= ~other.mask; return *this; }
+        bool operator==(CardSet other) const { return mask == other.mask; }
+        bool operator!=(CardSet other) const { return mask != other.mask; }
+
+        // iterates the cards from the smallest index to the largest
+        class Iterator {
+                uint64_t remaining;
+
+         public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = Card;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const Card*;
+                using reference = Card;
+
+                explicit Iterator(uint64_t inpRemaining) : remaining(inpRemaining) {}
+                Card operator*() const { return Card::fromIndex(__builtin_ctzll(remaining)); }
+                Iterator& operator++() {
+                        remaining &= remaining - 1;
+                        return *this;
+                }
+                bool operator!=(const Iterator& other) const {
+                        return remaining != other.remaining;
+                }
+        };
+        Iterator begin() const { return Iterator(mask); }
+        Iterator end() const { return Iterator(0); }
+
+        // calls f on every card, from the strongest trump to the weakest,
+        // then the cards that are not trump from the smallest index to the largest
+        template <class F>
+        void forEachByStrength(Suit::Suit trump, F f) const {
+                const CardRank::Row& strengths = CardRank::row(Suit::INVALID, trump);
+                // bit s of byStrength is set if the trump with strength s is in the set
+                uint32_t byStrength = 0;
+                int indexOfStrength[16] = {};
+                for (uint64_t m = mask & trumpMask(trump).mask; m != 0; m &= m - 1) {
+                        int index = __builtin_ctzll(m);
+                        byStrength |= uint32_t{1} << strengths[index];
+                        indexOfStrength[strengths[index]] = index;
+                }
+                while (byStrength != 0) {
+                        int strongest = 31 - __builtin_clz(byStrength);
+                        byStrength &= ~(uint32_t{1} << strongest);
+                        f(Card::fromIndex(indexOfStrength[strongest]));
+                }
+                for (Card c : *this - trumpMask(trump)) {
+                        f(c);
+                }
+        }
+
+        // the cards in the set, in the same order as the iterator
+        std::vector<Card> toVector() const {
+                std::vector<Card> cards;
+                cards.reserve(size());
+                for (Card c : *this) {
+                        cards.push_back(c);
+                }
+                return cards;
+        }
+};
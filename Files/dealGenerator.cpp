@@ -0,0 +1,62 @@
+// Copyright Andrew Bernal 2023
+#include "dealGenerator.hpp"
+#include <array>
+#include <cstring>
+#include <utility>
+#include "cardSet.hpp"
+
+namespace {
+constexpr std::array<uint8_t, Card::kNumCards> buildOrderedDeck() {
+        std::array<uint8_t, Card::kNumCards> deck{};
+        for (int i = 0; i < Card::kNumCards; i++) {
+                deck[i] = static_cast<uint8_t>(i);
+        }
+        return deck;
+}
+
+// every card index in order, copied in to start each deal
+constexpr std::array<uint8_t, Card::kNumCards> kOrderedDeck = buildOrderedDeck();
+
+// the first count steps of a Fisher-Yates shuffle of the 52 cards of pool. Each 64 bit number
+// is split into the 32 bit numbers of two steps, so there is one call to the generator for
+// every two cards
+void shuffleFront(uint8_t* pool, int count, Xoshiro256StarStar& rng) {
+        for (int i = 0; i < count; i += 2) {
+                uint64_t bits = rng();
+                uint32_t pick = i + boundedRandom(rng, Card::kNumCards - i,
+                        static_cast<uint32_t>(bits));
+                std::swap(pool[i], pool[pick]);
+                if (i + 1 < count) {
+                        pick = i + 1 + boundedRandom(rng, Card::kNumCards - i - 1,
+                                static_cast<uint32_t>(bits >> 32));
+                        std::swap(pool[i + 1], pool[pick]);
+                }
+        }
+}
+}  // namespace
+
+void DealGenerator::deal(int count, uint64_t* const hands[4], uint64_t* decks) {
+        const uint64_t all = CardSet::all().getMask();
+        for (int k = 0; k < count; k++) {
+                uint8_t pool[Card::kNumCards];
+                std::memcpy(pool, kOrderedDeck.data(), sizeof(pool));
+                // only the dealt cards have to be shuffled: the rest are a set
+                shuffleFront(pool, kDealt, rng);
+                uint64_t dealt[4] = {0, 0, 0, 0};
+                for (int i = 0; i < kDealt; i++) {
+                        dealt[i / kHandSize] |= uint64_t{1} << pool[i];
+                }
+                for (int seat = 0; seat < 4; seat++) {
+                        hands[seat][k] = dealt[seat];
+                }
+                decks[k] = all & ~(dealt[0] | dealt[1] | dealt[2] | dealt[3]);
+        }
+}
+
+void DealGenerator::deal(int count, uint8_t* cards) {
+        for (int k = 0; k < count; k++) {
+                uint8_t* pool = cards + static_cast<int64_t>(k) * Card::kNumCards;
+                std::memcpy(pool, kOrderedDeck.data(), Card::kNumCards);
+                shuffleFront(pool, Card::kNumCards - 1, rng);
+        }
+}
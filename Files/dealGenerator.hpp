@@ -0,0 +1,30 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <cstdint>
+#include "card.hpp"
+#include "random.hpp"
+
+// Deals many hands at once, straight into the caller's arrays, for simulations that play a lot
+// of short hands. Each deal is a Fisher-Yates shuffle of the 52 card indexes with unbiased
+// random numbers, so every deal is equally likely, the same as shuffling a Deck and dealing from
+// it. No Cards or Decks are made: the cards are bytes and the hands are bit masks.
+// The same seed always gives the same deals.
+class DealGenerator {
+ public:
+        static constexpr int kHandSize = 5;
+        // the cards dealt to the 4 players, and the cards left in the deck
+        static constexpr int kDealt = 4 * kHandSize;
+        static constexpr int kDeckSize = Card::kNumCards - kDealt;
+
+        explicit DealGenerator(uint64_t inpSeed = 0) : rng(inpSeed) {}
+        void seed(uint64_t inpSeed) { rng.seed(inpSeed); }
+
+        // hands[seat][k] is the cards of seat (0-3) in deal k, and decks[k] the 32 cards left
+        void deal(int count, uint64_t* const hands[4], uint64_t* decks);
+        // cards[52 * k] to cards[52 * k + 51] is deal k as a shuffled deck of card indexes:
+        // 5 cards for each seat in order, then the 32 cards left, in the order to draw them
+        void deal(int count, uint8_t* cards);
+
+ private:
+        Xoshiro256StarStar rng;
+};
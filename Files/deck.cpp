@@ -1,51 +1,39 @@
 // Copyright Andrew Bernal 2023
 #include "deck.hpp"
-#include <ctime>
 #include <stdexcept>
 #include <algorithm>
 #include <utility>
 #include "suit.hpp"
 
-Deck::Deck() {
-        // initalize 52 cards, Hearts = 1, Diamonds = 2, Clubs = 3, Spades = 4, Invalid = 5
-        for (int i = Suit::HEARTS; i < Suit::INVALID; i++) {
-                for (int j = 1; j < 14; j++) {
-                        pack.push_back(Card(j, i));
-                }
-        }
+Deck::Deck() : rng(randomSeed()) {
+        reset();
+}
+
+Deck::Deck(uint64_t seed) : rng(seed) {
+        reset();
+}
+
+void Deck::seed(uint64_t seed) {
+        rng.seed(seed);
 }
 
 void Deck::shuffle() {
-        // swap each index of the deck with a random index
-        // Fischer-Yates
-        unsigned int seed = time(nullptr);
-        for (int i = pack.size() - 1; i > 0; i--) {
-                // TODO(zinkelburger): implement the shuffle with the seed as a parameter
-                int j = rand_r(&seed) % (i + 1);
-                Card c = pack[j];
-                pack[j] = pack[i];
-                pack[i] = c;
-        }
+        shuffle(rng);
 }
 
+// a single Fisher-Yates pass is already uniform, more passes don't make the deck more random
 void Deck::shuffle(int times) {
-        unsigned int seed = time(nullptr);
-        for (int j = 0; j < times; j++) {
-                // swap each index of the deck with a random index
-                for (int i = 0; i < static_cast<int>(pack.size()); i++) {
-                        int random = rand_r(&seed) % pack.size();
-                        Card c = pack[random];
-                        pack[random] = pack[i];
-                        pack[i] = c;
-                }
+        for (int i = 0; i < times; i++) {
+                shuffle(rng);
         }
 }
 
 Card Deck::pop_back() {
-        // I think std::move is overkill as a Card is cheap to copy.
-        // Probably the compiler optimizes it anyways...
+        // a Card is a single byte, so copying it is free
+        bool hadDuplicates = static_cast<int>(pack.size()) != contents.size();
         Card c(pack.back());
         pack.pop_back();
+        forgetCard(c, hadDuplicates);
         return c;
 }
 
@@ -53,61 +41,71 @@ Card Deck::peek_back() {
         return pack.back();
 }
 
+// the pack takes any card, but only real cards can be in the set
 void Deck::push_back(Card c) {
         pack.push_back(c);
+        if (c.isValid()) {
+                contents.insert(c);
+        }
 }
 
 void Deck::reset() {
         pack.clear();
-        // the same code as the constructor
         // initalize 52 cards, Hearts = 1, Diamonds = 2, Clubs = 3, Spades = 4
-        for (int i = Suit::HEARTS; i <= Suit::SPADES; i++) {
-                for (int j = 1; j < 14; j++) {
-                        pack.push_back(Card(j, i));
-                }
+        // the cards are in index order, the ace of hearts is first
+        for (int i = 0; i < Card::kNumCards; i++) {
+                pack.push_back(Card::fromIndex(i));
         }
+        contents = CardSet::all();
 }
 
-void Deck::removeCard(const Card& c) {
-        // linear search the deck until you find the card, then remove it
-        std::vector<Card>::iterator i;
-        for (i = pack.begin(); i < pack.end(); i++) {
-                if (i->getSuit() == c.getSuit() && i->getValue() == c.getValue()) {
-                        pack.erase(i);
-                        break;
-                }
+// the pack can only have more cards than the set if a card was pushed back twice
+void Deck::forgetCard(const Card& c, bool hadDuplicates) {
+        if (!c.isValid()) {
+                return;
         }
-        if (i == pack.end()) {
+        if (!hadDuplicates || std::find(pack.begin(), pack.end(), c) == pack.end()) {
+                contents.remove(c);
+        }
+}
+
+void Deck::removeCard(const Card& c) {
+        if (!contents.contains(c)) {
                 throw std::invalid_argument("Invalid value, suit pair passed to removeCard: " +
                 std::to_string(c.getValue()) + ", " + std::to_string(c.getSuit()) + "\n");
         }
+        bool hadDuplicates = static_cast<int>(pack.size()) != contents.size();
+        pack.erase(std::find(pack.begin(), pack.end(), c));
+        forgetCard(c, hadDuplicates);
 }
 
 void Deck::removeCard(int value, int suit) {
-        // linear search the deck until you find the card, then remove it
-        std::vector<Card>::iterator i;
-        for (i = pack.begin(); i < pack.end(); i++) {
-                if (i->getSuit() == suit && i->getValue() == value) {
-                        pack.erase(i);
-                        return;
+        removeCard(Card(value, suit));
+}
+
+// the rest of the pack keeps its order under the stacked cards
+void Deck::stack(Span<const Card> top) {
+        CardSet onTop;
+        for (const Card& c : top) {
+                if (!contents.contains(c) || onTop.contains(c)) {
+                        throw std::invalid_argument("can't stack a card that isn't in the deck, "
+                                "or stack it twice");
                 }
+                onTop.insert(c);
         }
-        if (i == pack.end()) {
-                throw std::invalid_argument("Invalid value, suit pair passed to removeCard: " +
-                std::to_string(value) + ", " + std::to_string(suit) + "\n");
+        pack.erase(std::remove_if(pack.begin(), pack.end(),
+                [onTop](const Card& c) { return onTop.contains(c); }), pack.end());
+        for (auto it = top.end(); it != top.begin();) {
+                pack.push_back(*--it);
         }
 }
 
-// same code as removeCard, except it doesn't remove the card
-bool Deck::containsCard(int value, int suit) {
-        // linear search the deck until you find the card
-        std::vector<Card>::iterator i;
-        for (i = pack.begin(); i < pack.end(); i++) {
-                if (i->getSuit() == suit && i->getValue() == value) {
-                        return true;
-                }
-        }
-        return false;
+bool Deck::containsCard(int value, int suit) const {
+        return contents.contains(Card(value, suit));
+}
+
+bool Deck::containsCard(const Card& c) const {
+        return contents.contains(c);
 }
 
 std::ostream& operator<<(std::ostream& out, const Deck& d) {
@@ -1,30 +1,62 @@
 // Copyright Andrew Bernal 2023
 #pragma once
+#include <cstdint>
 #include <vector>
 #include <utility>
 #include "card.hpp"
+#include "cardSet.hpp"
+#include "random.hpp"
+#include "span.hpp"
 
 class Deck {
  private:
         // idk I needed a word different from deck and card
         std::vector<Card> pack;
+        // the cards in pack, so containsCard doesn't have to search it
+        CardSet contents;
+
+        // every deck has its own generator, so decks shuffled at the same time are different
+        Xoshiro256StarStar rng;
+
+        // removes c from contents, unless a second copy of c is still in the pack
+        void forgetCard(const Card& c, bool hadDuplicates);
  public:
+        // seeds the generator from std::random_device
         Deck();
+        // the same seed always gives the same shuffles
+        explicit Deck(uint64_t seed);
+        void seed(uint64_t seed);
+        // one unbiased Fisher-Yates pass with the deck's own generator
         void shuffle();
         void shuffle(int times);
+        // one Fisher-Yates pass with any UniformRandomBitGenerator that gives at least 32 bits
+        template <class URBG>
+        void shuffle(URBG& g) {
+                for (int i = static_cast<int>(pack.size()) - 1; i > 0; i--) {
+                        int j = boundedRandom(g, i + 1);
+                        std::swap(pack[i], pack[j]);
+                }
+        }
         Card pop_back();
         Card peek_back();
         void push_back(Card c);
         void reset();
         void removeCard(const Card& c);
         void removeCard(int value, int suit);
-        bool containsCard(int value, int suit);
+        // moves the cards to the top of the deck, so pop_back deals top[0] first. Every card has
+        // to be in the deck once, or it throws std::invalid_argument
+        void stack(Span<const Card> top);
+        bool containsCard(int value, int suit) const;
+        bool containsCard(const Card& c) const;
         friend std::ostream& operator<<(std::ostream& out, const Deck& d);
         int getSize() {
                 return pack.size();
         }
-        // returns a copy of the deck
-        std::vector<Card> getPack() {
+        const std::vector<Card>& getPack() const {
                 return pack;
         }
+        // the cards in the deck as a set
+        CardSet getCardSet() const {
+                return contents;
+        }
 };
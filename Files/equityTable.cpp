@@ -0,0 +1,161 @@
+// Copyright Andrew Bernal 2023
+#include "equityTable.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "bidSampling.hpp"
+#include "parallel.hpp"
+#include "random.hpp"
+#include "solver.hpp"
+
+namespace {
+constexpr char kMagic[8] = {'4', '5', 's', 'E', 'Q', 'T', 'Y', '\0'};
+// version 2 has a record for each class instead of each hand and trump
+constexpr uint32_t kVersion = 2;
+// the solver's table for every thread has 2^kSolverTableBits entries
+constexpr int kSolverTableBits = 16;
+
+struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t samples;
+        uint64_t numClasses;
+        uint64_t seed;
+};
+static_assert(sizeof(Header) == 32, "the header is 32 bytes");
+}  // namespace
+
+EquityTable::EquityTable(const std::string& path) : mapping(nullptr), mappingSize(0) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+                throw std::runtime_error("can't open the equity table " + path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+                close(fd);
+                throw std::runtime_error(path + " is not an equity table");
+        }
+        mappingSize = info.st_size;
+        mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+                throw std::runtime_error("can't map the equity table " + path);
+        }
+
+        Header header;
+        std::memcpy(&header, mapping, sizeof(Header));
+        bool valid = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+                header.version == kVersion && header.numClasses <= kNumClasses &&
+                mappingSize == sizeof(Header) + header.numClasses * sizeof(HandEquity);
+        if (!valid) {
+                munmap(mapping, mappingSize);
+                throw std::runtime_error(path + " is not an equity table");
+        }
+        numClasses = header.numClasses;
+        samples = header.samples;
+        records = reinterpret_cast<const HandEquity*>(static_cast<const char*>(mapping) +
+                sizeof(Header));
+}
+
+EquityTable::~EquityTable() {
+        munmap(mapping, mappingSize);
+}
+
+const HandEquity& EquityTable::lookup(CardSet hand, Suit::Suit trump) const {
+        int64_t index = Symmetry::handClassIndex(hand, trump);
+        if (index >= numClasses) {
+                throw std::out_of_range("the equity table doesn't have the hand");
+        }
+        return records[index];
+}
+
+std::pair<int, Suit::Suit> EquityTable::bestBid(CardSet hand, int highest,
+        double confidence) const {
+        for (int bid = 30; bid >= 15 && bid > highest; bid -= 5) {
+                Suit::Suit surest = Suit::HEARTS;
+                for (int s = Suit::DIAMONDS; s <= Suit::SPADES; s++) {
+                        Suit::Suit suit = static_cast<Suit::Suit>(s);
+                        if (lookup(hand, suit).makeProbability(bid) >
+                                lookup(hand, surest).makeProbability(bid)) {
+                                surest = suit;
+                        }
+                }
+                if (lookup(hand, surest).makeProbability(bid) >= confidence) {
+                        return {bid, surest};
+                }
+        }
+        return {0, bestTrump(hand)};
+}
+
+Suit::Suit EquityTable::bestTrump(CardSet hand) const {
+        Suit::Suit best = Suit::HEARTS;
+        for (int s = Suit::DIAMONDS; s <= Suit::SPADES; s++) {
+                Suit::Suit suit = static_cast<Suit::Suit>(s);
+                if (lookup(hand, suit).points8 > lookup(hand, best).points8) {
+                        best = suit;
+                }
+        }
+        return best;
+}
+
+void EquityTable::generate(const std::string& path, int samplesPerHand, int numThreads,
+        uint64_t seed, int64_t classCount) {
+        if (samplesPerHand < 1) {
+                throw std::invalid_argument("every hand needs at least 1 sample");
+        }
+        if (classCount < 1 || classCount > kNumClasses) {
+                throw std::invalid_argument("the number of classes must be from 1 to " +
+                        std::to_string(kNumClasses));
+        }
+        numThreads = resolveThreadCount(numThreads);
+        std::vector<std::unique_ptr<DoubleDummySolver>> solvers;
+        for (int t = 0; t < numThreads; t++) {
+                solvers.push_back(std::make_unique<DoubleDummySolver>(kSolverTableBits));
+        }
+
+        std::vector<HandEquity> table(classCount);
+        parallelFor(0, classCount, numThreads, 64, [&](int t, int64_t index) {
+                Symmetry::CanonicalHand canonical = Symmetry::handClassAt(index);
+                Xoshiro256StarStar rng(SplitMix64(seed ^ static_cast<uint64_t>(index))());
+                int total = 0;
+                std::array<int, 4> made = {};
+                for (int i = 0; i < samplesPerHand; i++) {
+                        int points = BidSampling::samplePoints(canonical.hand, canonical.trump,
+                                *solvers[t], rng);
+                        total += points;
+                        for (int b = 0; b < 4; b++) {
+                                made[b] += points >= 15 + 5 * b;
+                        }
+                }
+                HandEquity& record = table[index];
+                record.points8 = static_cast<uint8_t>(std::lround(8.0 * total / samplesPerHand));
+                for (int b = 0; b < 4; b++) {
+                        record.made[b] = static_cast<uint8_t>(std::lround(255.0 * made[b] /
+                                samplesPerHand));
+                }
+        });
+
+        Header header = {};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.samples = samplesPerHand;
+        header.numClasses = classCount;
+        header.seed = seed;
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(table.data()),
+                table.size() * sizeof(HandEquity));
+        if (!out) {
+                throw std::runtime_error("can't write the equity table " + path);
+        }
+}
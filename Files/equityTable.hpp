@@ -0,0 +1,67 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include "cardSet.hpp"
+#include "suit.hpp"
+#include "symmetry.hpp"
+
+// what a 5 card hand is worth to the player who wins the bid with it, with one trump
+struct HandEquity {
+        // the average points out of 30, in eighths of a point
+        uint8_t points8;
+        // made[i] is the chance of taking at least 15 + 5i points, out of 255
+        uint8_t made[4];
+
+        double expectedPoints() const { return points8 / 8.0; }
+        // bid is 15, 20, 25 or 30
+        double makeProbability(int bid) const { return made[(bid - 15) / 5] / 255.0; }
+};
+static_assert(sizeof(HandEquity) == 5, "HandEquity is packed into 5 bytes");
+
+// A table of HandEquity for every 5 card hand and trump, made offline by generate and read back
+// with mmap, so a bid is one lookup instead of a Monte Carlo run.
+// A hand and trump is worth the same as its swap of clubs and spades, so the table only has one
+// record for each class of them (see Symmetry::handClassIndex), which is about half of the
+// 4 * 2598960 pairs. The file is a 32 byte header and then the records in class order, about
+// 26MB.
+// The estimates come from BidSampling: the kiddie and the other hands are dealt at random, the
+// bidder keeps its strongest 5 cards and everyone plays double dummy.
+class EquityTable {
+ public:
+        static constexpr int64_t kNumClasses = Symmetry::kNumHandClasses;
+
+        // maps the file into memory. Throws std::runtime_error if it can't be read or isn't a
+        // table
+        explicit EquityTable(const std::string& path);
+        ~EquityTable();
+        EquityTable(const EquityTable&) = delete;
+        EquityTable& operator=(const EquityTable&) = delete;
+
+        // hand has 5 cards. Throws std::out_of_range if the table doesn't have its class
+        const HandEquity& lookup(CardSet hand, Suit::Suit trump) const;
+        // the highest bid above highest that is made at least confidence of the time, in the
+        // trump that makes it most often. Otherwise 0 and bestTrump
+        std::pair<int, Suit::Suit> bestBid(CardSet hand, int highest, double confidence) const;
+        // the trump with the most expected points
+        Suit::Suit bestTrump(CardSet hand) const;
+
+        // the table only has the first numClasses classes, when it was made for tests
+        int64_t getNumClasses() const { return numClasses; }
+        int getSamples() const { return samples; }
+
+        // writes a table for the first classCount classes, with samplesPerHand deals for each
+        // one, solved on numThreads threads. Every class has its own random stream, so the file
+        // only depends on the seed. Throws std::runtime_error if it can't write the file
+        static void generate(const std::string& path, int samplesPerHand, int numThreads,
+                uint64_t seed, int64_t classCount = kNumClasses);
+
+ private:
+        void* mapping;
+        std::size_t mappingSize;
+        int64_t numClasses;
+        int samples;
+        const HandEquity* records;
+};
@@ -0,0 +1,87 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+
+// A vector with its storage inside the object, so it never allocates.
+// It has the parts of the std::vector interface the game uses. Pushing past the capacity throws.
+template <class T, int Capacity>
+class FixedVector {
+        T items[Capacity];
+        int count;
+
+ public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        FixedVector() : items(), count(0) {}
+        FixedVector(std::initializer_list<T> init) : items(), count(0) {
+                for (const T& item : init) {
+                        push_back(item);
+                }
+        }
+        template <class InputIt>
+        FixedVector(InputIt first, InputIt last) : items(), count(0) {
+                for (; first != last; ++first) {
+                        push_back(*first);
+                }
+        }
+
+        void push_back(const T& item) {
+                if (count == Capacity) {
+                        throw std::length_error("FixedVector is full, its capacity is " +
+                        std::to_string(Capacity));
+                }
+                items[count++] = item;
+        }
+        void pop_back() {
+                count--;
+        }
+        // removes the item at pos, and moves the ones after it forward. Returns the item after pos
+        iterator erase(const_iterator pos) {
+                iterator first = begin() + (pos - begin());
+                for (iterator it = first; it + 1 != end(); ++it) {
+                        *it = *(it + 1);
+                }
+                count--;
+                return first;
+        }
+        void clear() {
+                count = 0;
+        }
+
+        T& operator[](std::size_t i) { return items[i]; }
+        const T& operator[](std::size_t i) const { return items[i]; }
+        T& front() { return items[0]; }
+        const T& front() const { return items[0]; }
+        T& back() { return items[count - 1]; }
+        const T& back() const { return items[count - 1]; }
+        T* data() { return items; }
+        const T* data() const { return items; }
+
+        std::size_t size() const { return count; }
+        static constexpr std::size_t capacity() { return Capacity; }
+        bool empty() const { return count == 0; }
+
+        iterator begin() { return items; }
+        iterator end() { return items + count; }
+        const_iterator begin() const { return items; }
+        const_iterator end() const { return items + count; }
+
+        bool operator==(const FixedVector& other) const {
+                if (count != other.count) {
+                        return false;
+                }
+                for (int i = 0; i < count; i++) {
+                        if (!(items[i] == other.items[i])) {
+                                return false;
+                        }
+                }
+                return true;
+        }
+        bool operator!=(const FixedVector& other) const { return !(*this == other); }
+};
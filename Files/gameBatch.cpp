@@ -0,0 +1,293 @@
+// Copyright Andrew Bernal 2023
+#include "gameBatch.hpp"
+#include <stdexcept>
+#include "card.hpp"
+#include "gameState.hpp"
+#include "handTracker.hpp"
+#include "rules.hpp"
+#include "trickKernels.hpp"
+
+GameBatch::GameBatch(int inpNumGames, uint64_t seed)
+        : numGames(inpNumGames), maxHandsPerGame(1000), activeGames(0), phase(Phase::BID),
+        decision(0), trickSize(0), tricksPlayed(0) {
+        if (numGames < 1) {
+                throw std::invalid_argument("a batch needs at least 1 game");
+        }
+        for (auto* v : {&active, &seats, &trumps, &highestTrumps, &bidders, &dealers, &leaders,
+                &suitsLed, &highCards, &trumpAnswers, &cardAnswers, &trickWinners}) {
+                v->resize(numGames);
+        }
+        for (auto* v : {&choices, &decks, &played, &keepAnswers, &toPlay}) {
+                v->resize(numGames);
+        }
+        for (auto* v : {&highestBids, &bidAmounts, &highCardPlayers, &winners, &bidAnswers}) {
+                v->resize(numGames);
+        }
+        for (int i = 0; i < 4; i++) {
+                hands[i].resize(numGames);
+                trick[i].resize(numGames);
+        }
+        for (int team = 0; team < 2; team++) {
+                handScores[team].resize(numGames);
+                teamScores[team].resize(numGames);
+        }
+        rngs.resize(numGames);
+        handsPlayed.resize(numGames);
+        newGames(seed);
+}
+
+void GameBatch::newGames(uint64_t seed) {
+        for (int g = 0; g < numGames; g++) {
+                rngs[g].seed(SplitMix64(seed ^ static_cast<uint64_t>(g))());
+                active[g] = 1;
+                teamScores[0][g] = 0;
+                teamScores[1][g] = 0;
+                dealers[g] = 0;
+                winners[g] = -1;
+                handsPlayed[g] = 0;
+        }
+        activeGames = numGames;
+        startHand();
+}
+
+int64_t GameBatch::playGames(BatchPolicy& policy) {
+        while (!done()) {
+                step(policy);
+        }
+        int64_t total = 0;
+        for (int32_t playedHands : handsPlayed) {
+                total += playedHands;
+        }
+        return total;
+}
+
+void GameBatch::startHand() {
+        phase = Phase::BID;
+        decision = 0;
+        trickSize = 0;
+        tricksPlayed = 0;
+        for (int g = 0; g < numGames; g++) {
+                if (!active[g]) {
+                        continue;
+                }
+                // dealing from the set of cards left is the same as dealing from a shuffled deck
+                CardSet deck = CardSet::all();
+                for (int seat = 0; seat < 4; seat++) {
+                        hands[seat][g] = takeRandom(deck, 5, rngs[g]).getMask();
+                }
+                decks[g] = deck.getMask();
+                played[g] = 0;
+                trumps[g] = 0;
+                highestBids[g] = 0;
+                highestTrumps[g] = 0;
+                bidAmounts[g] = 0;
+                handScores[0][g] = 0;
+                handScores[1][g] = 0;
+                highCardPlayers[g] = -1;
+        }
+        prepare();
+}
+
+void GameBatch::prepare() {
+        for (int g = 0; g < numGames; g++) {
+                if (!active[g]) {
+                        seats[g] = 0;
+                        choices[g] = 0;
+                        toPlay[g] = 0;
+                        continue;
+                }
+                int seat;
+                if (phase == Phase::BID) {
+                        seat = (dealers[g] + 1 + decision) % 4;
+                        choices[g] = hands[seat][g];
+                } else if (phase == Phase::DISCARD) {
+                        seat = decision;
+                        choices[g] = hands[seat][g];
+                } else {
+                        seat = (leaders[g] + trickSize) % 4;
+                        toPlay[g] = hands[seat][g];
+                }
+                seats[g] = static_cast<uint8_t>(seat);
+        }
+        if (phase == Phase::PLAY) {
+                // the games that are over have no cards, so they have no choices either
+                const uint8_t* led = trickSize == 0 ? nullptr : trick[0].data();
+                TrickKernels::legalPlays(toPlay.data(), led, trumps.data(), numGames,
+                        choices.data());
+        }
+}
+
+void GameBatch::step(BatchPolicy& policy) {
+        if (done()) {
+                return;
+        }
+        if (phase == Phase::BID) {
+                policy.bid(*this, Span<int8_t>(bidAnswers), Span<uint8_t>(trumpAnswers));
+                applyBids();
+        } else if (phase == Phase::DISCARD) {
+                policy.discard(*this, Span<uint64_t>(keepAnswers));
+                applyDiscards();
+        } else {
+                policy.play(*this, Span<uint8_t>(cardAnswers));
+                applyCards();
+        }
+}
+
+void GameBatch::applyBids() {
+        for (int g = 0; g < numGames; g++) {
+                if (!active[g]) {
+                        continue;
+                }
+                int amount = bidAnswers[g];
+                bool bagged = isBagged(g);
+                if (amount != 0 && (amount < 15 || amount > 30 || amount % 5 != 0)) {
+                        throw std::invalid_argument("a bid is 0, 15, 20, 25 or 30");
+                }
+                // the highest bid wins, and a bagged dealer bids 15
+                if (bagged || amount > highestBids[g]) {
+                        int trump = trumpAnswers[g];
+                        if (trump < Suit::HEARTS || trump > Suit::SPADES) {
+                                throw std::invalid_argument("trump is not valid!");
+                        }
+                        highestBids[g] = static_cast<int8_t>(bagged ? 15 : amount);
+                        highestTrumps[g] = static_cast<uint8_t>(trump);
+                        bidders[g] = seats[g];
+                }
+        }
+        if (++decision < 4) {
+                prepare();
+                return;
+        }
+
+        // the bidder gets the kiddie, and the next player deals the next hand
+        for (int g = 0; g < numGames; g++) {
+                if (!active[g]) {
+                        continue;
+                }
+                trumps[g] = highestTrumps[g];
+                bidAmounts[g] = highestBids[g];
+                dealers[g] = static_cast<uint8_t>((dealers[g] + 1) % 4);
+                leaders[g] = bidders[g];
+                CardSet deck(decks[g]);
+                hands[bidders[g]][g] |= takeRandom(deck, 3, rngs[g]).getMask();
+                decks[g] = deck.getMask();
+        }
+        phase = Phase::DISCARD;
+        decision = 0;
+        prepare();
+}
+
+void GameBatch::applyDiscards() {
+        int seat = decision;
+        for (int g = 0; g < numGames; g++) {
+                if (!active[g]) {
+                        continue;
+                }
+                uint64_t keep = keepAnswers[g];
+                if ((keep & ~hands[seat][g]) != 0 || __builtin_popcountll(keep) > 5) {
+                        throw std::invalid_argument("a player keeps at most 5 of their cards");
+                }
+                hands[seat][g] = keep;
+        }
+        if (++decision < 4) {
+                prepare();
+                return;
+        }
+
+        // everyone draws back up to 5 cards, in seat order
+        for (int g = 0; g < numGames; g++) {
+                if (!active[g]) {
+                        continue;
+                }
+                CardSet deck(decks[g]);
+                for (int i = 0; i < 4; i++) {
+                        int missing = 5 - __builtin_popcountll(hands[i][g]);
+                        hands[i][g] |= takeRandom(deck, missing, rngs[g]).getMask();
+                }
+                decks[g] = deck.getMask();
+        }
+        phase = Phase::PLAY;
+        decision = 0;
+        prepare();
+}
+
+void GameBatch::applyCards() {
+        for (int g = 0; g < numGames; g++) {
+                if (!active[g]) {
+                        continue;
+                }
+                int card = cardAnswers[g];
+                uint64_t bit = uint64_t{1} << (card & 63);
+                if (card >= Card::kNumCards || (choices[g] & bit) == 0) {
+                        throw std::invalid_argument("the card can't be played");
+                }
+                hands[seats[g]][g] &= ~bit;
+                played[g] |= bit;
+                trick[trickSize][g] = static_cast<uint8_t>(card);
+                if (trickSize == 0) {
+                        suitsLed[g] = static_cast<uint8_t>(card / 13 + 1);
+                }
+        }
+        decision++;
+        if (++trickSize < 4) {
+                prepare();
+                return;
+        }
+
+        // the trick is over: its winner takes 5 points and leads the next one
+        const uint8_t* const cards[4] = {trick[0].data(), trick[1].data(), trick[2].data(),
+                trick[3].data()};
+        TrickKernels::trickWinners(cards, trumps.data(), numGames, trickWinners.data());
+        for (int g = 0; g < numGames; g++) {
+                if (!active[g]) {
+                        continue;
+                }
+                const CardRank::Row& strengths = CardRank::kStrength[trumps[g] - 1][suitsLed[g]];
+                int position = trickWinners[g];
+                int winner = (leaders[g] + position) % 4;
+                handScores[winner % 2][g] += 5;
+                uint8_t winning = trick[position][g];
+                if (highCardPlayers[g] < 0 || strengths[highCards[g]] < strengths[winning]) {
+                        highCards[g] = winning;
+                        highCardPlayers[g] = static_cast<int8_t>(winner);
+                }
+                leaders[g] = static_cast<uint8_t>(winner);
+        }
+        trickSize = 0;
+        if (++tricksPlayed < kTricksPerHand) {
+                prepare();
+                return;
+        }
+
+        for (int g = 0; g < numGames; g++) {
+                if (active[g]) {
+                        handScores[highCardPlayers[g] % 2][g] += 5;
+                        finishHand(g);
+                }
+        }
+        if (!done()) {
+                startHand();
+        }
+}
+
+void GameBatch::finishHand(int g) {
+        // the same as scoreHand: the other team keeps what they took, and the bidding team
+        // loses their bid if they didn't make it
+        int biddingTeam = bidders[g] % 2;
+        int otherTeam = 1 - biddingTeam;
+        teamScores[otherTeam][g] += handScores[otherTeam][g];
+        if (handScores[biddingTeam][g] >= bidAmounts[g]) {
+                teamScores[biddingTeam][g] += handScores[biddingTeam][g];
+        } else {
+                teamScores[biddingTeam][g] -= bidAmounts[g];
+        }
+        handsPlayed[g]++;
+
+        int winner = teamScores[0][g] >= kWinningScore ? 0 :
+                teamScores[1][g] >= kWinningScore ? 1 : -1;
+        winners[g] = static_cast<int8_t>(winner);
+        if (winner != -1 || handsPlayed[g] >= maxHandsPerGame) {
+                active[g] = 0;
+                activeGames--;
+        }
+}
@@ -0,0 +1,162 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "cardSet.hpp"
+#include "random.hpp"
+#include "span.hpp"
+#include "suit.hpp"
+
+class GameBatch;
+
+// Makes one decision for every game of a GameBatch at once. The batch's decision arrays
+// (getActive, getSeats and getChoices) say which games have a decision, which player makes it
+// and what they can choose from, and the policy fills in an answer for every game. The answers
+// of games that aren't active are ignored.
+// Every seat of every game goes through the same policy, so a policy that plays the seats
+// differently has to look at getSeats.
+class BatchPolicy {
+ public:
+        virtual ~BatchPolicy() = default;
+
+        // amounts[g] is 0 (pass), 15, 20, 25 or 30 and trumps[g] is the suit (1-4).
+        // A dealer who is bagged (batch.isBagged(g)) bids 15 whatever the amount
+        virtual void bid(const GameBatch& batch, Span<int8_t> amounts, Span<uint8_t> trumps) = 0;
+        // keep[g] is the cards to keep: at most 5 of the choices. The rest are discarded
+        virtual void discard(const GameBatch& batch, Span<uint64_t> keep) = 0;
+        // cards[g] is the index (0-51) of one of the choices
+        virtual void play(const GameBatch& batch, Span<uint8_t> cards) = 0;
+};
+
+// Plays many games of 45s in lockstep, one decision at a time in every game.
+// The games are stored as a struct of arrays: every part of the state (the hands of each seat,
+// the trumps, the cards of the trick, the scores, ...) is its own array indexed by game, so the
+// rules run as loops over the games, and a policy gets the decisions of every game in one call.
+// The games follow the same rules as x45s. Every hand has the same 28 decisions in every game:
+// 4 bids (from the left of the dealer, and the dealer last), 4 discards (seats 0 to 3), then the
+// 20 cards of the 5 tricks. A game that is over sits out until every game is over.
+// Every game has its own random generator, seeded from the seed and the game's number, so a game
+// plays the same way in a batch of any size.
+// Illegal answers (a card that can't be played, keeping cards that aren't in the hand, a bid
+// that doesn't exist) throw std::invalid_argument, and the batch can't be used after that.
+class GameBatch {
+ public:
+        enum class Phase : uint8_t { BID, DISCARD, PLAY };
+        static constexpr int kDecisionsPerHand = 4 + 4 + 20;
+
+        GameBatch(int numGames, uint64_t seed);
+
+        // starts every game again: 0 to 0, player 0 dealing, and the first hand dealt
+        void newGames(uint64_t seed);
+        // one decision in every game that isn't over
+        void step(BatchPolicy& policy);
+        // steps until every game is over. Returns the hands played by all of the games
+        int64_t playGames(BatchPolicy& policy);
+        // a game that hasn't ended after this many hands is stopped, with no winner
+        void setMaxHandsPerGame(int inpHands) { maxHandsPerGame = inpHands; }
+
+        int getNumGames() const { return numGames; }
+        // true when every game is over
+        bool done() const { return activeGames == 0; }
+        Phase getPhase() const { return phase; }
+        // the cards played to the current trick, and the tricks finished this hand
+        int getTrickSize() const { return trickSize; }
+        int getTricksPlayed() const { return tricksPlayed; }
+
+        // the decision arrays. active[g] is 1 if game g has a decision, seats[g] is the player
+        // making it, and choices[g] is the cards they choose from: their hand when bidding and
+        // discarding (the bidder has the kiddie by then), and the legal cards when playing
+        Span<const uint8_t> getActive() const { return view(active); }
+        Span<const uint8_t> getSeats() const { return view(seats); }
+        Span<const uint64_t> getChoices() const { return view(choices); }
+        // true if game g's decision is the dealer's bid, and everyone else passed
+        bool isBagged(int g) const {
+                return phase == Phase::BID && decision == 3 && highestBids[g] <= 0;
+        }
+        // the highest bid so far this hand, 0 if everyone has passed
+        Span<const int8_t> getHighestBids() const { return view(highestBids); }
+
+        // the cards of the player at seat (0-3)
+        Span<const uint64_t> getHands(int seat) const { return view(hands[seat]); }
+        // the trump of every game, once the bidding is over
+        Span<const uint8_t> getTrumps() const { return view(trumps); }
+        Span<const uint8_t> getBidders() const { return view(bidders); }
+        Span<const int8_t> getBidAmounts() const { return view(bidAmounts); }
+        Span<const uint8_t> getDealers() const { return view(dealers); }
+        // the player who led the current trick
+        Span<const uint8_t> getLeaders() const { return view(leaders); }
+        // the suit of the card that led the current (or last) trick
+        Span<const uint8_t> getSuitsLed() const { return view(suitsLed); }
+        // the card index at position (0-3) of the current trick, for the first getTrickSize
+        Span<const uint8_t> getTrickCards(int position) const { return view(trick[position]); }
+        // the cards played this hand
+        Span<const uint64_t> getPlayed() const { return view(played); }
+        // the points each team (0 or 1) has taken this hand, and in the game
+        Span<const int8_t> getHandScores(int team) const { return view(handScores[team]); }
+        Span<const int16_t> getTeamScores(int team) const { return view(teamScores[team]); }
+        // the team that won each game, or -1 while it is still going or if it was stopped
+        Span<const int8_t> getWinners() const { return view(winners); }
+        Span<const int32_t> getHandsPlayed() const { return view(handsPlayed); }
+
+ private:
+        int numGames;
+        int maxHandsPerGame;
+        int activeGames;
+        // every game is at the same decision of its hand
+        Phase phase;
+        // the decision within the phase: the bid (0-3), the seat discarding, or the card (0-19)
+        int decision;
+        int trickSize;
+        int tricksPlayed;
+
+        // the decision arrays
+        std::vector<uint8_t> active;
+        std::vector<uint8_t> seats;
+        std::vector<uint64_t> choices;
+        // the answers of the policy
+        std::vector<int8_t> bidAnswers;
+        std::vector<uint8_t> trumpAnswers;
+        std::vector<uint64_t> keepAnswers;
+        std::vector<uint8_t> cardAnswers;
+
+        // the state of the games
+        std::vector<Xoshiro256StarStar> rngs;
+        std::vector<uint64_t> hands[4];
+        // the cards that haven't been dealt
+        std::vector<uint64_t> decks;
+        std::vector<uint64_t> played;
+        std::vector<uint8_t> trumps;
+        std::vector<int8_t> highestBids;
+        std::vector<uint8_t> highestTrumps;
+        std::vector<uint8_t> bidders;
+        std::vector<int8_t> bidAmounts;
+        std::vector<uint8_t> dealers;
+        std::vector<uint8_t> leaders;
+        std::vector<uint8_t> suitsLed;
+        std::vector<uint8_t> trick[4];
+        // the strongest trick winner this hand. highCardPlayers[g] is -1 before the first trick
+        std::vector<uint8_t> highCards;
+        std::vector<int8_t> highCardPlayers;
+        std::vector<int8_t> handScores[2];
+        std::vector<int16_t> teamScores[2];
+        std::vector<int8_t> winners;
+        std::vector<int32_t> handsPlayed;
+        // scratch for the trick kernels: the hand of the player to play, and who won the trick
+        std::vector<uint64_t> toPlay;
+        std::vector<uint8_t> trickWinners;
+
+        template <class T>
+        static Span<const T> view(const std::vector<T>& v) {
+                return Span<const T>(v.data(), v.size());
+        }
+
+        // shuffles and deals the next hand of every game that isn't over
+        void startHand();
+        // fills in the decision arrays for the current decision
+        void prepare();
+        void applyBids();
+        void applyDiscards();
+        void applyCards();
+        // scores the hand of game g, and ends the game if it is over
+        void finishHand(int g);
+};
@@ -0,0 +1,105 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <cstdint>
+#include <type_traits>
+#include "card.hpp"
+#include "cardSet.hpp"
+#include "playPosition.hpp"
+#include "rules.hpp"
+#include "suit.hpp"
+
+// The rules state of a game of 45s, without the players or the deck.
+// It is trivially copyable and small, so a bot can copy it to look ahead, and a search can copy
+// it millions of times a second. The functions below are the rules: they take a state and return
+// the next one, and never touch anything else. basic_x45s drives a game by calling them.
+struct GameState {
+        // the hands, the trump, the trick in progress and the high card
+        PlayPosition play;
+        // every card played this hand
+        CardSet played;
+        int16_t teamScores[2] = {0, 0};
+        // points each team has taken this hand, from tricks and the high card
+        int8_t handScores[2] = {0, 0};
+        int8_t bidAmount = 0;
+        int8_t bidder = 0;
+        // deals the next hand. Incremented mod 4 after every bidding phase
+        int8_t dealer = 0;
+        int8_t tricksPlayed = 0;
+        // the suit of the card that led the last trick
+        Suit::Suit suitLed = Suit::INVALID;
+};
+
+static_assert(std::is_trivially_copyable<GameState>::value, "GameState must be cheap to copy");
+static_assert(sizeof(GameState) <= 80, "GameState should stay a few dozen bytes");
+
+constexpr int kTricksPerHand = 5;
+constexpr int kWinningScore = 120;
+
+// a state for the next hand: no cards, no tricks and no points this hand. The scores, the dealer
+// and the trump are kept
+inline GameState startHand(GameState state) {
+        Suit::Suit trump = state.play.trump;
+        state.play = PlayPosition();
+        state.play.trump = trump;
+        state.played.clear();
+        state.handScores[0] = 0;
+        state.handScores[1] = 0;
+        state.tricksPlayed = 0;
+        return state;
+}
+
+// the cards the player to play can play
+inline CardSet legalMoves(const GameState& state) {
+        return Rules::legalPlays(state.play.hands[state.play.toPlay()], state.play.led(),
+                state.play.trump);
+}
+
+// plays c for the player to play. The team that wins a trick gets 5 points for the hand, and
+// after the last trick the team with the high card gets 5 more
+inline GameState applyMove(GameState state, const Card& c) {
+        if (state.play.trickSize == 0) {
+                state.suitLed = c.getSuit();
+        }
+        if (c.isValid()) {
+                state.played.insert(c);
+        }
+        state.play.play(c);
+        if (state.play.trickSize == 0) {
+                state.handScores[state.play.leader % 2] += 5;
+                state.tricksPlayed++;
+                if (state.tricksPlayed == kTricksPerHand) {
+                        state.handScores[state.play.highCardPlayer % 2] += 5;
+                }
+        }
+        return state;
+}
+
+// true if a player can bid amount: 0 passes, and 15 is what a bagged dealer is made to bid
+inline bool isBidAmount(int amount) {
+        return amount == 0 || amount == 15 || amount == 20 || amount == 25 || amount == 30;
+}
+
+// true if the bidding team has taken at least the amount they bid this hand
+inline bool madeBid(const GameState& state) {
+        return state.handScores[state.bidder % 2] >= state.bidAmount;
+}
+
+// adds the points of the hand to the scores. The bidding team loses the amount they bid if they
+// didn't make it, the other team always keeps what they took
+inline GameState scoreHand(GameState state) {
+        int biddingTeam = state.bidder % 2;
+        int otherTeam = (state.bidder + 1) % 2;
+        state.teamScores[otherTeam] += state.handScores[otherTeam];
+        if (madeBid(state)) {
+                state.teamScores[biddingTeam] += state.handScores[biddingTeam];
+        } else {
+                state.teamScores[biddingTeam] -= state.bidAmount;
+        }
+        return state;
+}
+
+// the team (0 or 1) that has won the game, or -1 if no one has won
+inline int winningTeam(const GameState& state) {
+        return state.teamScores[0] >= kWinningScore ? 0 :
+                state.teamScores[1] >= kWinningScore ? 1 : -1;
+}
@@ -0,0 +1,362 @@
+// Copyright Andrew Bernal 2023
+#include "handArchive.hpp"
+#include <fcntl.h>
+#include <immintrin.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "parallel.hpp"
+#include "trickKernels.hpp"
+
+namespace {
+constexpr char kMagic[8] = {'4', '5', 's', 'C', 'O', 'L', 'M', 'N'};
+constexpr uint32_t kVersion = 1;
+
+struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t valueSize;
+        uint64_t count;
+        uint64_t blockRows;
+};
+static_assert(sizeof(Header) == 32, "the header is 32 bytes");
+
+constexpr const char* kColumnNames[11] = {".bidder", ".bidAmount", ".trump", ".points", ".made",
+        ".hand0", ".hand1", ".hand2", ".hand3", ".bidderHand", ".summary"};
+constexpr int kHandColumn = 5;
+constexpr int kBidderHandColumn = 9;
+constexpr int kSummaryColumn = 10;
+// the blocks write works out before writing them, so it never holds every column in memory
+constexpr int64_t kChunkBlocks = 64;
+
+// a block's columns, from its first hand
+struct Columns {
+        const uint8_t* bidders;
+        const int8_t* bids;
+        const uint8_t* trumps;
+        const int8_t* points;
+        const uint8_t* made;
+        const uint64_t* bidderHands;
+};
+
+// a query with its ranges clamped to the columns' int8 values, and its sets as bitmasks
+struct Filter {
+        int minBid;
+        int maxBid;
+        int minPoints;
+        int maxPoints;
+        uint8_t bidders;
+        uint8_t trumps;
+        uint8_t outcomes;
+        uint64_t holds;
+        uint64_t lacks;
+
+        explicit Filter(const HandQuery& query)
+                : minBid(std::clamp(query.minBid, -128, 127)),
+                maxBid(std::clamp(query.maxBid, -128, 127)),
+                minPoints(std::clamp(query.minPoints, -128, 127)),
+                maxPoints(std::clamp(query.maxPoints, -128, 127)),
+                bidders(query.bidders), trumps(query.trumps), outcomes(query.outcomes),
+                holds(query.bidderHolds.getMask()), lacks(query.bidderLacks.getMask()) {}
+
+        bool matches(const Columns& c, int i) const {
+                return c.bids[i] >= minBid && c.bids[i] <= maxBid && c.points[i] >= minPoints &&
+                        c.points[i] <= maxPoints && ((bidders >> (c.bidders[i] & 7)) & 1) &&
+                        ((trumps >> ((c.trumps[i] - 1) & 7)) & 1) &&
+                        ((outcomes >> (c.made[i] & 7)) & 1) &&
+                        (c.bidderHands[i] & holds) == holds && (c.bidderHands[i] & lacks) == 0;
+        }
+
+        // true if no hand of the block can match
+        bool rulesOut(const HandArchive::BlockSummary& block) const {
+                return block.maxBid < minBid || block.minBid > maxBid ||
+                        block.maxPoints < minPoints || block.minPoints > maxPoints ||
+                        (block.bidders & bidders) == 0 || (block.trumps & trumps) == 0 ||
+                        (block.outcomes & outcomes) == 0 ||
+                        (holds & ~block.anyBidderCards) != 0 ||
+                        (lacks & block.allBidderCards) != 0;
+        }
+};
+
+void countScalar(const Columns& c, int begin, int end, const Filter& filter,
+        QueryResult& result) {
+        for (int i = begin; i < end; i++) {
+                if (filter.matches(c, i)) {
+                        result.matches++;
+                        result.made += c.made[i];
+                }
+        }
+}
+
+// 0xFF in the bytes of table whose index is a bit of bits
+__attribute__((target("avx2")))
+__m256i lookupTable(uint8_t bits, int offset) {
+        alignas(16) uint8_t table[16] = {};
+        for (int b = 0; b < 8; b++) {
+                if ((bits >> b) & 1) {
+                        table[b + offset] = 0xFF;
+                }
+        }
+        return _mm256_broadcastsi128_si256(
+                _mm_load_si128(reinterpret_cast<const __m128i*>(table)));
+}
+
+// 32 values of a byte column, from value i
+__attribute__((target("avx2")))
+__m256i loadBytes(const void* column, int i) {
+        return _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(static_cast<const uint8_t*>(column) + i));
+}
+
+// tests 32 hands at a time: the byte columns 32 to a register, the hands 4 to a register, and
+// the answers as bits. Returns the number of hands it tested
+__attribute__((target("avx2")))
+int countAvx2(const Columns& c, int count, const Filter& filter, QueryResult& result) {
+        const __m256i minBid = _mm256_set1_epi8(static_cast<char>(filter.minBid));
+        const __m256i maxBid = _mm256_set1_epi8(static_cast<char>(filter.maxBid));
+        const __m256i minPoints = _mm256_set1_epi8(static_cast<char>(filter.minPoints));
+        const __m256i maxPoints = _mm256_set1_epi8(static_cast<char>(filter.maxPoints));
+        const __m256i bidders = lookupTable(filter.bidders, 0);
+        // trumps are 1-4
+        const __m256i trumps = lookupTable(filter.trumps & 0xF, 1);
+        const __m256i outcomes = lookupTable(filter.outcomes & 3, 0);
+        const __m256i holds = _mm256_set1_epi64x(static_cast<int64_t>(filter.holds));
+        const __m256i lacks = _mm256_set1_epi64x(static_cast<int64_t>(filter.lacks));
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i low = _mm256_set1_epi8(0xF);
+
+        int i = 0;
+        for (; i + 32 <= count; i += 32) {
+                __m256i bid = loadBytes(c.bids, i);
+                __m256i points = loadBytes(c.points, i);
+                __m256i made = loadBytes(c.made, i);
+                __m256i outside = _mm256_or_si256(
+                        _mm256_or_si256(_mm256_cmpgt_epi8(minBid, bid),
+                                _mm256_cmpgt_epi8(bid, maxBid)),
+                        _mm256_or_si256(_mm256_cmpgt_epi8(minPoints, points),
+                                _mm256_cmpgt_epi8(points, maxPoints)));
+                __m256i bidder = _mm256_and_si256(loadBytes(c.bidders, i), low);
+                __m256i trump = _mm256_and_si256(loadBytes(c.trumps, i), low);
+                __m256i inSets = _mm256_and_si256(
+                        _mm256_and_si256(_mm256_shuffle_epi8(bidders, bidder),
+                                _mm256_shuffle_epi8(trumps, trump)),
+                        _mm256_shuffle_epi8(outcomes, _mm256_and_si256(made, low)));
+                uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(
+                        _mm256_andnot_si256(outside, inSets)));
+
+                uint32_t handBits = 0;
+                for (int j = 0; j < 8; j++) {
+                        __m256i hand = _mm256_loadu_si256(
+                                reinterpret_cast<const __m256i*>(c.bidderHands + i + 4 * j));
+                        __m256i ok = _mm256_and_si256(
+                                _mm256_cmpeq_epi64(_mm256_and_si256(hand, holds), holds),
+                                _mm256_cmpeq_epi64(_mm256_and_si256(hand, lacks), zero));
+                        handBits |= static_cast<uint32_t>(
+                                _mm256_movemask_pd(_mm256_castsi256_pd(ok))) << (4 * j);
+                }
+                bits &= handBits;
+                uint32_t madeBits = static_cast<uint32_t>(_mm256_movemask_epi8(
+                        _mm256_cmpeq_epi8(made, _mm256_set1_epi8(1))));
+                result.matches += __builtin_popcount(bits);
+                result.made += __builtin_popcount(bits & madeBits);
+        }
+        return i;
+}
+
+template <class T>
+void writeValues(std::ofstream& out, const std::vector<T>& values, int64_t count) {
+        out.write(reinterpret_cast<const char*>(values.data()), count * sizeof(T));
+}
+}  // namespace
+
+void HandArchive::write(const std::string& prefix, Span<const HandRecord> records,
+        int numThreads) {
+        const int64_t rows = records.size();
+        const int64_t blocks = (rows + kBlockRows - 1) / kBlockRows;
+        const std::size_t sizes[11] = {1, 1, 1, 1, 1, 8, 8, 8, 8, 8, sizeof(BlockSummary)};
+        std::ofstream out[11];
+        for (int i = 0; i < 11; i++) {
+                out[i].open(prefix + kColumnNames[i], std::ios::binary | std::ios::trunc);
+                Header header = {};
+                std::memcpy(header.magic, kMagic, sizeof(kMagic));
+                header.version = kVersion;
+                header.valueSize = static_cast<uint32_t>(sizes[i]);
+                header.count = i == kSummaryColumn ? blocks : rows;
+                header.blockRows = kBlockRows;
+                out[i].write(reinterpret_cast<const char*>(&header), sizeof(header));
+        }
+
+        const int64_t chunkRows = kChunkBlocks * kBlockRows;
+        std::vector<uint8_t> bidders(chunkRows);
+        std::vector<int8_t> bids(chunkRows);
+        std::vector<uint8_t> trumps(chunkRows);
+        std::vector<int8_t> points(chunkRows);
+        std::vector<uint8_t> made(chunkRows);
+        std::vector<uint64_t> hands[5];
+        for (std::vector<uint64_t>& column : hands) {
+                column.resize(chunkRows);
+        }
+        std::vector<BlockSummary> summaries(kChunkBlocks);
+
+        for (int64_t first = 0; first < rows; first += chunkRows) {
+                int64_t chunkEnd = std::min(rows, first + chunkRows);
+                int64_t chunkBlocks = (chunkEnd - first + kBlockRows - 1) / kBlockRows;
+                parallelFor(0, chunkBlocks, numThreads, 1, [&](int, int64_t b) {
+                        int64_t begin = b * kBlockRows;
+                        int64_t end = std::min(chunkEnd - first, begin + kBlockRows);
+                        BlockSummary summary = {127, -128, 127, -128, 0, 0, 0, 0, 0,
+                                ~uint64_t{0}};
+                        for (int64_t i = begin; i < end; i++) {
+                                const HandRecord& record = records[first + i];
+                                int bidder = record.bidder();
+                                int bid = record.bidAmount();
+                                int taken = record.points()[bidder % 2];
+                                std::array<CardSet, 4> played = record.playedHands();
+                                bidders[i] = static_cast<uint8_t>(bidder);
+                                bids[i] = static_cast<int8_t>(bid);
+                                trumps[i] = static_cast<uint8_t>(record.trump());
+                                points[i] = static_cast<int8_t>(taken);
+                                made[i] = taken >= bid;
+                                for (int seat = 0; seat < 4; seat++) {
+                                        hands[seat][i] = played[seat].getMask();
+                                }
+                                hands[4][i] = played[bidder].getMask();
+
+                                summary.minBid = std::min(summary.minBid, bids[i]);
+                                summary.maxBid = std::max(summary.maxBid, bids[i]);
+                                summary.minPoints = std::min(summary.minPoints, points[i]);
+                                summary.maxPoints = std::max(summary.maxPoints, points[i]);
+                                summary.bidders |= 1 << bidder;
+                                summary.trumps |= 1 << (trumps[i] - 1);
+                                summary.outcomes |= 1 << made[i];
+                                summary.anyBidderCards |= hands[4][i];
+                                summary.allBidderCards &= hands[4][i];
+                        }
+                        summaries[b] = summary;
+                });
+                int64_t count = chunkEnd - first;
+                writeValues(out[0], bidders, count);
+                writeValues(out[1], bids, count);
+                writeValues(out[2], trumps, count);
+                writeValues(out[3], points, count);
+                writeValues(out[4], made, count);
+                for (int column = 0; column < 5; column++) {
+                        writeValues(out[kHandColumn + column], hands[column], count);
+                }
+                writeValues(out[kSummaryColumn], summaries, chunkBlocks);
+        }
+        for (std::ofstream& file : out) {
+                file.close();
+                if (!file) {
+                        throw std::runtime_error("can't write the hand archive " + prefix);
+                }
+        }
+}
+
+HandArchive::HandArchive(const std::string& prefix) : rows(0) {
+        int64_t counts[11];
+        bidderColumn = static_cast<const uint8_t*>(map(prefix, 0, 1, counts[0]));
+        bidColumn = static_cast<const int8_t*>(map(prefix, 1, 1, counts[1]));
+        trumpColumn = static_cast<const uint8_t*>(map(prefix, 2, 1, counts[2]));
+        pointsColumn = static_cast<const int8_t*>(map(prefix, 3, 1, counts[3]));
+        madeColumn = static_cast<const uint8_t*>(map(prefix, 4, 1, counts[4]));
+        for (int seat = 0; seat < 4; seat++) {
+                handColumns[seat] = static_cast<const uint64_t*>(
+                        map(prefix, kHandColumn + seat, 8, counts[kHandColumn + seat]));
+        }
+        bidderHandColumn = static_cast<const uint64_t*>(
+                map(prefix, kBidderHandColumn, 8, counts[kBidderHandColumn]));
+        summaryColumn = static_cast<const BlockSummary*>(map(prefix, kSummaryColumn,
+                sizeof(BlockSummary), counts[kSummaryColumn]));
+        rows = counts[0];
+        bool valid = counts[kSummaryColumn] == numBlocks();
+        for (int i = 1; i < kSummaryColumn; i++) {
+                valid &= counts[i] == rows;
+        }
+        if (!valid) {
+                throw std::runtime_error(prefix + " has columns of different lengths");
+        }
+}
+
+HandArchive::Mapping::~Mapping() {
+        if (address != nullptr) {
+                munmap(address, size);
+        }
+}
+
+void HandArchive::remove(const std::string& prefix) {
+        for (const char* name : kColumnNames) {
+                std::remove((prefix + name).c_str());
+        }
+}
+
+const void* HandArchive::map(const std::string& prefix, int i, std::size_t size,
+        int64_t& count) {
+        std::string path = prefix + kColumnNames[i];
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+                throw std::runtime_error("can't open the column " + path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+                close(fd);
+                throw std::runtime_error(path + " is not a column");
+        }
+        Mapping& mapping = mappings[i];
+        mapping.size = info.st_size;
+        mapping.address = mmap(nullptr, mapping.size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapping.address == MAP_FAILED) {
+                mapping.address = nullptr;
+                throw std::runtime_error("can't map the column " + path);
+        }
+
+        Header header;
+        std::memcpy(&header, mapping.address, sizeof(header));
+        bool valid = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+                header.version == kVersion && header.valueSize == size &&
+                header.blockRows == kBlockRows &&
+                mapping.size == sizeof(Header) + header.count * size;
+        if (!valid) {
+                throw std::runtime_error(path + " is not a column");
+        }
+        count = header.count;
+        return static_cast<const char*>(mapping.address) + sizeof(Header);
+}
+
+QueryResult HandArchive::count(const HandQuery& query, int numThreads) const {
+        numThreads = resolveThreadCount(numThreads);
+        const Filter filter(query);
+        const bool avx2 = TrickKernels::getIsa() == TrickKernels::Isa::AVX2;
+        std::vector<QueryResult> perThread(numThreads);
+        parallelFor(0, numBlocks(), numThreads, 1, [&](int t, int64_t b) {
+                QueryResult& result = perThread[t];
+                if (filter.rulesOut(summaryColumn[b])) {
+                        result.blocksSkipped++;
+                        return;
+                }
+                result.blocksScanned++;
+                int64_t begin = b * kBlockRows;
+                int n = static_cast<int>(std::min<int64_t>(kBlockRows, rows - begin));
+                Columns columns = {bidderColumn + begin, bidColumn + begin, trumpColumn + begin,
+                        pointsColumn + begin, madeColumn + begin, bidderHandColumn + begin};
+                int done = avx2 ? countAvx2(columns, n, filter, result) : 0;
+                countScalar(columns, done, n, filter, result);
+        });
+
+        QueryResult total;
+        for (const QueryResult& result : perThread) {
+                total.matches += result.matches;
+                total.made += result.made;
+                total.blocksSkipped += result.blocksSkipped;
+                total.blocksScanned += result.blocksScanned;
+        }
+        return total;
+}
@@ -0,0 +1,130 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "cardSet.hpp"
+#include "handLog.hpp"
+#include "span.hpp"
+
+// Which hands a HandArchive query counts. A hand matches if it passes every test, and the
+// defaults let everything through
+struct HandQuery {
+        // the winning bid, and the points the bidding team took, are in [min, max]
+        int minBid = -128;
+        int maxBid = 127;
+        int minPoints = -128;
+        int maxPoints = 127;
+        // bit s is set for the seats (0-3) the bidder can be in, and bit trump - 1 for the trumps
+        uint8_t bidders = 0xF;
+        uint8_t trumps = 0xF;
+        // bit 0 lets through the bids that failed, bit 1 the ones that were made
+        uint8_t outcomes = 3;
+        // the bidder played every card of holds and none of lacks
+        CardSet bidderHolds;
+        CardSet bidderLacks;
+};
+
+struct QueryResult {
+        int64_t matches = 0;
+        // the matches where the bid was made
+        int64_t made = 0;
+        // blocks the summaries ruled out, and blocks that were read
+        int64_t blocksSkipped = 0;
+        int64_t blocksScanned = 0;
+
+        // the fraction of the matches that made their bid, 0 if there were none
+        double madeRate() const { return matches == 0 ? 0 : static_cast<double>(made) / matches; }
+};
+
+// Logged hands stored by column, for questions about millions of hands at once: each column is
+// its own file of one fixed width value per hand, so a query only reads the columns it tests.
+// The columns are the bidder, the bid, the trump, the points the bidding team took, whether the
+// bid was made, the 5 cards each seat played and the bidder's 5 cards again, so testing them
+// doesn't need the bidder column.
+// The hands are in blocks of kBlockRows, and a summary file has the smallest and largest bid and
+// points of every block, the bidders, trumps and outcomes in it, and the cards any and every
+// bidder held. A query skips the blocks the summary rules out, and tests the rest 32 hands at a
+// time with AVX2 (if TrickKernels::getIsa() allows it), on many threads.
+// The files are prefix + ".bidder", ".bidAmount", ".trump", ".points", ".made", ".hand0" to
+// ".hand3", ".bidderHand" and ".summary", each a 32 byte header and the values. They are mapped
+// with mmap, like EquityTable.
+class HandArchive {
+ public:
+        static constexpr int kBlockRows = 4096;
+
+        // the summary of a block of hands
+        struct BlockSummary {
+                int8_t minBid;
+                int8_t maxBid;
+                int8_t minPoints;
+                int8_t maxPoints;
+                // bit s for every bidder, bit trump - 1 for every trump, and bit made for every
+                // outcome (0 failed, 1 made) in the block
+                uint8_t bidders;
+                uint8_t trumps;
+                uint8_t outcomes;
+                uint8_t unused;
+                // the cards some bidder of the block held, and the cards every bidder held
+                uint64_t anyBidderCards;
+                uint64_t allBidderCards;
+        };
+        static_assert(sizeof(BlockSummary) == 24, "a block summary is 24 bytes");
+
+        // writes the records as an archive, working out the columns on numThreads threads.
+        // Throws std::runtime_error if a file can't be written
+        static void write(const std::string& prefix, Span<const HandRecord> records,
+                int numThreads);
+        // deletes the files of the archive, skipping any that aren't there
+        static void remove(const std::string& prefix);
+
+        // maps the files. Throws std::runtime_error if one can't be read, isn't a column or has
+        // the wrong number of hands
+        explicit HandArchive(const std::string& prefix);
+        HandArchive(const HandArchive&) = delete;
+        HandArchive& operator=(const HandArchive&) = delete;
+
+        int64_t size() const { return rows; }
+        int64_t numBlocks() const { return (rows + kBlockRows - 1) / kBlockRows; }
+        // counts the hands that match on numThreads threads (<= 0 uses every core)
+        QueryResult count(const HandQuery& query, int numThreads) const;
+
+        // the columns, indexed by hand
+        const uint8_t* bidders() const { return bidderColumn; }
+        const int8_t* bidAmounts() const { return bidColumn; }
+        const uint8_t* trumps() const { return trumpColumn; }
+        const int8_t* points() const { return pointsColumn; }
+        const uint8_t* made() const { return madeColumn; }
+        const uint64_t* hands(int seat) const { return handColumns[seat]; }
+        const uint64_t* bidderHands() const { return bidderHandColumn; }
+        const BlockSummary* summaries() const { return summaryColumn; }
+
+ private:
+        // unmaps itself, so the files mapped so far are let go if the constructor throws
+        struct Mapping {
+                void* address = nullptr;
+                std::size_t size = 0;
+
+                Mapping() = default;
+                ~Mapping();
+                Mapping(const Mapping&) = delete;
+                Mapping& operator=(const Mapping&) = delete;
+        };
+        // .bidder to .summary, in the order of kColumnNames in handArchive.cpp
+        std::array<Mapping, 11> mappings;
+        int64_t rows;
+
+        const uint8_t* bidderColumn;
+        const int8_t* bidColumn;
+        const uint8_t* trumpColumn;
+        const int8_t* pointsColumn;
+        const uint8_t* madeColumn;
+        const uint64_t* handColumns[4];
+        const uint64_t* bidderHandColumn;
+        const BlockSummary* summaryColumn;
+
+        // maps column i, whose values are size bytes, and returns them. Sets count to the number
+        // of values
+        const void* map(const std::string& prefix, int i, std::size_t size, int64_t& count);
+};
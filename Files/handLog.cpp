@@ -0,0 +1,192 @@
+// Copyright Andrew Bernal 2023
+#include "handLog.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "playPosition.hpp"
+
+namespace {
+// writes all of data to fd, unless the write fails
+bool writeAll(int fd, const char* data, std::size_t size) {
+        while (size > 0) {
+                ssize_t written = write(fd, data, size);
+                if (written < 0) {
+                        return false;
+                }
+                data += written;
+                size -= written;
+        }
+        return true;
+}
+}  // namespace
+
+int HandRecord::bidAmount() const {
+        return std::max(std::max(bids[0], bids[1]), std::max(bids[2], bids[3]));
+}
+
+CardSet HandRecord::firstHand(int seat) const {
+        CardSet hand;
+        for (int i = 5 * seat; i < 5 * seat + 5; i++) {
+                hand.insert(dealtCard(i));
+        }
+        return hand;
+}
+
+CardSet HandRecord::kiddie() const {
+        return CardSet(dealtCard(20), dealtCard(21), dealtCard(22));
+}
+
+CardSet HandRecord::kept(int seat) const {
+        CardSet cards;
+        for (int i = 0; i < kDealt; i++) {
+                int holder = i < 20 ? i / 5 : bidder();
+                if (holder == seat && (dealt[i] & kKept)) {
+                        cards.insert(dealtCard(i));
+                }
+        }
+        return cards;
+}
+
+std::array<CardSet, 4> HandRecord::playedHands() const {
+        std::array<CardSet, 4> hands;
+        PlayPosition position({}, trump(), bidder());
+        for (int i = 0; i < kPlays; i++) {
+                Card c = Card::fromIndex(plays[i]);
+                hands[position.toPlay()].insert(c);
+                position.play(c);
+        }
+        return hands;
+}
+
+std::array<int, 2> HandRecord::points() const {
+        std::array<int, 2> teamPoints = {0, 0};
+        PlayPosition position({}, trump(), bidder());
+        for (int i = 0; i < kPlays; i++) {
+                position.play(Card::fromIndex(plays[i]));
+                // the winner of a trick leads the next one
+                if (position.trickSize == 0) {
+                        teamPoints[position.leader % 2] += 5;
+                }
+        }
+        teamPoints[position.highCardPlayer % 2] += 5;
+        return teamPoints;
+}
+
+FixedVector<Card, Card::kNumCards> HandRecord::dealOrder() const {
+        FixedVector<Card, Card::kNumCards> order;
+        for (int i = 0; i < kDealt; i++) {
+                order.push_back(dealtCard(i));
+        }
+        std::array<CardSet, 4> hands = playedHands();
+        for (int seat = 0; seat < 4; seat++) {
+                uint64_t drawn = (hands[seat] - kept(seat)).getMask();
+                for (; drawn != 0; drawn &= drawn - 1) {
+                        order.push_back(Card::fromIndex(__builtin_ctzll(drawn)));
+                }
+        }
+        return order;
+}
+
+int HandLog::openForAppend(const std::string& path, int64_t& size) {
+        int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+                throw std::runtime_error("can't open the hand log " + path);
+        }
+        Header header = {};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.recordSize = sizeof(HandRecord);
+
+        struct stat info;
+        bool valid = fstat(fd, &info) == 0;
+        size = valid ? info.st_size : 0;
+        if (valid && size == 0) {
+                valid = writeAll(fd, reinterpret_cast<const char*>(&header), sizeof(header));
+                size = sizeof(header);
+        } else if (valid) {
+                Header existing;
+                valid = pread(fd, &existing, sizeof(existing), 0) ==
+                        static_cast<ssize_t>(sizeof(existing)) &&
+                        std::memcmp(&existing, &header, sizeof(header)) == 0;
+                // a record cut off by a writer that stopped partway is dropped, so the new
+                // records line up
+                int64_t torn = (size - static_cast<int64_t>(sizeof(header))) % sizeof(HandRecord);
+                if (valid && torn != 0) {
+                        size -= torn;
+                        valid = ftruncate(fd, size) == 0;
+                }
+        }
+        if (!valid || lseek(fd, size, SEEK_SET) != size) {
+                close(fd);
+                throw std::runtime_error(path + " is not a hand log");
+        }
+        return fd;
+}
+
+HandLogWriter::HandLogWriter(const std::string& inpPath) : path(inpPath) {
+        int64_t size;
+        fd = HandLog::openForAppend(path, size);
+        buffer.reserve(kBufferRecords);
+}
+
+HandLogWriter::~HandLogWriter() {
+        // a destructor can't throw, so records that can't be written are lost
+        writeAll(fd, reinterpret_cast<const char*>(buffer.data()),
+                buffer.size() * sizeof(HandRecord));
+        close(fd);
+}
+
+void HandLogWriter::append(const HandRecord& record) {
+        buffer.push_back(record);
+        if (static_cast<int>(buffer.size()) == kBufferRecords) {
+                flush();
+        }
+}
+
+void HandLogWriter::flush() {
+        bool written = writeAll(fd, reinterpret_cast<const char*>(buffer.data()),
+                buffer.size() * sizeof(HandRecord));
+        buffer.clear();
+        if (!written) {
+                throw std::runtime_error("can't write the hand log " + path);
+        }
+}
+
+HandLogReader::HandLogReader(const std::string& path) : mapping(nullptr), mappingSize(0) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+                throw std::runtime_error("can't open the hand log " + path);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(HandLog::Header))) {
+                close(fd);
+                throw std::runtime_error(path + " is not a hand log");
+        }
+        mappingSize = info.st_size;
+        mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+                throw std::runtime_error("can't map the hand log " + path);
+        }
+
+        HandLog::Header header;
+        std::memcpy(&header, mapping, sizeof(header));
+        bool valid = std::memcmp(header.magic, HandLog::kMagic, sizeof(HandLog::kMagic)) == 0 &&
+                header.version == HandLog::kVersion && header.recordSize == sizeof(HandRecord);
+        if (!valid) {
+                munmap(mapping, mappingSize);
+                throw std::runtime_error(path + " is not a hand log");
+        }
+        numRecords = (mappingSize - sizeof(header)) / sizeof(HandRecord);
+        records = reinterpret_cast<const HandRecord*>(static_cast<const char*>(mapping) +
+                sizeof(header));
+}
+
+HandLogReader::~HandLogReader() {
+        munmap(mapping, mappingSize);
+}
@@ -0,0 +1,134 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "card.hpp"
+#include "cardSet.hpp"
+#include "fixedVector.hpp"
+#include "suit.hpp"
+
+// Everything that happened in one hand, in 48 bytes of card indexes, for logging every hand a
+// table plays. The drawn cards, the points and the scores aren't stored: the cards after the
+// draw are the ones each seat played, and the points follow from the plays. The scores are the
+// sum of the hands since the last one that started a game.
+struct HandRecord {
+        static constexpr int kDealt = 23;
+        static constexpr int kPlays = 20;
+        // set on the cards in dealt that their holder kept when discarding
+        static constexpr uint8_t kKept = 0x80;
+
+        // the first 5 cards of seats 0 to 3 in the order they were dealt, then the kiddie
+        uint8_t dealt[kDealt];
+        // every card in the order it was played. The bidder leads the first trick
+        uint8_t plays[kPlays];
+        // the bids in the order they were made, from the left of the dealer. The dealer is last,
+        // with 15 if they were bagged
+        int8_t bids[4];
+        // bits 0-1 are the dealer, 2-3 the bidder, 4-5 the trump - 1, and bit 6 is set on the
+        // first hand of a game
+        uint8_t info;
+
+        int dealer() const { return info & 3; }
+        int bidder() const { return (info >> 2) & 3; }
+        Suit::Suit trump() const { return static_cast<Suit::Suit>(((info >> 4) & 3) + 1); }
+        bool startsGame() const { return (info >> 6) & 1; }
+        void setInfo(int inpDealer, int inpBidder, Suit::Suit inpTrump, bool inpStartsGame) {
+                info = static_cast<uint8_t>(inpDealer | (inpBidder << 2) | ((inpTrump - 1) << 4) |
+                        (inpStartsGame << 6));
+        }
+        // true if nobody bid before the dealer
+        bool bagged() const { return bids[0] <= 0 && bids[1] <= 0 && bids[2] <= 0; }
+        // the winning bid
+        int bidAmount() const;
+
+        // the ith card of dealt, without the kept flag
+        Card dealtCard(int i) const { return Card::fromIndex(dealt[i] & ~kKept); }
+        // the 5 cards seat was dealt first, and the 3 cards of the kiddie
+        CardSet firstHand(int seat) const;
+        CardSet kiddie() const;
+        // the cards seat kept from firstHand, and the kiddie if they won the bid
+        CardSet kept(int seat) const;
+        // the 5 cards each seat played from, after the draw
+        std::array<CardSet, 4> playedHands() const;
+        // the points each team took this hand, from the tricks and the high card
+        std::array<int, 2> points() const;
+        // every card the engine dealt, in the order it dealt them: the first hands, the kiddie and
+        // then the draw of seats 0 to 3. The cards of each draw are in index order
+        FixedVector<Card, Card::kNumCards> dealOrder() const;
+};
+static_assert(sizeof(HandRecord) == 48, "a hand record is 48 bytes");
+
+// Where basic_x45s sends the record of every hand it plays (see setHandLog)
+class HandLogSink {
+ public:
+        virtual ~HandLogSink() {}
+        virtual void append(const HandRecord& record) = 0;
+};
+
+// Appends hand records to a file. The file is a 16 byte header and then the records, so a log
+// can be read back with HandLogReader without parsing anything. Records are buffered and written
+// kBufferRecords at a time, and when the writer is destroyed.
+class HandLogWriter : public HandLogSink {
+ public:
+        static constexpr int kBufferRecords = 1024;
+
+        // creates the file, or opens it to add to the end if it is already a hand log. Throws
+        // std::runtime_error if it can't be opened or is some other file
+        explicit HandLogWriter(const std::string& path);
+        ~HandLogWriter() override;
+        HandLogWriter(const HandLogWriter&) = delete;
+        HandLogWriter& operator=(const HandLogWriter&) = delete;
+
+        void append(const HandRecord& record) override;
+        // writes the buffered records. Throws std::runtime_error if the write fails
+        void flush();
+
+ private:
+        int fd;
+        std::string path;
+        std::vector<HandRecord> buffer;
+};
+
+// A hand log mapped into memory with mmap, so the records are read in place. A record cut off at
+// the end of the file, by a writer that stopped in the middle of it, is left out.
+class HandLogReader {
+ public:
+        // throws std::runtime_error if the file can't be read or isn't a hand log
+        explicit HandLogReader(const std::string& path);
+        ~HandLogReader();
+        HandLogReader(const HandLogReader&) = delete;
+        HandLogReader& operator=(const HandLogReader&) = delete;
+
+        std::size_t size() const { return numRecords; }
+        const HandRecord& operator[](std::size_t i) const { return records[i]; }
+        const HandRecord* begin() const { return records; }
+        const HandRecord* end() const { return records + numRecords; }
+
+ private:
+        void* mapping;
+        std::size_t mappingSize;
+        std::size_t numRecords;
+        const HandRecord* records;
+};
+
+namespace HandLog {
+// the start of every hand log
+struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;
+};
+static_assert(sizeof(Header) == 16, "the header is 16 bytes");
+
+constexpr char kMagic[8] = {'4', '5', 's', 'H', 'A', 'N', 'D', '\0'};
+constexpr uint32_t kVersion = 1;
+
+// opens a hand log to add records to the end of it, and writes the header if the file is new. A
+// record cut off at the end is dropped. Returns the file descriptor, positioned at the end, and
+// sets size to the size of the file. Throws std::runtime_error if it can't be opened or is some
+// other file
+int openForAppend(const std::string& path, int64_t& size);
+}  // namespace HandLog
@@ -0,0 +1,74 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include "basicX45s.hpp"
+#include "card.hpp"
+#include "cardSet.hpp"
+#include "handLog.hpp"
+#include "player.hpp"
+#include "span.hpp"
+#include "suit.hpp"
+
+// Bids, discards and plays what its seat did in a HandRecord, so an engine of them plays a logged
+// hand again card for card
+class ReplayPlayer final : public Player {
+ public:
+        void setRecord(const HandRecord* inpRecord) { record = inpRecord; }
+
+        void discard() override {
+                CardSet kept = record->kept(seat);
+                for (auto it = hand.begin(); it != hand.end();) {
+                        it = kept.contains(*it) ? it + 1 : hand.erase(it);
+                }
+        }
+        // every bid is in the trump, only the winning one's matters
+        std::pair<int, Suit::Suit> getBid([[maybe_unused]] Span<const int> bidHistory) override {
+                return {record->bids[(seat - record->dealer() + 3) % 4], record->trump()};
+        }
+        Suit::Suit bagged() override {
+                return record->trump();
+        }
+        Card playCard(const TrickState& trick) override {
+                Card c = Card::fromIndex(record->plays[4 * trick.trickNumber + trick.size]);
+                for (auto it = hand.begin(); it != hand.end(); ++it) {
+                        if (*it == c) {
+                                hand.erase(it);
+                                break;
+                        }
+                }
+                return c;
+        }
+        void seated(int inpSeat) override {
+                seat = inpSeat;
+        }
+
+ private:
+        const HandRecord* record = nullptr;
+        int seat = 0;
+};
+
+using ReplayGame = basic_x45s<ReplayPlayer, ReplayPlayer, ReplayPlayer, ReplayPlayer>;
+
+// plays the hand in record again on game, and returns what dealBidAndFullFiveTricks returned. If
+// the record started a game, game starts a new one first, so replaying a log in order ends with
+// the scores of the game that wrote it. Throws std::invalid_argument if game's dealer isn't the
+// record's
+inline std::pair<int, bool> replayHand(ReplayGame& game, const HandRecord& record) {
+        if (record.startsGame()) {
+                game.newGame();
+        }
+        if (game.getState().dealer != record.dealer()) {
+                throw std::invalid_argument("the hand was dealt by player " +
+                        std::to_string(record.dealer()) + ", not player " +
+                        std::to_string(game.getState().dealer));
+        }
+        for (int i = 0; i < 4; i++) {
+                game.withPlayer(i, [&record](ReplayPlayer& p) { p.setRecord(&record); });
+        }
+        game.reset();
+        FixedVector<Card, Card::kNumCards> order = record.dealOrder();
+        game.stackDeck(Span<const Card>(order));
+        return game.dealBidAndFullFiveTricks();
+}
@@ -0,0 +1,152 @@
+// Copyright Andrew Bernal 2023
+#include "handTracker.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include "rules.hpp"
+
+namespace {
+// how many times a deal is tried with the voids before they are ignored
+constexpr int kDealAttempts = 16;
+}  // namespace
+
+CardSet takeRandom(CardSet& cards, int count, Xoshiro256StarStar& rng) {
+        // a partial Fisher-Yates shuffle on the stack, so searches can call this in their loops
+        Card pool[Card::kNumCards];
+        uint32_t size = 0;
+        for (Card c : cards) {
+                pool[size++] = c;
+        }
+        CardSet taken;
+        for (int i = 0; i < count; i++) {
+                uint32_t pick = i + boundedRandom(rng, size - i);
+                std::swap(pool[i], pool[pick]);
+                taken.insert(pool[i]);
+        }
+        cards -= taken;
+        return taken;
+}
+
+void HandTracker::bidWon(int inpBidder, Suit::Suit inpTrump) {
+        bidder = inpBidder;
+        trump = inpTrump;
+        known = PlayPosition({}, trump, bidder);
+        tricksDone = 0;
+        points[0] = 0;
+        points[1] = 0;
+        dead.clear();
+        for (auto& voids : excluded) {
+                voids.clear();
+        }
+        history.clear();
+}
+
+void HandTracker::trickPlayed(Span<const Card> cardsPlayed, int leader) {
+        const Card& led = cardsPlayed[leader];
+        for (int i = 1; i < 4; i++) {
+                int p = (leader + i) % 4;
+                inferVoids(excluded[p], led, cardsPlayed[p], trump);
+        }
+        // drop the part of the trick startDecision saw
+        while (static_cast<int>(history.size()) > 4 * tricksDone) {
+                history.pop_back();
+        }
+        // known has no hands, so playing the trick only moves the leader and the high card
+        known.leader = static_cast<int8_t>(leader);
+        known.trickSize = 0;
+        int teamZero = 0;
+        for (int i = 0; i < 4; i++) {
+                const Card& c = cardsPlayed[(leader + i) % 4];
+                teamZero += known.play(c);
+                dead.insert(c);
+                history.push_back(c);
+        }
+        points[0] += teamZero;
+        points[1] += 5 - teamZero;
+        tricksDone++;
+}
+
+void HandTracker::startDecision(Span<const Card> cardsPlayedThisHand, CardSet own) {
+        if (trump < Suit::HEARTS || trump > Suit::SPADES) {
+                throw std::invalid_argument("the tracker has to be told the trump with bidWon");
+        }
+        while (static_cast<int>(history.size()) > 4 * tricksDone) {
+                history.pop_back();
+        }
+        current = known;
+        current.trickSize = 0;
+        cantHave = excluded;
+        unknown = ~own - dead;
+        need = {own.size(), own.size(), own.size(), own.size()};
+        need[seat] = 0;
+        for (int i = 0; i < 4; i++) {
+                int p = (current.leader + i) % 4;
+                if (p == seat) {
+                        break;
+                }
+                const Card& c = cardsPlayedThisHand[p];
+                inferVoids(cantHave[p], current.led(), c, trump);
+                current.play(c);
+                unknown.remove(c);
+                history.push_back(c);
+                need[p]--;
+        }
+        current.hands[seat] = own;
+}
+
+void HandTracker::deal(PlayPosition& position, Xoshiro256StarStar& rng) const {
+        for (int attempt = 0; attempt < kDealAttempts; attempt++) {
+                if (tryDeal(position.hands, cantHave, rng)) {
+                        return;
+                }
+        }
+        if (!tryDeal(position.hands, {}, rng)) {
+                throw std::invalid_argument("the other hands can't be dealt");
+        }
+}
+
+bool HandTracker::tryDeal(std::array<CardSet, 4>& hands, const std::array<CardSet, 4>& voids,
+        Xoshiro256StarStar& rng) const {
+        // the player with the fewest spare cards to choose from goes first
+        std::array<int, 4> order = {0, 1, 2, 3};
+        std::sort(order.begin(), order.end(), [&](int lhs, int rhs) {
+                return (unknown - voids[lhs]).size() - need[lhs] <
+                        (unknown - voids[rhs]).size() - need[rhs];
+        });
+        CardSet left = unknown;
+        for (int p : order) {
+                if (p == seat) {
+                        continue;
+                }
+                CardSet available = left - voids[p];
+                if (available.size() < need[p]) {
+                        return false;
+                }
+                hands[p] = takeRandom(available, need[p], rng);
+                left -= hands[p];
+        }
+        return true;
+}
+
+void HandTracker::inferVoids(CardSet& voids, const Card& led, const Card& c,
+        Suit::Suit trumpSuit) {
+        if (!led.isValid() || !c.isValid() || c.isTrump(trumpSuit)) {
+                return;
+        }
+        if (!led.isTrump(trumpSuit)) {
+                // they didn't follow suit or trump, so they have none of the suit
+                if (c.getSuit() != led.getSuit()) {
+                        voids |= CardSet::followMask(led.getSuit(), trumpSuit);
+                }
+                return;
+        }
+        // they didn't play trump on trump, so the only trumps they can have are renegable ones
+        const CardRank::Row& strengths = CardRank::row(Suit::INVALID, trumpSuit);
+        int ledStrength = strengths[led.getIndex()];
+        for (Card t : CardSet::trumpMask(trumpSuit)) {
+                int s = strengths[t.getIndex()];
+                if (s < Rules::kRenegeStrength || s < ledStrength) {
+                        voids.insert(t);
+                }
+        }
+}
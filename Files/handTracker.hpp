@@ -0,0 +1,74 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <array>
+#include "card.hpp"
+#include "cardSet.hpp"
+#include "fixedVector.hpp"
+#include "playPosition.hpp"
+#include "random.hpp"
+#include "span.hpp"
+#include "suit.hpp"
+
+// removes count random cards from cards and returns them
+CardSet takeRandom(CardSet& cards, int count, Xoshiro256StarStar& rng);
+
+// What one player has seen of the hand being played, for computer players that search.
+// It is fed the Player observation calls, and works out which suits the other players are out
+// of when they don't follow suit. deal fills in the hands it can't see with a random deal that
+// agrees with all of that. It assumes every player holds 5 cards when the play starts.
+class HandTracker {
+ public:
+        static constexpr int kTricks = 5;
+
+        void seated(int inpSeat) { seat = inpSeat; }
+        // starts a new hand
+        void bidWon(int inpBidder, Suit::Suit inpTrump);
+        // the player's own discards, which nobody else can have
+        void discarded(CardSet cards) { dead |= cards; }
+        void trickPlayed(Span<const Card> cardsPlayed, int leader);
+
+        // sets up a decision of the player, who holds own, from the cards played to the current
+        // trick (indexed by player, like Player::playCard gets them)
+        void startDecision(Span<const Card> cardsPlayedThisHand, CardSet own);
+        // the current trick and the player's own hand. The other hands are empty
+        const PlayPosition& getPosition() const { return current; }
+        // fills the other hands of position with a random deal that agrees with what was seen.
+        // If the voids can't be met (someone didn't follow the rules) they are ignored
+        void deal(PlayPosition& position, Xoshiro256StarStar& rng) const;
+
+        int getSeat() const { return seat; }
+        // the bidder, who led the first trick
+        int getBidder() const { return bidder; }
+        Suit::Suit getTrump() const { return trump; }
+        // every card played this hand in order, including the current trick
+        Span<const Card> getHistory() const { return Span<const Card>(history); }
+        // the trick points team has taken so far, without the high card
+        int getPoints(int team) const { return points[team]; }
+
+        // marks the cards a player can't have after they played c to a trick started with led
+        static void inferVoids(CardSet& voids, const Card& led, const Card& c,
+                Suit::Suit trumpSuit);
+
+ private:
+        int seat = 0;
+        int bidder = 0;
+        Suit::Suit trump = Suit::INVALID;
+        // the finished tricks: who leads next and the high card so far. Its hands are empty
+        PlayPosition known;
+        int tricksDone = 0;
+        int points[2] = {0, 0};
+        // cards that are not in anyone's hand: the ones played and the ones the player discarded
+        CardSet dead;
+        // cards each player can't have
+        std::array<CardSet, 4> excluded;
+        FixedVector<Card, 4 * kTricks> history;
+
+        // set up by startDecision
+        PlayPosition current;
+        std::array<CardSet, 4> cantHave;
+        CardSet unknown;
+        std::array<int, 4> need = {};
+
+        bool tryDeal(std::array<CardSet, 4>& hands, const std::array<CardSet, 4>& voids,
+                Xoshiro256StarStar& rng) const;
+};
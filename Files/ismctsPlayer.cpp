@@ -0,0 +1,291 @@
+// Copyright Andrew Bernal 2023
+#include "ismctsPlayer.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include "parallel.hpp"
+#include "rules.hpp"
+
+namespace {
+// how often the clock is checked
+constexpr int kIterationsPerCheck = 32;
+// the deepest a path can be: every card of the hand
+constexpr int kMaxDepth = 4 * HandTracker::kTricks + 1;
+
+Card randomCard(CardSet cards, Xoshiro256StarStar& rng) {
+        return takeRandom(cards, 1, rng).lowest();
+}
+}  // namespace
+
+IsmctsPlayer::IsmctsPlayer(const Options& inpOptions)
+        : options(inpOptions), pool(inpOptions.pool), numThreads(0), lastIterations(0) {
+        if (options.iterations < 1) {
+                throw std::invalid_argument("IsmctsPlayer needs at least 1 iteration");
+        }
+        // every path down the tree has to fit, with room for the new node
+        if (options.nodesPerThread < kMaxDepth + 1) {
+                throw std::invalid_argument("IsmctsPlayer needs more nodes per thread");
+        }
+        if (pool == nullptr) {
+                ownPool = std::make_unique<ThreadPool>(options.numThreads);
+                pool = ownPool.get();
+        }
+        numThreads = pool->size();
+        SplitMix64 seeds(options.seed);
+        trees.resize(numThreads);
+        for (Tree& tree : trees) {
+                tree.nodes.reserve(options.nodesPerThread);
+                tree.rng.seed(seeds());
+        }
+}
+
+void IsmctsPlayer::resetHand() {
+        Player::resetHand();
+        for (Tree& tree : trees) {
+                tree.nodes.clear();
+                tree.current = -1;
+        }
+}
+
+int64_t IsmctsPlayer::getNodes() const {
+        int64_t nodes = 0;
+        for (const Tree& tree : trees) {
+                nodes += tree.nodes.size();
+        }
+        return nodes;
+}
+
+int IsmctsPlayer::trumpScore(CardSet cards, Suit::Suit suit) {
+        const CardRank::Row& strengths = CardRank::row(Suit::INVALID, suit);
+        int score = 0;
+        for (Card c : cards & CardSet::trumpMask(suit)) {
+                score += strengths[c.getIndex()] >= Rules::kRenegeStrength ? 2 : 1;
+        }
+        return score;
+}
+
+Suit::Suit IsmctsPlayer::bestSuit() const {
+        Suit::Suit best = Suit::HEARTS;
+        for (int s = Suit::DIAMONDS; s <= Suit::SPADES; s++) {
+                Suit::Suit suit = static_cast<Suit::Suit>(s);
+                if (trumpScore(getHandSet(), suit) > trumpScore(getHandSet(), best)) {
+                        best = suit;
+                }
+        }
+        return best;
+}
+
+std::pair<int, Suit::Suit> IsmctsPlayer::getBid(Span<const int> bidHistory) {
+        int highest = 0;
+        for (int bid : bidHistory) {
+                highest = std::max(highest, bid);
+        }
+        Suit::Suit suit = bestSuit();
+        // about a trick for every trump, and the top trumps are worth more
+        int bid = std::min(30, 5 * trumpScore(getHandSet(), suit));
+        bid -= bid % 5;
+        return {bid >= 15 && bid > highest ? bid : 0, suit};
+}
+
+Suit::Suit IsmctsPlayer::bagged() {
+        return bestSuit();
+}
+
+void IsmctsPlayer::discard() {
+        CardSet own = getHandSet();
+        Suit::Suit trump = tracker.getTrump();
+        CardSet keep;
+        if (own.size() <= 5) {
+                // not the bidder: keep the trumps and draw for the rest. Always keep a card
+                keep = own & CardSet::trumpMask(trump);
+                if (keep.empty() && !own.empty()) {
+                        keep.insert(own.lowest());
+                }
+        } else {
+                own.forEachByStrength(trump, [&keep](const Card& c) {
+                        if (keep.size() < 5) {
+                                keep.insert(c);
+                        }
+                });
+        }
+        tracker.discarded(own - keep);
+        Player::resetHand();
+        for (Card c : keep) {
+                dealCard(c);
+        }
+}
+
+int32_t IsmctsPlayer::addChild(Tree& tree, int32_t parent, const Card& move, int player) const {
+        if (static_cast<int>(tree.nodes.size()) == options.nodesPerThread) {
+                return -1;
+        }
+        int32_t child = static_cast<int32_t>(tree.nodes.size());
+        tree.nodes.emplace_back();
+        Node& node = tree.nodes.back();
+        node.move = move;
+        node.player = static_cast<int8_t>(player);
+        node.nextSibling = tree.nodes[parent].firstChild;
+        tree.nodes[parent].firstChild = child;
+        return child;
+}
+
+void IsmctsPlayer::findCurrent(Tree& tree) const {
+        Span<const Card> history = tracker.getHistory();
+        // a full arena is emptied, there is always room for the path
+        if (tree.nodes.empty() ||
+                static_cast<int>(tree.nodes.size() + history.size()) > options.nodesPerThread) {
+                tree.nodes.clear();
+                tree.nodes.emplace_back();
+        }
+        // the cards played so far, from the start of the hand
+        PlayPosition replay({}, tracker.getTrump(), tracker.getBidder());
+        int32_t node = 0;
+        for (const Card& c : history) {
+                int32_t child = tree.nodes[node].firstChild;
+                while (child != -1 && !(tree.nodes[child].move == c)) {
+                        child = tree.nodes[child].nextSibling;
+                }
+                if (child == -1) {
+                        child = addChild(tree, node, c, replay.toPlay());
+                }
+                replay.play(c);
+                node = child;
+        }
+        tree.current = node;
+}
+
+int64_t IsmctsPlayer::search(Tree& tree) const {
+        findCurrent(tree);
+        auto start = std::chrono::steady_clock::now();
+        int64_t done = 0;
+        while (done < options.iterations) {
+                iterate(tree);
+                done++;
+                if (done % kIterationsPerCheck == 0) {
+                        std::chrono::duration<double, std::milli> elapsed =
+                                std::chrono::steady_clock::now() - start;
+                        if (elapsed.count() >= options.timeBudgetMs) {
+                                break;
+                        }
+                }
+        }
+        return done;
+}
+
+void IsmctsPlayer::iterate(Tree& tree) const {
+        PlayPosition position = tracker.getPosition();
+        tracker.deal(position, tree.rng);
+        Suit::Suit trump = position.trump;
+
+        int32_t path[kMaxDepth + 1];
+        int depth = 0;
+        int32_t node = tree.current;
+        path[depth++] = node;
+        int teamZero = tracker.getPoints(0);
+
+        // selection and expansion: down the tree while every legal move has a node
+        bool expanded = false;
+        while (!expanded && position.tricksLeft() > 0) {
+                int player = position.toPlay();
+                CardSet legal = Rules::legalPlays(position.hands[player], position.led(), trump);
+                CardSet untried = legal;
+                int32_t best = -1;
+                double bestScore = -1;
+                for (int32_t child = tree.nodes[node].firstChild; child != -1;
+                        child = tree.nodes[child].nextSibling) {
+                        Node& candidate = tree.nodes[child];
+                        if (!legal.contains(candidate.move)) {
+                                continue;
+                        }
+                        untried.remove(candidate.move);
+                        candidate.available++;
+                        // a move on the path of a card played earlier may not have been visited
+                        double score = 2;
+                        if (candidate.visits > 0) {
+                                double mean = candidate.teamZeroPoints / (30.0 * candidate.visits);
+                                if (player % 2 == 1) {
+                                        mean = 1 - mean;
+                                }
+                                score = mean + options.exploration *
+                                        std::sqrt(std::log(candidate.available) / candidate.visits);
+                        }
+                        if (score > bestScore) {
+                                bestScore = score;
+                                best = child;
+                        }
+                }
+                Card move;
+                if (!untried.empty()) {
+                        move = randomCard(untried, tree.rng);
+                        best = addChild(tree, node, move, player);
+                        if (best == -1) {
+                                // the arena is full, so finish the hand without the tree
+                                break;
+                        }
+                        tree.nodes[best].available++;
+                        expanded = true;
+                } else {
+                        move = tree.nodes[best].move;
+                }
+                teamZero += position.play(move);
+                node = best;
+                path[depth++] = node;
+        }
+
+        // simulation: the rest of the hand is played at random
+        while (position.tricksLeft() > 0) {
+                CardSet legal = Rules::legalPlays(position.hands[position.toPlay()],
+                        position.led(), trump);
+                teamZero += position.play(randomCard(legal, tree.rng));
+        }
+        if (position.highCardPlayer % 2 == 0) {
+                teamZero += 5;
+        }
+
+        // the current node isn't a move that can be chosen, so it isn't updated
+        for (int i = 1; i < depth; i++) {
+                Node& visited = tree.nodes[path[i]];
+                visited.visits++;
+                visited.teamZeroPoints += teamZero;
+        }
+}
+
+Card IsmctsPlayer::playCard(const TrickState& trick) {
+        CardSet own = getHandSet();
+        tracker.startDecision(Span<const Card>(trick.cards), own);
+        const PlayPosition& current = tracker.getPosition();
+        CardSet legal = Rules::legalPlays(own, current.led(), current.trump);
+
+        Card choice = legal.lowest();
+        if (legal.size() > 1) {
+                std::vector<int64_t> iterations(numThreads);
+                pool->run([&](int t) {
+                        iterations[t] = search(trees[t]);
+                });
+                lastIterations = 0;
+                for (int64_t done : iterations) {
+                        lastIterations += done;
+                }
+
+                // the most visited move, over every tree
+                std::array<int64_t, Card::kNumCards> visits = {};
+                for (const Tree& tree : trees) {
+                        for (int32_t child = tree.nodes[tree.current].firstChild; child != -1;
+                                child = tree.nodes[child].nextSibling) {
+                                const Node& node = tree.nodes[child];
+                                visits[node.move.getIndex()] += node.visits;
+                        }
+                }
+                int64_t mostVisits = -1;
+                for (Card c : legal) {
+                        if (visits[c.getIndex()] > mostVisits) {
+                                mostVisits = visits[c.getIndex()];
+                                choice = c;
+                        }
+                }
+        }
+        hand.erase(std::find(hand.begin(), hand.end(), choice));
+        return choice;
+}
@@ -0,0 +1,115 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "card.hpp"
+#include "cardSet.hpp"
+#include "handTracker.hpp"
+#include "parallel.hpp"
+#include "player.hpp"
+#include "playPosition.hpp"
+#include "random.hpp"
+#include "span.hpp"
+#include "suit.hpp"
+
+// A computer player that plays with Information Set Monte Carlo Tree Search (single observer).
+// Every iteration deals the unseen cards at random (see HandTracker), walks down one tree of the
+// cards played, choosing with UCB among the moves that are legal in that deal, adds a node, plays
+// the rest of the hand at random and backs up team 0's points.
+// The tree is kept for the whole hand: each playCard walks down it along the cards played since
+// the last one, so the iterations from earlier tricks aren't thrown away.
+// It is root parallel: every thread has its own tree and the visits of the moves are added up
+// at the end, so the threads never wait for each other. The threads are a ThreadPool started
+// once for the player's lifetime. The nodes of every tree live in an arena
+// that is allocated once, when the player is made, and emptied in resetHand.
+// Bidding and discarding are simple rules, based on the trumps in hand.
+class IsmctsPlayer final : public Player {
+ public:
+        struct Options {
+                // iterations per thread for every card played
+                int iterations = 2000;
+                double timeBudgetMs = 10;
+                // <= 0 uses every core
+                int numThreads = 1;
+                uint64_t seed = 45;
+                // the UCB exploration constant, for rewards between 0 and 1
+                double exploration = 0.7;
+                // the arena of each thread. When it is full the tree stops growing
+                int nodesPerThread = 1 << 16;
+                // when set, the search runs on this pool's threads instead of numThreads threads
+                // of the player's own, e.g. a pool shared with a PimcPlayer. The pool has to
+                // outlive the player
+                ThreadPool* pool = nullptr;
+        };
+
+        IsmctsPlayer() : IsmctsPlayer(Options()) {}
+        explicit IsmctsPlayer(const Options& inpOptions);
+
+        void discard() override;
+        std::pair<int, Suit::Suit> getBid(Span<const int> bidHistory) override;
+        Suit::Suit bagged() override;
+        Card playCard(const TrickState& trick) override;
+        void resetHand() override;
+
+        void seated(int seat) override { tracker.seated(seat); }
+        void bidWon(int bidder, [[maybe_unused]] int amount, Suit::Suit trump) override {
+                tracker.bidWon(bidder, trump);
+        }
+        void trickPlayed(Span<const Card> cardsPlayed, int leader,
+                [[maybe_unused]] int winner) override {
+                tracker.trickPlayed(cardsPlayed, leader);
+        }
+
+        // the iterations run by every thread for the last card played
+        int64_t getLastIterations() const { return lastIterations; }
+        // the nodes in every tree
+        int64_t getNodes() const;
+
+ private:
+        struct Node {
+                // the card played to get here, and who played it
+                Card move;
+                int8_t player = -1;
+                // the children are a list through nextSibling. -1 is the end
+                int32_t firstChild = -1;
+                int32_t nextSibling = -1;
+                int32_t visits = 0;
+                // how many times this move was legal when its parent was searched
+                int32_t available = 0;
+                // the sum of team 0's points for the hand, over the visits
+                float teamZeroPoints = 0;
+        };
+
+        // one thread's tree
+        struct Tree {
+                // the arena. It is reserved up front and never grows past that
+                std::vector<Node> nodes;
+                // the node for the cards played so far
+                int32_t current = -1;
+                Xoshiro256StarStar rng;
+        };
+
+        Options options;
+        // the pool made for the player when the options don't give one
+        std::unique_ptr<ThreadPool> ownPool;
+        ThreadPool* pool;
+        int numThreads;
+        HandTracker tracker;
+        std::vector<Tree> trees;
+        int64_t lastIterations;
+
+        // the strength of the hand with each trump: the number of trumps, and 1 more for each of
+        // the top 3. Used for bidding
+        static int trumpScore(CardSet cards, Suit::Suit suit);
+        Suit::Suit bestSuit() const;
+
+        // a new node in tree, or -1 if the arena is full
+        int32_t addChild(Tree& tree, int32_t parent, const Card& move, int player) const;
+        // walks tree down the cards played this hand, adding the nodes that aren't there yet
+        void findCurrent(Tree& tree) const;
+        // runs iterations until the budget is used up. Returns how many
+        int64_t search(Tree& tree) const;
+        void iterate(Tree& tree) const;
+};
@@ -0,0 +1,191 @@
+// Copyright Andrew Bernal 2023
+#include "parallel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+// the part of the range a thread still has to do. The owner takes from the front,
+// thieves take from the back
+struct Slice {
+        std::mutex lock;
+        int64_t next;
+        int64_t end;
+};
+
+// takes up to grain indexes from the front of the slice. Returns false if it is empty
+bool takeFront(Slice& slice, int64_t grain, int64_t& first, int64_t& last) {
+        std::lock_guard<std::mutex> guard(slice.lock);
+        if (slice.next >= slice.end) {
+                return false;
+        }
+        first = slice.next;
+        last = std::min(slice.end, first + grain);
+        slice.next = last;
+        return true;
+}
+
+// moves the back half of the victim's slice, rounded up, into the thief's. Returns false if it was
+// empty
+bool steal(Slice& victim, Slice& thief) {
+        int64_t first, last;
+        {
+                std::lock_guard<std::mutex> guard(victim.lock);
+                int64_t remaining = victim.end - victim.next;
+                if (remaining <= 0) {
+                        return false;
+                }
+                first = victim.next + remaining / 2;
+                last = victim.end;
+                victim.end = first;
+        }
+        std::lock_guard<std::mutex> guard(thief.lock);
+        thief.next = first;
+        thief.end = last;
+        return true;
+}
+}  // namespace
+
+int resolveThreadCount(int numThreads) {
+        if (numThreads > 0) {
+                return numThreads;
+        }
+        return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+void parallelFor(int64_t begin, int64_t end, int numThreads, int64_t grain,
+        const std::function<void(int threadIndex, int64_t i)>& body) {
+        numThreads = resolveThreadCount(numThreads);
+        grain = std::max<int64_t>(grain, 1);
+        if (end <= begin) {
+                return;
+        }
+
+        std::vector<std::unique_ptr<Slice>> slices;
+        int64_t perThread = (end - begin + numThreads - 1) / numThreads;
+        for (int t = 0; t < numThreads; t++) {
+                slices.push_back(std::make_unique<Slice>());
+                slices[t]->next = std::min(end, begin + t * perThread);
+                slices[t]->end = std::min(end, begin + (t + 1) * perThread);
+        }
+
+        std::atomic<bool> failed(false);
+        std::exception_ptr error;
+        std::mutex errorLock;
+
+        auto worker = [&](int t) {
+                try {
+                        while (!failed) {
+                                int64_t first, last;
+                                if (takeFront(*slices[t], grain, first, last)) {
+                                        for (int64_t i = first; i < last; i++) {
+                                                body(t, i);
+                                        }
+                                        continue;
+                                }
+                                // our slice is empty, look for a thread that still has work
+                                bool stole = false;
+                                for (int offset = 1; offset < numThreads && !stole; offset++) {
+                                        Slice& victim = *slices[(t + offset) % numThreads];
+                                        stole = steal(victim, *slices[t]);
+                                }
+                                if (!stole) {
+                                        return;
+                                }
+                        }
+                } catch (...) {
+                        std::lock_guard<std::mutex> guard(errorLock);
+                        if (!error) {
+                                error = std::current_exception();
+                        }
+                        failed = true;
+                }
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 1; t < numThreads; t++) {
+                threads.emplace_back(worker, t);
+        }
+        // the calling thread is thread 0
+        worker(0);
+        for (auto& thread : threads) {
+                thread.join();
+        }
+        if (error) {
+                std::rethrow_exception(error);
+        }
+}
+
+ThreadPool::ThreadPool(int inpNumThreads) : numThreads(resolveThreadCount(inpNumThreads)) {
+        for (int t = 1; t < numThreads; t++) {
+                workers.emplace_back([this, t] { workLoop(t); });
+        }
+}
+
+ThreadPool::~ThreadPool() {
+        {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+        }
+        started.notify_all();
+        for (std::thread& worker : workers) {
+                worker.join();
+        }
+}
+
+void ThreadPool::run(const std::function<void(int threadIndex)>& body) {
+        std::lock_guard<std::mutex> turn(running);
+        {
+                std::lock_guard<std::mutex> lock(mutex);
+                job = &body;
+                generation++;
+                busy = numThreads - 1;
+                error = nullptr;
+        }
+        started.notify_all();
+        call(0);
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this] { return busy == 0; });
+        job = nullptr;
+        if (error) {
+                std::rethrow_exception(error);
+        }
+}
+
+void ThreadPool::workLoop(int threadIndex) {
+        uint64_t seen = 0;
+        while (true) {
+                {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        started.wait(lock, [this, seen] {
+                                return stopping || generation != seen;
+                        });
+                        if (stopping) {
+                                return;
+                        }
+                        seen = generation;
+                }
+                call(threadIndex);
+                {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        busy--;
+                }
+                finished.notify_one();
+        }
+}
+
+void ThreadPool::call(int threadIndex) {
+        try {
+                (*job)(threadIndex);
+        } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                        error = std::current_exception();
+                }
+        }
+}
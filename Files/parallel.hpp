@@ -0,0 +1,62 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs body(threadIndex, i) for every i in [begin, end) on numThreads threads.
+// Every thread starts with an equal slice of the range and takes grain indexes at a time from
+// the front of it. A thread that runs out steals the back half of another thread's slice, so a
+// thread with slow items doesn't hold up the others.
+// threadIndex is in [0, numThreads), so the body can keep its own state per thread.
+// numThreads <= 0 uses std::thread::hardware_concurrency(). The first exception thrown by the
+// body is rethrown after every thread has stopped.
+void parallelFor(int64_t begin, int64_t end, int numThreads, int64_t grain,
+        const std::function<void(int threadIndex, int64_t i)>& body);
+
+// the number of threads parallelFor uses for numThreads
+int resolveThreadCount(int numThreads);
+
+// Threads that are started once and then run one job after another, for callers that need many
+// short parallel jobs, like a player deciding every card. Starting threads for every job would
+// cost more than the job.
+// run(body) calls body(threadIndex) once on every thread and returns when they have all
+// returned. The calling thread is thread 0, so the pool starts numThreads - 1 threads.
+// Runs from different threads take turns. The first exception thrown by the body is rethrown
+// after every thread has returned.
+class ThreadPool {
+ public:
+        // numThreads <= 0 uses std::thread::hardware_concurrency()
+        explicit ThreadPool(int numThreads);
+        ~ThreadPool();
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        int size() const { return numThreads; }
+        void run(const std::function<void(int threadIndex)>& body);
+
+ private:
+        int numThreads;
+        std::vector<std::thread> workers;
+        // one run at a time
+        std::mutex running;
+
+        std::mutex mutex;
+        // the workers wait for a new job, and run waits for the workers to finish it
+        std::condition_variable started;
+        std::condition_variable finished;
+        const std::function<void(int)>* job = nullptr;
+        // counts the jobs, so a worker knows when there is a new one
+        uint64_t generation = 0;
+        int busy = 0;
+        bool stopping = false;
+        std::exception_ptr error;
+
+        void workLoop(int threadIndex);
+        // calls the job and keeps its first exception
+        void call(int threadIndex);
+};
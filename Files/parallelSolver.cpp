@@ -0,0 +1,100 @@
+// Copyright Andrew Bernal 2023
+#include "parallelSolver.hpp"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "parallel.hpp"
+#include "ranking.hpp"
+
+ParallelSolver::ParallelSolver(int inpNumThreads, int tableBits)
+        : numThreads(resolveThreadCount(inpNumThreads)), table(tableBits) {
+        for (int t = 0; t < numThreads; t++) {
+                solvers.push_back(std::make_unique<DoubleDummySolver>(table));
+                solvers[t]->setHelperIndex(t);
+        }
+}
+
+int ParallelSolver::solve(const PlayPosition& position) {
+        if (position.trump < Suit::HEARTS || position.trump > Suit::SPADES) {
+                throw std::invalid_argument("trump is not valid!");
+        }
+        if (numThreads == 1) {
+                return solvers[0]->solve(position);
+        }
+
+        std::atomic<bool> stop(false);
+        int result = 0;
+        auto work = [&](int t) {
+                solvers[t]->setStopFlag(&stop);
+                int value = solvers[t]->solve(position);
+                // only the first thread to finish wasn't stopped
+                if (!stop.exchange(true)) {
+                        result = value;
+                }
+                solvers[t]->setStopFlag(nullptr);
+        };
+        std::vector<std::thread> helpers;
+        for (int t = 1; t < numThreads; t++) {
+                helpers.emplace_back(work, t);
+        }
+        work(0);
+        for (auto& helper : helpers) {
+                helper.join();
+        }
+        return result;
+}
+
+int ParallelSolver::solve(const std::array<CardSet, 4>& hands, Suit::Suit trump, int leader) {
+        if (leader < 0 || leader > 3) {
+                throw std::invalid_argument("the leader must be 0, 1, 2 or 3");
+        }
+        return solve(PlayPosition(hands, trump, leader));
+}
+
+std::vector<DiscardOption> ParallelSolver::analyzeDiscards(const std::array<CardSet, 4>& hands,
+        int bidder, Suit::Suit trump) {
+        if (bidder < 0 || bidder > 3) {
+                throw std::invalid_argument("the bidder must be 0, 1, 2 or 3");
+        }
+        if (hands[bidder].size() < 5 || hands[bidder].size() > Ranking::kMaxCards) {
+                throw std::invalid_argument("the bidder needs 5 to " +
+                        std::to_string(Ranking::kMaxCards) + " cards");
+        }
+
+        // every subset of 5 of the bidder's cards, as a mask over the bidder's cards, in order
+        std::vector<Card> cards = hands[bidder].toVector();
+        std::vector<DiscardOption> options;
+        const uint64_t end = uint64_t{1} << cards.size();
+        for (uint64_t subset = 0x1F; subset < end;
+                subset = Ranking::nextCombination(CardSet(subset)).getMask()) {
+                CardSet keep;
+                for (uint64_t rest = subset; rest != 0; rest &= rest - 1) {
+                        keep.insert(cards[__builtin_ctzll(rest)]);
+                }
+                options.push_back({keep, 0});
+        }
+
+        int64_t numOptions = static_cast<int64_t>(options.size());
+        parallelFor(0, numOptions, numThreads, 1, [&](int t, int64_t i) {
+                std::array<CardSet, 4> dealt = hands;
+                dealt[bidder] = options[i].keep;
+                int teamZero = solvers[t]->solve(dealt, trump, bidder);
+                options[i].points = bidder % 2 == 0 ? teamZero : 30 - teamZero;
+        });
+
+        std::stable_sort(options.begin(), options.end(),
+                [](const DiscardOption& lhs, const DiscardOption& rhs) {
+                        return lhs.points > rhs.points;
+                });
+        return options;
+}
+
+int64_t ParallelSolver::getNodes() const {
+        int64_t nodes = 0;
+        for (const auto& solver : solvers) {
+                nodes += solver->getNodes();
+        }
+        return nodes;
+}
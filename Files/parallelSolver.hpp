@@ -0,0 +1,53 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "cardSet.hpp"
+#include "playPosition.hpp"
+#include "solver.hpp"
+#include "suit.hpp"
+#include "transpositionTable.hpp"
+
+// a way for the bidder to discard, and the points their team takes with it
+struct DiscardOption {
+        // the 5 cards the bidder keeps
+        CardSet keep;
+        // the points out of 30 the bidder's team takes with perfect play
+        int points;
+};
+
+// Double dummy search on many threads, with one transposition table shared by all of them.
+// solve uses Lazy SMP: every thread searches the same position with its own DoubleDummySolver,
+// the helpers in a different order, and they share what they find through the table. The first
+// thread to finish has the answer and stops the others.
+// analyzeDiscards solves one deal for every way the bidder can discard, with the discards handed
+// out to the threads by parallelFor, so it scales with the number of cores.
+class ParallelSolver {
+ public:
+        // numThreads <= 0 uses every core. The shared table has 2^tableBits entries of 16 bytes
+        explicit ParallelSolver(int numThreads = 0, int tableBits = 22);
+
+        // the same as DoubleDummySolver::solve
+        int solve(const PlayPosition& position);
+        int solve(const std::array<CardSet, 4>& hands, Suit::Suit trump, int leader);
+
+        // hands[bidder] has the bidder's hand and the kiddie (8 cards), the others have 5.
+        // Returns every way to keep 5 of the bidder's cards, with the points the bidder's team
+        // takes when the bidder leads the first trick, best first. Throws std::invalid_argument
+        // if the bidder has fewer than 5 or more than 8 cards
+        std::vector<DiscardOption> analyzeDiscards(const std::array<CardSet, 4>& hands,
+                int bidder, Suit::Suit trump);
+
+        int getNumThreads() const { return numThreads; }
+        // positions searched by every thread
+        int64_t getNodes() const;
+        void clearTable() { table.clear(); }
+
+ private:
+        int numThreads;
+        TranspositionTable table;
+        // one per thread, all sharing the table
+        std::vector<std::unique_ptr<DoubleDummySolver>> solvers;
+};
@@ -0,0 +1,276 @@
+// Copyright Andrew Bernal 2023
+#include "pimcPlayer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include "bidSampling.hpp"
+#include "parallel.hpp"
+#include "rules.hpp"
+
+namespace {
+// the points out of 30 seat's team takes when seat leads the first trick
+int solveForSeat(DoubleDummySolver& solver, const std::array<CardSet, 4>& hands,
+        Suit::Suit trump, int seat) {
+        int teamZero = solver.solve(hands, trump, seat);
+        return seat % 2 == 0 ? teamZero : 30 - teamZero;
+}
+}  // namespace
+
+PimcPlayer::PimcPlayer(const Options& inpOptions)
+        : options(inpOptions), pool(inpOptions.pool), numThreads(0), decisions(0), lastSamples(0),
+        table(inpOptions.tableBits) {
+        if (options.maxSamples < 1) {
+                throw std::invalid_argument("PimcPlayer needs at least 1 sample");
+        }
+        if (pool == nullptr) {
+                ownPool = std::make_unique<ThreadPool>(options.numThreads);
+                pool = ownPool.get();
+        }
+        numThreads = pool->size();
+        for (int t = 0; t < numThreads; t++) {
+                solvers.push_back(std::make_unique<DoubleDummySolver>(table));
+        }
+}
+
+Xoshiro256StarStar PimcPlayer::sampleGenerator(int64_t sample) const {
+        SplitMix64 mix(options.seed);
+        uint64_t seed = mix() ^ (decisions * 0x9E3779B97F4A7C15ULL);
+        return Xoshiro256StarStar(seed ^ static_cast<uint64_t>(sample));
+}
+
+template <class F>
+int PimcPlayer::runSamples(int maxSamples, F evaluate) {
+        auto start = std::chrono::steady_clock::now();
+        // the samples are taken in order, and every sample that is taken is solved, so the
+        // samples solved are always 0 to done - 1
+        std::atomic<int> next(0);
+        std::atomic<bool> timeUp(false);
+        pool->run([&](int t) {
+                while (!timeUp) {
+                        std::chrono::duration<double, std::milli> elapsed =
+                                std::chrono::steady_clock::now() - start;
+                        // the first sample is always solved
+                        if (next > 0 && elapsed.count() >= options.timeBudgetMs) {
+                                timeUp = true;
+                                return;
+                        }
+                        int sample = next++;
+                        if (sample >= maxSamples) {
+                                return;
+                        }
+                        evaluate(t, sample);
+                }
+        });
+        int done = std::min(next.load(), maxSamples);
+        decisions++;
+        lastSamples = done;
+        return done;
+}
+
+std::array<PimcPlayer::BidEstimate, 4> PimcPlayer::estimateBids() {
+        CardSet own = getHandSet();
+        int maxSamples = options.maxSamples;
+        // points[4 * sample + trump - 1], for the same deal with every trump
+        std::vector<int> points(4 * maxSamples);
+        int samples = runSamples(maxSamples, [&](int t, int64_t sample) {
+                Xoshiro256StarStar rng = sampleGenerator(sample);
+                std::array<int, 4> sampled = BidSampling::samplePoints(own, *solvers[t], rng);
+                std::copy(sampled.begin(), sampled.end(), points.begin() + 4 * sample);
+        });
+
+        std::array<BidEstimate, 4> estimates;
+        for (int s = Suit::HEARTS; s <= Suit::SPADES; s++) {
+                BidEstimate& estimate = estimates[s - 1];
+                estimate = {static_cast<Suit::Suit>(s), 0, {0, 0, 0, 0}, samples};
+                for (int i = 0; i < samples; i++) {
+                        int p = points[4 * i + s - 1];
+                        estimate.averagePoints += p;
+                        for (int b = 0; b < 4; b++) {
+                                estimate.made[b] += p >= 15 + 5 * b;
+                        }
+                }
+                estimate.averagePoints /= samples;
+        }
+        return estimates;
+}
+
+std::pair<int, Suit::Suit> PimcPlayer::getBid(Span<const int> bidHistory) {
+        int highest = 0;
+        for (int bid : bidHistory) {
+                highest = std::max(highest, bid);
+        }
+        if (options.equityTable != nullptr) {
+                return options.equityTable->bestBid(getHandSet(), highest, options.bidConfidence);
+        }
+        std::array<BidEstimate, 4> estimates = estimateBids();
+        const BidEstimate* best = &estimates[0];
+        for (const BidEstimate& estimate : estimates) {
+                if (estimate.averagePoints > best->averagePoints) {
+                        best = &estimate;
+                }
+        }
+        // the highest bid that is made often enough, in the suit that makes it most often
+        for (int b = 3; b >= 0 && 15 + 5 * b > highest; b--) {
+                const BidEstimate* surest = best;
+                for (const BidEstimate& estimate : estimates) {
+                        if (estimate.made[b] > surest->made[b]) {
+                                surest = &estimate;
+                        }
+                }
+                if (surest->made[b] >= options.bidConfidence * surest->samples) {
+                        return {15 + 5 * b, surest->trump};
+                }
+        }
+        return {0, best->trump};
+}
+
+Suit::Suit PimcPlayer::bagged() {
+        if (options.equityTable != nullptr) {
+                return options.equityTable->bestTrump(getHandSet());
+        }
+        std::array<BidEstimate, 4> estimates = estimateBids();
+        const BidEstimate* best = &estimates[0];
+        for (const BidEstimate& estimate : estimates) {
+                if (estimate.averagePoints > best->averagePoints) {
+                        best = &estimate;
+                }
+        }
+        return best->trump;
+}
+
+void PimcPlayer::discard() {
+        CardSet own = getHandSet();
+        CardSet trumps = CardSet::trumpMask(tracker.getTrump());
+        CardSet keep;
+        if (own.size() <= 5) {
+                // not the bidder: keep the trumps and draw for the rest. Always keep a card
+                keep = own & trumps;
+                if (keep.empty() && !own.empty()) {
+                        keep.insert(own.lowest());
+                }
+        } else {
+                keep = chooseKeep(own);
+        }
+        tracker.discarded(own - keep);
+        resetHand();
+        for (Card c : keep) {
+                dealCard(c);
+        }
+}
+
+CardSet PimcPlayer::chooseKeep(CardSet own) {
+        // the strongest trumps are always kept. The non-trumps of a suit all tie, so the only
+        // choice left is how many of each suit to keep
+        int seat = tracker.getSeat();
+        Suit::Suit trump = tracker.getTrump();
+        CardSet trumps;
+        own.forEachByStrength(trump, [&](const Card& c) {
+                if (c.isTrump(trump) && trumps.size() < 5) {
+                        trumps.insert(c);
+                }
+        });
+        std::vector<Card> others = (own - CardSet::trumpMask(trump)).toVector();
+        int spare = 5 - trumps.size();
+        std::vector<CardSet> keeps;
+        std::vector<uint32_t> signatures;
+        for (uint32_t subset = 0; subset < (uint32_t{1} << others.size()); subset++) {
+                if (__builtin_popcount(subset) != spare) {
+                        continue;
+                }
+                CardSet keep = trumps;
+                uint32_t signature = 0;
+                for (size_t i = 0; i < others.size(); i++) {
+                        if ((subset >> i) & 1) {
+                                keep.insert(others[i]);
+                                signature += uint32_t{1} << (4 * (others[i].getSuit() - 1));
+                        }
+                }
+                if (std::find(signatures.begin(), signatures.end(), signature) ==
+                        signatures.end()) {
+                        signatures.push_back(signature);
+                        keeps.push_back(keep);
+                }
+        }
+        if (keeps.size() == 1) {
+                return keeps[0];
+        }
+
+        int numKeeps = static_cast<int>(keeps.size());
+        std::vector<int> points(options.maxSamples * keeps.size());
+        int samples = runSamples(options.maxSamples, [&](int t, int64_t sample) {
+                Xoshiro256StarStar rng = sampleGenerator(sample);
+                CardSet unknown = ~own;
+                std::array<CardSet, 4> dealt;
+                for (int p = 0; p < 4; p++) {
+                        if (p != seat) {
+                                dealt[p] = takeRandom(unknown, 5, rng);
+                        }
+                }
+                BidSampling::redraw(dealt, seat, unknown, trump, rng);
+                for (int k = 0; k < numKeeps; k++) {
+                        dealt[seat] = keeps[k];
+                        points[sample * numKeeps + k] = solveForSeat(*solvers[t], dealt, trump,
+                                seat);
+                }
+        });
+        int best = 0;
+        int64_t bestTotal = -1;
+        for (int k = 0; k < numKeeps; k++) {
+                int64_t total = 0;
+                for (int i = 0; i < samples; i++) {
+                        total += points[i * numKeeps + k];
+                }
+                if (total > bestTotal) {
+                        bestTotal = total;
+                        best = k;
+                }
+        }
+        return keeps[best];
+}
+
+Card PimcPlayer::playCard(const TrickState& trick) {
+        CardSet own = getHandSet();
+        tracker.startDecision(Span<const Card>(trick.cards), own);
+        const PlayPosition& current = tracker.getPosition();
+        int seat = tracker.getSeat();
+
+        CardSet legal = Rules::legalPlays(own, current.led(), current.trump);
+        std::vector<Card> moves = legal.toVector();
+        Card choice = moves[0];
+        if (moves.size() > 1) {
+                int numMoves = static_cast<int>(moves.size());
+                // the points our team can still take: 5 for every trick and 5 for the high card
+                int total = 5 * own.size() + 5;
+                std::vector<int> points(options.maxSamples * moves.size());
+                int samples = runSamples(options.maxSamples, [&](int t, int64_t sample) {
+                        Xoshiro256StarStar rng = sampleGenerator(sample);
+                        PlayPosition position = current;
+                        tracker.deal(position, rng);
+                        for (int m = 0; m < numMoves; m++) {
+                                PlayPosition next = position;
+                                int teamZero = next.play(moves[m]);
+                                if (next.tricksLeft() > 0) {
+                                        teamZero += solvers[t]->solve(next);
+                                } else if (next.highCardPlayer % 2 == 0) {
+                                        teamZero += 5;
+                                }
+                                points[sample * numMoves + m] =
+                                        seat % 2 == 0 ? teamZero : total - teamZero;
+                        }
+                });
+                int64_t bestTotal = -1;
+                for (int m = 0; m < numMoves; m++) {
+                        int64_t sum = 0;
+                        for (int i = 0; i < samples; i++) {
+                                sum += points[i * numMoves + m];
+                        }
+                        if (sum > bestTotal) {
+                                bestTotal = sum;
+                                choice = moves[m];
+                        }
+                }
+        }
+        hand.erase(std::find(hand.begin(), hand.end(), choice));
+        return choice;
+}
@@ -0,0 +1,102 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "card.hpp"
+#include "cardSet.hpp"
+#include "equityTable.hpp"
+#include "handTracker.hpp"
+#include "parallel.hpp"
+#include "player.hpp"
+#include "random.hpp"
+#include "solver.hpp"
+#include "span.hpp"
+#include "suit.hpp"
+#include "transpositionTable.hpp"
+
+// A computer player that decides by Perfect Information Monte Carlo: it deals the cards it can't
+// see at random in ways that agree with what it has seen, solves every sample with the double
+// dummy solver, and picks the choice that does best on average.
+// It follows the hand with a HandTracker, so the samples agree with the cards that have been
+// played and the suits the other players are out of.
+// The samples are solved on the threads of a ThreadPool, started once for the player's lifetime.
+// Each decision stops after maxSamples samples or when its time budget is used up, whichever is
+// first: every thread checks the clock before it takes another sample.
+class PimcPlayer final : public Player {
+ public:
+        struct Options {
+                int maxSamples = 200;
+                double timeBudgetMs = 10;
+                // <= 0 uses every core
+                int numThreads = 1;
+                uint64_t seed = 45;
+                // bid the most points that are made in at least this fraction of the samples.
+                // Double dummy play sees every card, so the samples are optimistic
+                double bidConfidence = 0.9;
+                // the transposition table shared by the threads has 2^tableBits entries
+                int tableBits = 18;
+                // when set, bids come from the table instead of sampling.
+                // The table has to outlive the player
+                const EquityTable* equityTable = nullptr;
+                // when set, the samples are solved on this pool's threads instead of numThreads
+                // threads of the player's own. The pool has to outlive the player
+                ThreadPool* pool = nullptr;
+        };
+
+        PimcPlayer() : PimcPlayer(Options()) {}
+        explicit PimcPlayer(const Options& inpOptions);
+
+        void discard() override;
+        std::pair<int, Suit::Suit> getBid(Span<const int> bidHistory) override;
+        Suit::Suit bagged() override;
+        Card playCard(const TrickState& trick) override;
+
+        void seated(int seat) override { tracker.seated(seat); }
+        void bidWon(int bidder, [[maybe_unused]] int amount, Suit::Suit trump) override {
+                tracker.bidWon(bidder, trump);
+        }
+        void trickPlayed(Span<const Card> cardsPlayed, int leader,
+                [[maybe_unused]] int winner) override {
+                tracker.trickPlayed(cardsPlayed, leader);
+        }
+
+        // the number of samples solved for the last decision
+        int getLastSamples() const { return lastSamples; }
+
+ private:
+        // the points the player's team takes with each bid trump, over the samples
+        struct BidEstimate {
+                Suit::Suit trump;
+                double averagePoints;
+                // made[i] is how many samples made a bid of 15 + 5i
+                int made[4];
+                int samples;
+        };
+
+        Options options;
+        // the pool made for the player when the options don't give one
+        std::unique_ptr<ThreadPool> ownPool;
+        ThreadPool* pool;
+        int numThreads;
+        HandTracker tracker;
+        // one for every decision, so every decision gets different samples
+        uint64_t decisions;
+        int lastSamples;
+
+        TranspositionTable table;
+        // one per thread, sharing the table
+        std::vector<std::unique_ptr<DoubleDummySolver>> solvers;
+
+        // the generator for sample i of the current decision
+        Xoshiro256StarStar sampleGenerator(int64_t sample) const;
+        // solves samples until the budget is used up. evaluate(thread, sample) scores one sample
+        template <class F>
+        int runSamples(int maxSamples, F evaluate);
+        // deals the kiddie and the other hands, and solves them with every trump
+        std::array<BidEstimate, 4> estimateBids();
+        // the 5 of the bidder's 8 cards that take the most points on average
+        CardSet chooseKeep(CardSet own);
+};
@@ -0,0 +1,66 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <array>
+#include <cstdint>
+#include "card.hpp"
+#include "cardSet.hpp"
+#include "suit.hpp"
+#include "trick.hpp"
+
+// A position in the play phase of a hand, with every hand known.
+// Scoring is the same as the engine: 5 points for every trick, and 5 for the high card, which
+// is the strongest trick winner (compared with the suit led of the trick it is compared in).
+// It is trivially copyable, so searches can copy it instead of undoing moves.
+struct PlayPosition {
+        std::array<CardSet, 4> hands;
+        Suit::Suit trump = Suit::INVALID;
+        // the cards played to the current trick, in the order they were played
+        std::array<Card, 4> trick;
+        // the player who led (or is about to lead) the current trick
+        int8_t leader = 0;
+        int8_t trickSize = 0;
+        // the best trick winner so far. highCardPlayer is -1 until a trick has been won
+        int8_t highCardPlayer = -1;
+        Card highCard;
+
+        PlayPosition() = default;
+        // the start of the play phase. The leader is the bidder
+        PlayPosition(const std::array<CardSet, 4>& inpHands, Suit::Suit inpTrump, int inpLeader)
+                : hands(inpHands), trump(inpTrump), leader(static_cast<int8_t>(inpLeader)) {}
+
+        int toPlay() const {
+                return (leader + trickSize) % 4;
+        }
+        // the first card of the current trick, or a default Card if no card has been played
+        Card led() const {
+                return trickSize == 0 ? Card() : trick[0];
+        }
+        // tricks that haven't been won yet, including the current one
+        int tricksLeft() const {
+                return hands[toPlay()].size();
+        }
+
+        // plays c for the player to play. If it finishes the trick, the winner leads the next one.
+        // Returns the points team 0 got from the trick, which is 0 until the trick is finished
+        int play(const Card& c) {
+                if (c.isValid()) {
+                        hands[toPlay()].remove(c);
+                }
+                trick[trickSize++] = c;
+                if (trickSize < 4) {
+                        return 0;
+                }
+                Suit::Suit suitLed = trick[0].getSuit();
+                int position = trickWinner(trick.data(), suitLed, trump);
+                int winner = (leader + position) % 4;
+                const CardRank::Row& strengths = CardRank::row(suitLed, trump);
+                if (highCardPlayer < 0 || strengths[CardRank::slot(highCard)] <
+                        strengths[CardRank::slot(trick[position])]) {
+                        highCard = trick[position];
+                        highCardPlayer = static_cast<int8_t>(winner);
+                }
+                leader = static_cast<int8_t>(winner);
+                trickSize = 0;
+                return winner % 2 == 0 ? 5 : 0;
+        }
+};
@@ -4,18 +4,30 @@
 #include <string>
 #include <utility>
 #include "card.hpp"
+#include "cardSet.hpp"
+#include "fixedVector.hpp"
+#include "span.hpp"
 #include "suit.hpp"
+#include "trickState.hpp"
 // make each player sf::drawable
 // player is designed to be overriden by Computer and Human
 class Player {
+ public:
+        // the most cards a player can hold: 5 cards and the 3 card kiddie
+        static constexpr int kMaxHandSize = 8;
+        using Hand = FixedVector<Card, kMaxHandSize>;
+
  protected:
-        std::vector<Card> hand;
+        // the hand is stored inside the player, so dealing never allocates
+        Hand hand;
+        // the cards the player can play, set by the engine before every playCard
+        CardSet legalPlays;
 
  public:
         Player() {}
         template <class... Cards>
         explicit Player(Cards... cards) : hand{cards...} {}
-        explicit Player(std::vector<Card> inpHand) : hand(inpHand) {}
+        explicit Player(const std::vector<Card>& inpHand) : hand(inpHand.begin(), inpHand.end()) {}
         virtual ~Player() {}
         // add the card to the player's hand
         void dealCard(Card c) {
@@ -25,15 +37,51 @@ class Player {
         // the player must keep at least 1 card
         virtual void discard() = 0;
         // pair is bidAmount, suit
-        virtual std::pair<int, Suit::Suit> getBid(const std::vector<int>& bidHistory) = 0;
+        virtual std::pair<int, Suit::Suit> getBid(Span<const int> bidHistory) = 0;
         // the player is forced to bid
         virtual Suit::Suit bagged() = 0;
         // should return the card you want to play and remove it from your hand
-        virtual Card playCard(const std::vector<Card>& cardsPlayedThisHand) = 0;
+        // trick has the cards played so far by player, the suit led, who is winning and the
+        // cards played this hand. It has to be one of getLegalPlays(), or the engine throws
+        // std::invalid_argument
+        virtual Card playCard(const TrickState& trick) = 0;
+        // the engine calls this before every playCard, with the cards that follow the rules
+        void setLegalPlays(CardSet cards) { legalPlays = cards; }
+        CardSet getLegalPlays() const { return legalPlays; }
+
+        // The engine tells every player what they can see, so a player can keep track of the game.
+        // These do nothing unless they are overridden.
+        // the player's seat (0-3). Called once, when the game is made
+        virtual void seated([[maybe_unused]] int seat) {}
+        // the winning bid, after every bidding phase
+        virtual void bidWon([[maybe_unused]] int bidder, [[maybe_unused]] int amount,
+                [[maybe_unused]] Suit::Suit trump) {}
+        // every finished trick. cardsPlayed has a slot for each player
+        virtual void trickPlayed([[maybe_unused]] Span<const Card> cardsPlayed,
+                [[maybe_unused]] int leader, [[maybe_unused]] int winner) {}
+
         int getSize() {
                 return hand.size();
         }
-        void resetHand() {
+        // removes the last card of the hand that can be played, and returns it. The simplest
+        // legal playCard. The hand has to have a legal card
+        Card playLastLegalCard() {
+                for (auto it = hand.end(); it != hand.begin();) {
+                        --it;
+                        if (legalPlays.contains(*it)) {
+                                Card c = *it;
+                                hand.erase(it);
+                                return c;
+                        }
+                }
+                return Card();
+        }
+        // the cards in the hand as a set
+        CardSet getHandSet() const {
+                return CardSet(Span<const Card>(hand));
+        }
+        // called before every hand. Players that keep state for a hand can reset it here too
+        virtual void resetHand() {
                 hand.clear();
         }
         void printHand() {
@@ -51,3 +99,32 @@ class Player {
                 return out;
         }
 };
+
+// Forwards every call to a Player through its virtual functions.
+// x45s is basic_x45s with four PlayerRefs, so any Player can be used at runtime.
+class PlayerRef {
+        Player* player;
+
+ public:
+        explicit PlayerRef(Player* inpPlayer) : player(inpPlayer) {}
+        Player& get() const { return *player; }
+
+        void dealCard(Card c) { player->dealCard(c); }
+        void discard() { player->discard(); }
+        std::pair<int, Suit::Suit> getBid(Span<const int> bidHistory) {
+                return player->getBid(bidHistory);
+        }
+        Suit::Suit bagged() { return player->bagged(); }
+        Card playCard(const TrickState& trick) { return player->playCard(trick); }
+        void setLegalPlays(CardSet cards) { player->setLegalPlays(cards); }
+        void seated(int seat) { player->seated(seat); }
+        void bidWon(int bidder, int amount, Suit::Suit trump) {
+                player->bidWon(bidder, amount, trump);
+        }
+        void trickPlayed(Span<const Card> cardsPlayed, int leader, int winner) {
+                player->trickPlayed(cardsPlayed, leader, winner);
+        }
+        int getSize() { return player->getSize(); }
+        CardSet getHandSet() const { return player->getHandSet(); }
+        void resetHand() { player->resetHand(); }
+};
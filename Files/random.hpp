@@ -0,0 +1,93 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <cstdint>
+#include <limits>
+#include <random>
+
+// splitmix64, used to turn a single 64 bit seed into the state of a bigger generator
+class SplitMix64 {
+        uint64_t state;
+
+ public:
+        explicit SplitMix64(uint64_t seed) : state(seed) {}
+        uint64_t operator()() {
+                uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                return z ^ (z >> 31);
+        }
+};
+
+// xoshiro256** by Blackman and Vigna. A small, fast generator that satisfies
+// UniformRandomBitGenerator, so it works with std::shuffle and the std distributions too.
+// Two generators with different seeds give independent streams, so every thread can have its own.
+class Xoshiro256StarStar {
+        uint64_t s[4];
+
+        static uint64_t rotl(uint64_t x, int k) {
+                return (x << k) | (x >> (64 - k));
+        }
+
+ public:
+        using result_type = uint64_t;
+
+        explicit Xoshiro256StarStar(uint64_t inpSeed = 0) {
+                seed(inpSeed);
+        }
+
+        void seed(uint64_t inpSeed) {
+                // the state can't be all 0s, splitmix64 never gives 4 zeros in a row
+                SplitMix64 sm(inpSeed);
+                for (auto& word : s) {
+                        word = sm();
+                }
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+        result_type operator()() {
+                uint64_t result = rotl(s[1] * 5, 7) * 9;
+                uint64_t t = s[1] << 17;
+                s[2] ^= s[0];
+                s[3] ^= s[1];
+                s[1] ^= s[2];
+                s[0] ^= s[3];
+                s[2] ^= t;
+                s[3] = rotl(s[3], 45);
+                return result;
+        }
+};
+
+// a seed for when the caller doesn't give one. Different on every call, even in the same second
+inline uint64_t randomSeed() {
+        std::random_device rd;
+        return (uint64_t{rd()} << 32) ^ rd();
+}
+
+// Returns a uniform random integer in [0, range), range > 0, starting from word, a random 32 bit
+// number the caller already has (e.g. half of a 64 bit one). g is only called when word lands in
+// the small biased zone. The generator must give at least 32 random bits.
+template <class URBG>
+uint32_t boundedRandom(URBG& g, uint32_t range, uint32_t word) {
+        static_assert(URBG::max() - URBG::min() >= 0xFFFFFFFFULL,
+                "boundedRandom needs a generator with at least 32 bits");
+        uint64_t product = uint64_t{word} * range;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < range) {
+                uint32_t threshold = -range % range;
+                while (low < threshold) {
+                        product = uint64_t{static_cast<uint32_t>(g() - URBG::min())} * range;
+                        low = static_cast<uint32_t>(product);
+                }
+        }
+        return static_cast<uint32_t>(product >> 32);
+}
+
+// Returns a uniform random integer in [0, range), range > 0.
+// Lemire's multiply and shift method: no division unless the first draw lands in the
+// small biased zone, and no modulo bias. The generator must give at least 32 random bits.
+template <class URBG>
+uint32_t boundedRandom(URBG& g, uint32_t range) {
+        return boundedRandom(g, range, static_cast<uint32_t>(g() - URBG::min()));
+}
@@ -0,0 +1,185 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include "card.hpp"
+#include "cardSet.hpp"
+#include "parallel.hpp"
+
+// Bijections between sets of cards and dense integers, for indexing tables and storing deals.
+// A set of k cards is ranked in colex order: sets are compared by their highest card index, then
+// the next highest, and so on. The rank of the cards c1 < c2 < ... < ck is
+// choose(c1, 1) + choose(c2, 2) + ... + choose(ck, k): one table lookup for every set bit.
+// The next set in colex order is the next larger mask with the same number of bits.
+// The "within" versions rank a set among the cards of another set, by the cards' positions in it.
+// That is how a deal is ranked: each hand among the cards the hands before it left.
+namespace Ranking {
+        // the most cards in a ranked set: a hand and the kiddie
+        constexpr int kMaxCards = 8;
+
+        struct Binomials {
+                uint64_t choose[Card::kNumCards + 1][kMaxCards + 1];
+        };
+        constexpr Binomials buildBinomials() {
+                Binomials b{};
+                for (int n = 0; n <= Card::kNumCards; n++) {
+                        b.choose[n][0] = 1;
+                        for (int k = 1; k <= kMaxCards; k++) {
+                                b.choose[n][k] = n == 0 ? 0 :
+                                        b.choose[n - 1][k - 1] + b.choose[n - 1][k];
+                        }
+                }
+                return b;
+        }
+        inline constexpr Binomials kBinomials = buildBinomials();
+
+        // n choose k, for n <= 52 and k <= 8
+        constexpr uint64_t choose(int n, int k) {
+                return kBinomials.choose[n][k];
+        }
+
+        // 5 card hands, and 8 card hands (a hand and the kiddie)
+        constexpr uint64_t kNumHands = choose(Card::kNumCards, 5);
+        constexpr uint64_t kNumKiddieHands = choose(Card::kNumCards, 8);
+
+        // the position of cards among all the sets with as many cards. cards has at most 8 cards
+        inline uint64_t rank(CardSet cards) {
+                uint64_t result = 0;
+                int k = 1;
+                for (uint64_t m = cards.getMask(); m != 0; m &= m - 1) {
+                        result += choose(__builtin_ctzll(m), k++);
+                }
+                return result;
+        }
+
+        // the set of k cards at rank. rank < choose(52, k)
+        inline CardSet unrank(uint64_t index, int k) {
+                uint64_t mask = 0;
+                int n = Card::kNumCards - 1;
+                for (; k >= 1; k--) {
+                        // the highest card left is the largest n with choose(n, k) <= index
+                        while (choose(n, k) > index) {
+                                n--;
+                        }
+                        mask |= uint64_t{1} << n;
+                        index -= choose(n, k);
+                        n--;
+                }
+                return CardSet(mask);
+        }
+
+        // cards ranked by their positions in among. cards is a subset of among
+        inline uint64_t rankWithin(CardSet cards, CardSet among) {
+                uint64_t result = 0;
+                int k = 1;
+                uint64_t amongMask = among.getMask();
+                for (uint64_t m = cards.getMask(); m != 0; m &= m - 1) {
+                        // the cards of among below this card
+                        uint64_t below = amongMask & ((m & -m) - 1);
+                        result += choose(__builtin_popcountll(below), k++);
+                }
+                return result;
+        }
+
+        // the k cards of among at rank, the opposite of rankWithin
+        inline CardSet unrankWithin(uint64_t index, int k, CardSet among) {
+                uint64_t positions = unrank(index, k).getMask();
+                // the cards of among at those positions, lowest first
+                uint64_t mask = 0;
+                uint64_t amongMask = among.getMask();
+                int position = 0;
+                for (; positions != 0; positions &= positions - 1) {
+                        int next = __builtin_ctzll(positions);
+                        for (; position < next; position++) {
+                                amongMask &= amongMask - 1;
+                        }
+                        mask |= amongMask & -amongMask;
+                }
+                return CardSet(mask);
+        }
+
+        // the set after cards in colex order, which has rank(cards) + 1.
+        // Gosper's hack: the next larger mask with the same number of bits
+        inline CardSet nextCombination(CardSet cards) {
+                uint64_t mask = cards.getMask();
+                uint64_t lowest = mask & -mask;
+                uint64_t ripple = mask + lowest;
+                return CardSet((((ripple ^ mask) >> 2) / lowest) | ripple);
+        }
+
+        // Deals are numbered with 128 bit integers: there are about 7.2 * 10^24 of them
+        __extension__ typedef unsigned __int128 DealRank;
+
+        // four 5 card hands and the 3 card kiddie. The other 29 cards are still in the deck
+        struct Deal {
+                std::array<CardSet, 4> hands;
+                CardSet kiddie;
+        };
+
+        constexpr DealRank kNumDeals = DealRank{choose(52, 5)} * choose(47, 5) * choose(42, 5) *
+                choose(37, 5) * choose(32, 3);
+
+        // the deal's number: the rank of hand 0 among all the cards, then of hand 1 among the
+        // cards left, ..., then the kiddie, as the digits of a mixed radix number
+        inline DealRank rankDeal(const Deal& deal) {
+                CardSet left = CardSet::all();
+                DealRank result = 0;
+                for (const CardSet& hand : deal.hands) {
+                        result = result * choose(left.size(), 5) + rankWithin(hand, left);
+                        left -= hand;
+                }
+                return result * choose(left.size(), 3) + rankWithin(deal.kiddie, left);
+        }
+
+        inline Deal unrankDeal(DealRank index) {
+                // the digits come out last first, so work out each one's base and place
+                uint64_t bases[5] = {choose(52, 5), choose(47, 5), choose(42, 5), choose(37, 5),
+                        choose(32, 3)};
+                uint64_t digits[5];
+                for (int i = 4; i >= 0; i--) {
+                        digits[i] = static_cast<uint64_t>(index % bases[i]);
+                        index /= bases[i];
+                }
+                Deal deal;
+                CardSet left = CardSet::all();
+                for (int i = 0; i < 4; i++) {
+                        deal.hands[i] = unrankWithin(digits[i], 5, left);
+                        left -= deal.hands[i];
+                }
+                deal.kiddie = unrankWithin(digits[4], 3, left);
+                return deal;
+        }
+
+        // calls f(rank, cards) for every set of k cards with a rank in [begin, end), in order
+        template <class F>
+        void forEachCombination(int k, uint64_t begin, uint64_t end, F f) {
+                if (begin >= end) {
+                        return;
+                }
+                CardSet cards = unrank(begin, k);
+                for (uint64_t index = begin; index < end; index++) {
+                        f(index, cards);
+                        cards = nextCombination(cards);
+                }
+        }
+
+        // the same on numThreads threads, f(threadIndex, rank, cards). The ranks are cut into
+        // blocks, and each block unranks its first set and then steps through the rest
+        template <class F>
+        void parallelForEachCombination(int k, uint64_t begin, uint64_t end, int numThreads,
+                F f) {
+                if (k < 1 || k > kMaxCards || begin > end || end > choose(Card::kNumCards, k)) {
+                        throw std::invalid_argument("the ranks are out of range");
+                }
+                constexpr uint64_t kBlock = 4096;
+                int64_t blocks = static_cast<int64_t>((end - begin + kBlock - 1) / kBlock);
+                parallelFor(0, blocks, numThreads, 1, [&](int t, int64_t block) {
+                        uint64_t first = begin + block * kBlock;
+                        uint64_t last = first + kBlock < end ? first + kBlock : end;
+                        forEachCombination(k, first, last, [&](uint64_t index, CardSet cards) {
+                                f(t, index, cards);
+                        });
+                });
+        }
+}
@@ -0,0 +1,73 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include "card.hpp"
+#include "cardSet.hpp"
+#include "suit.hpp"
+
+// The rules for which cards a player may play.
+// When trump is led (the ace of hearts is always trump), a player with trump has to play trump.
+// The 5, the jack of trump and the ace of hearts can be reneged: they don't have to be played
+// when the trump led is lower than them. When another suit is led, a player who has that suit
+// has to follow suit or play trump. Otherwise anything can be played.
+namespace Rules {
+        // trumps at least this strong (the 5, the jack and the ace of hearts) can be reneged
+        constexpr int kRenegeStrength = 13;
+
+        // What a led card obliges a player to do: if they hold any of the obliging cards, they
+        // have to play one of the allowed cards. Otherwise they can play anything
+        struct Obligation {
+                uint64_t obliging;
+                uint64_t allowed;
+        };
+        // indexed by [trump - 1][index of the led card]
+        using ObligationTable = std::array<std::array<Obligation, Card::kNumCards>, 4>;
+
+        constexpr ObligationTable buildObligations() {
+                ObligationTable table{};
+                for (int trump = Suit::HEARTS; trump <= Suit::SPADES; trump++) {
+                        Suit::Suit t = static_cast<Suit::Suit>(trump);
+                        uint64_t trumps = CardSet::trumpMask(t).getMask();
+                        const CardRank::Row& strengths = CardRank::kStrength[trump - 1][0];
+                        for (int led = 0; led < Card::kNumCards; led++) {
+                                Obligation& o = table[trump - 1][led];
+                                if ((trumps >> led) & 1) {
+                                        // the trumps that have to be played if the player has
+                                        // no others
+                                        for (int c = 0; c < Card::kNumCards; c++) {
+                                                int s = strengths[c];
+                                                if (((trumps >> c) & 1) && (s < kRenegeStrength ||
+                                                        s < strengths[led])) {
+                                                        o.obliging |= uint64_t{1} << c;
+                                                }
+                                        }
+                                        o.allowed = trumps;
+                                } else {
+                                        Suit::Suit suit = static_cast<Suit::Suit>(led / 13 + 1);
+                                        o.obliging = CardSet::followMask(suit, t).getMask();
+                                        o.allowed = o.obliging | trumps;
+                                }
+                        }
+                }
+                return table;
+        }
+
+        inline constexpr ObligationTable kObligations = buildObligations();
+
+        // the cards in hand that can be played to a trick started with led: one table load and a
+        // few mask operations. Pass a default Card as led when the player is leading.
+        // Throws if trump is invalid
+        inline CardSet legalPlays(CardSet hand, const Card& led, Suit::Suit trump) {
+                if (!led.isValid()) {
+                        return hand;
+                }
+                if (trump < Suit::HEARTS || trump > Suit::SPADES) {
+                        throw std::invalid_argument("trump is not valid!");
+                }
+                const Obligation& o = kObligations[trump - 1][led.getIndex()];
+                uint64_t cards = hand.getMask();
+                return CardSet((cards & o.obliging) != 0 ? cards & o.allowed : cards);
+        }
+}
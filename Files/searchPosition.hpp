@@ -0,0 +1,190 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <array>
+#include <cstdint>
+#include "card.hpp"
+#include "cardSet.hpp"
+#include "fixedVector.hpp"
+#include "playPosition.hpp"
+#include "suit.hpp"
+#include "trick.hpp"
+
+// Random keys for Zobrist hashing. The hash of a position is the xor of the keys of its parts,
+// so a move only has to xor in and out the keys of what it changes.
+namespace Zobrist {
+        struct Keys {
+                // a card in a player's hand, [player][card index]
+                uint64_t hand[4][Card::kNumCards];
+                // a card in the current trick, [position in the trick][card slot]
+                uint64_t trick[4][Card::kNumCards + 1];
+                uint64_t leader[4];
+                // the high card so far. Slot 52 is no high card
+                uint64_t highCard[Card::kNumCards + 1];
+                // the team with the high card, +1. 0 is no high card
+                uint64_t highTeam[3];
+                uint64_t trump[5];
+        };
+
+        constexpr Keys buildKeys() {
+                Keys keys{};
+                uint64_t state = 0x45;
+                // splitmix64, written out so it runs at compile time
+                auto next = [&state]() {
+                        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+                        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                        return z ^ (z >> 31);
+                };
+                for (auto& player : keys.hand) {
+                        for (uint64_t& key : player) {
+                                key = next();
+                        }
+                }
+                for (auto& position : keys.trick) {
+                        for (uint64_t& key : position) {
+                                key = next();
+                        }
+                }
+                for (uint64_t& key : keys.leader) {
+                        key = next();
+                }
+                for (uint64_t& key : keys.highCard) {
+                        key = next();
+                }
+                for (uint64_t& key : keys.highTeam) {
+                        key = next();
+                }
+                for (uint64_t& key : keys.trump) {
+                        key = next();
+                }
+                return keys;
+        }
+
+        inline constexpr Keys kKeys = buildKeys();
+}
+
+// A PlayPosition that is searched by playing cards and taking them back, instead of copying it.
+// It keeps the points each team has taken (5 a trick, and 5 for the high card once every hand is
+// empty) and a 64 bit Zobrist hash of the position, which is updated with every move.
+// The hash covers the hands, the trick in progress, the leader, the high card, the team holding
+// it and the trump, but not the points, so positions that only differ in the points taken so
+// far have the same hash.
+class SearchPosition {
+ public:
+        // the most cards that can be played before they are taken back
+        static constexpr int kMaxMoves = 32;
+
+        explicit SearchPosition(const PlayPosition& inpPosition)
+                : position(inpPosition), points{0, 0}, hash(fullHash(inpPosition)) {}
+
+        const PlayPosition& getPosition() const { return position; }
+        uint64_t getHash() const { return hash; }
+        // the points the team has taken since the position was made
+        int getPoints(int team) const { return points[team]; }
+        // the suit of the first card of the trick, or INVALID if no card has been played
+        Suit::Suit suitLed() const { return position.led().getSuit(); }
+        int movesMade() const { return static_cast<int>(history.size()); }
+
+        // plays c, which must be in the hand of the player to play
+        void makeMove(const Card& c) {
+                int player = position.toPlay();
+                int slot = position.trickSize;
+                history.push_back(Undo{hash, {points[0], points[1]}, position.trick[slot],
+                        position.highCard, position.leader, position.highCardPlayer});
+
+                position.hands[player].remove(c);
+                position.trick[slot] = c;
+                position.trickSize++;
+                hash ^= Zobrist::kKeys.hand[player][c.getIndex()] ^
+                        Zobrist::kKeys.trick[slot][c.getIndex()];
+                if (position.trickSize == 4) {
+                        finishTrick();
+                }
+        }
+
+        // takes back the last card played
+        void unmakeMove() {
+                const Undo& undo = history.back();
+                int slot = position.trickSize == 0 ? 3 : position.trickSize - 1;
+                // the leader is the player who led the trick the card was played to
+                position.leader = undo.leader;
+                position.trickSize = static_cast<int8_t>(slot);
+                Card c = position.trick[slot];
+                position.hands[position.toPlay()].insert(c);
+                position.trick[slot] = undo.overwritten;
+                position.highCard = undo.highCard;
+                position.highCardPlayer = undo.highCardPlayer;
+                points[0] = undo.points[0];
+                points[1] = undo.points[1];
+                hash = undo.hash;
+                history.pop_back();
+        }
+
+        // the hash of a position, computed from scratch
+        static uint64_t fullHash(const PlayPosition& p) {
+                const Zobrist::Keys& keys = Zobrist::kKeys;
+                uint64_t h = keys.leader[p.leader] ^ keys.trump[p.trump] ^
+                        keys.highCard[p.highCardPlayer < 0 ? Card::kNumCards :
+                                CardRank::slot(p.highCard)] ^
+                        keys.highTeam[p.highCardPlayer < 0 ? 0 : 1 + p.highCardPlayer % 2];
+                for (int player = 0; player < 4; player++) {
+                        for (Card c : p.hands[player]) {
+                                h ^= keys.hand[player][c.getIndex()];
+                        }
+                }
+                for (int i = 0; i < p.trickSize; i++) {
+                        h ^= keys.trick[i][CardRank::slot(p.trick[i])];
+                }
+                return h;
+        }
+
+ private:
+        // what a move changes that can't be worked out from the position after it
+        struct Undo {
+                uint64_t hash;
+                int8_t points[2];
+                // the card in the trick slot before the move wrote over it
+                Card overwritten;
+                Card highCard;
+                int8_t leader;
+                int8_t highCardPlayer;
+        };
+
+        PlayPosition position;
+        int8_t points[2];
+        uint64_t hash;
+        FixedVector<Undo, kMaxMoves> history;
+
+        void finishTrick() {
+                const Zobrist::Keys& keys = Zobrist::kKeys;
+                Suit::Suit suitLed = position.trick[0].getSuit();
+                int winningPosition = trickWinner(position.trick.data(), suitLed, position.trump);
+                Card winningCard = position.trick[winningPosition];
+                int winner = (position.leader + winningPosition) % 4;
+
+                for (int i = 0; i < 4; i++) {
+                        hash ^= keys.trick[i][position.trick[i].getIndex()];
+                }
+                hash ^= keys.leader[position.leader] ^ keys.leader[winner];
+
+                const CardRank::Row& strengths = CardRank::row(suitLed, position.trump);
+                if (position.highCardPlayer < 0 || strengths[CardRank::slot(position.highCard)] <
+                        strengths[winningCard.getIndex()]) {
+                        int oldSlot = position.highCardPlayer < 0 ? Card::kNumCards :
+                                CardRank::slot(position.highCard);
+                        int oldTeam = position.highCardPlayer < 0 ? 0 :
+                                1 + position.highCardPlayer % 2;
+                        hash ^= keys.highCard[oldSlot] ^ keys.highCard[winningCard.getIndex()] ^
+                                keys.highTeam[oldTeam] ^ keys.highTeam[1 + winner % 2];
+                        position.highCard = winningCard;
+                        position.highCardPlayer = static_cast<int8_t>(winner);
+                }
+
+                position.leader = static_cast<int8_t>(winner);
+                position.trickSize = 0;
+                points[winner % 2] += 5;
+                if (position.tricksLeft() == 0) {
+                        points[position.highCardPlayer % 2] += 5;
+                }
+        }
+};
@@ -0,0 +1,90 @@
+// Copyright Andrew Bernal 2023
+#include "simulator.hpp"
+#include <memory>
+#include <vector>
+#include "45s.hpp"
+#include "parallel.hpp"
+#include "random.hpp"
+
+void SimulationResults::merge(const SimulationResults& other) {
+        games += other.games;
+        hands += other.hands;
+        unfinishedGames += other.unfinishedGames;
+        for (int team = 0; team < 2; team++) {
+                gamesWon[team] += other.gamesWon[team];
+        }
+        for (int bid = 0; bid <= kMaxBid; bid++) {
+                bidsMade[bid] += other.bidsMade[bid];
+                bidsAttempted[bid] += other.bidsAttempted[bid];
+        }
+}
+
+double SimulationResults::winRate(int team) const {
+        int64_t finished = games - unfinishedGames;
+        return finished == 0 ? 0 : static_cast<double>(gamesWon[team]) / finished;
+}
+
+double SimulationResults::bidSuccessRate(int bidAmount) const {
+        if (bidAmount < 0 || bidAmount > kMaxBid || bidsAttempted[bidAmount] == 0) {
+                return 0;
+        }
+        return static_cast<double>(bidsMade[bidAmount]) / bidsAttempted[bidAmount];
+}
+
+double SimulationResults::averageHandsPerGame() const {
+        return games == 0 ? 0 : static_cast<double>(hands) / games;
+}
+
+Simulator::Simulator(PlayerFactory cp1, PlayerFactory cp2, PlayerFactory cp3, PlayerFactory cp4)
+        : factories{cp1, cp2, cp3, cp4}, maxHandsPerGame(1000), handLog(nullptr) {}
+
+SimulationResults Simulator::run(int64_t numGames, int numThreads, uint64_t seed) {
+        numThreads = resolveThreadCount(numThreads);
+        std::vector<SimulationResults> perThread(numThreads);
+        // made by the thread that uses it, the first time it gets a game
+        std::vector<std::unique_ptr<x45s>> engines(numThreads);
+        // flushed when they are destroyed, at the end of the run
+        std::vector<std::unique_ptr<AsyncHandLog::Producer>> producers(numThreads);
+
+        parallelFor(0, numGames, numThreads, 16, [&](int t, int64_t gameNumber) {
+                if (!engines[t]) {
+                        engines[t] = std::make_unique<x45s>(
+                                factories[0], factories[1], factories[2], factories[3]);
+                        if (handLog != nullptr) {
+                                producers[t] = std::make_unique<AsyncHandLog::Producer>(*handLog);
+                                engines[t]->setHandLog(producers[t].get());
+                        }
+                }
+                x45s& game = *engines[t];
+                SimulationResults& results = perThread[t];
+
+                game.newGame();
+                game.seed(SplitMix64(seed ^ static_cast<uint64_t>(gameNumber))());
+                int hands = 0;
+                while (!game.hasWon() && hands < maxHandsPerGame) {
+                        game.reset();
+                        game.shuffle();
+                        bool made = game.dealBidAndFullFiveTricks().second;
+                        int bid = game.getBidAmount();
+                        if (bid >= 0 && bid <= SimulationResults::kMaxBid) {
+                                results.bidsAttempted[bid]++;
+                                results.bidsMade[bid] += made;
+                        }
+                        hands++;
+                }
+
+                results.games++;
+                results.hands += hands;
+                if (game.hasWon()) {
+                        results.gamesWon[game.whichTeamWon()]++;
+                } else {
+                        results.unfinishedGames++;
+                }
+        });
+
+        SimulationResults total;
+        for (const SimulationResults& results : perThread) {
+                total.merge(results);
+        }
+        return total;
+}
@@ -0,0 +1,53 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <cstdint>
+#include <functional>
+#include "asyncHandLog.hpp"
+#include "player.hpp"
+
+// statistics of many games. Results from different threads are added together with merge
+struct SimulationResults {
+        // bids are 15, 20, 25 or 30. Indexed by the bid amount
+        static constexpr int kMaxBid = 30;
+
+        int64_t games = 0;
+        int64_t hands = 0;
+        // indexed by team (0 or 1)
+        int64_t gamesWon[2] = {0, 0};
+        // games that were still going after maxHandsPerGame hands
+        int64_t unfinishedGames = 0;
+        int64_t bidsMade[kMaxBid + 1] = {};
+        int64_t bidsAttempted[kMaxBid + 1] = {};
+
+        void merge(const SimulationResults& other);
+        // the fraction of the finished games the team won
+        double winRate(int team) const;
+        // the fraction of the bids of this amount that were made, 0 if there were none
+        double bidSuccessRate(int bidAmount) const;
+        double averageHandsPerGame() const;
+};
+
+// Plays full games to 120 on many threads.
+// Every thread has its own x45s and its own players, made with the factories. Game i is seeded
+// with a value derived from the seed and i, so the results don't depend on the number of threads.
+// Games are handed out with parallelFor, so threads that finish early steal games from the others.
+class Simulator {
+ public:
+        using PlayerFactory = std::function<Player*()>;
+
+        Simulator(PlayerFactory cp1, PlayerFactory cp2, PlayerFactory cp3, PlayerFactory cp4);
+
+        // numThreads <= 0 uses every core
+        SimulationResults run(int64_t numGames, int numThreads, uint64_t seed);
+
+        // a game that hasn't ended after this many hands is stopped and counted as unfinished
+        void setMaxHandsPerGame(int hands) { maxHandsPerGame = hands; }
+        // every hand run plays is logged to log, through a producer for each thread. The log
+        // needs more buffers than there are threads. nullptr stops logging
+        void setHandLog(AsyncHandLog* log) { handLog = log; }
+
+ private:
+        PlayerFactory factories[4];
+        int maxHandsPerGame;
+        AsyncHandLog* handLog;
+};
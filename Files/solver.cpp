@@ -0,0 +1,212 @@
+// Copyright Andrew Bernal 2023
+#include "solver.hpp"
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include "rules.hpp"
+#include "symmetry.hpp"
+
+namespace {
+// the bits strictly between low and high
+uint32_t bitsBetween(int low, int high) {
+        return ((uint32_t{1} << high) - 1) & ~((uint32_t{2} << low) - 1);
+}
+}  // namespace
+
+DoubleDummySolver::DoubleDummySolver(int tableBits)
+        : ownTable(std::make_unique<TranspositionTable>(tableBits)), table(ownTable.get()),
+        nodes(0), stop(nullptr), stopped(false), helperIndex(0) {}
+
+DoubleDummySolver::DoubleDummySolver(TranspositionTable& sharedTable)
+        : table(&sharedTable), nodes(0), stop(nullptr), stopped(false), helperIndex(0) {}
+
+void DoubleDummySolver::clearTable() {
+        table->clear();
+}
+
+int DoubleDummySolver::solve(const PlayPosition& position) {
+        if (position.trump < Suit::HEARTS || position.trump > Suit::SPADES) {
+                throw std::invalid_argument("trump is not valid!");
+        }
+        if (position.trickSize < 0 || position.trickSize > 3) {
+                throw std::invalid_argument("a trick in progress has 0 to 3 cards");
+        }
+        // a position and its swap of clubs and spades take the same points, so searching the
+        // representative lets them share the table
+        PlayPosition canonical = position;
+        Symmetry::canonicalize(canonical);
+        SearchPosition current(canonical);
+        stopped = false;
+        return search(current, -1, 5 * position.tricksLeft() + 6);
+}
+
+int DoubleDummySolver::solve(const std::array<CardSet, 4>& hands, Suit::Suit trump, int leader) {
+        if (leader < 0 || leader > 3) {
+                throw std::invalid_argument("the leader must be 0, 1, 2 or 3");
+        }
+        return solve(PlayPosition(hands, trump, leader));
+}
+
+int DoubleDummySolver::orderedMoves(const PlayPosition& position, Card* moves) {
+        int player = position.toPlay();
+        Suit::Suit trump = position.trump;
+        CardSet legal = Rules::legalPlays(position.hands[player], position.led(), trump);
+        CardSet trumps = CardSet::trumpMask(trump);
+
+        // every card that can still be compared with a card played from here on
+        CardSet live = position.hands[0] | position.hands[1] | position.hands[2] |
+                position.hands[3];
+        for (int i = 0; i < position.trickSize; i++) {
+                live.insert(position.trick[i]);
+        }
+        if (position.highCardPlayer >= 0) {
+                live.insert(position.highCard);
+        }
+        const CardRank::Row& trumpStrengths = CardRank::row(Suit::INVALID, trump);
+        uint32_t liveStrengths = 0;
+        for (Card c : live & trumps) {
+                liveStrengths |= uint32_t{1} << trumpStrengths[c.getIndex()];
+        }
+
+        // the strength of the card winning the trick, and if it is the player's partner
+        const CardRank::Row& strengths = CardRank::row(position.led().getSuit(), trump);
+        int winningStrength = -1;
+        bool partnerWinning = false;
+        if (position.trickSize > 0) {
+                int winning = 0;
+                for (int i = 1; i < position.trickSize; i++) {
+                        if (strengths[position.trick[i].getIndex()] >
+                                strengths[position.trick[winning].getIndex()]) {
+                                winning = i;
+                        }
+                }
+                winningStrength = strengths[position.trick[winning].getIndex()];
+                partnerWinning = (position.trickSize - winning) % 2 == 0;
+        }
+
+        int scores[8];
+        int n = 0;
+        int previousTrump = 0;
+        int suitsSeen = 0;
+        legal.forEachByStrength(trump, [&](Card c) {
+                if (trumps.contains(c)) {
+                        int s = trumpStrengths[c.getIndex()];
+                        // no card left between this trump and the player's next higher one
+                        bool equivalent = previousTrump != 0 &&
+                                (liveStrengths & bitsBetween(s, previousTrump)) == 0;
+                        previousTrump = s;
+                        if (equivalent) {
+                                return;
+                        }
+                } else {
+                        // the non-trumps of a suit always tie, so one of them is enough
+                        int suitBit = 1 << c.getSuit();
+                        if (suitsSeen & suitBit) {
+                                return;
+                        }
+                        suitsSeen |= suitBit;
+                }
+
+                int s = strengths[c.getIndex()];
+                int score;
+                if (position.trickSize == 0) {
+                        // lead the high trumps first
+                        score = s;
+                } else if (partnerWinning || s <= winningStrength) {
+                        // play low when the trick is already ours or can't be won
+                        score = -s;
+                } else {
+                        // win as cheaply as possible
+                        score = 100 - s;
+                }
+                // insertion sort, highest score first
+                int i = n++;
+                while (i > 0 && scores[i - 1] < score) {
+                        moves[i] = moves[i - 1];
+                        scores[i] = scores[i - 1];
+                        i--;
+                }
+                moves[i] = c;
+                scores[i] = score;
+        });
+        return n;
+}
+
+int DoubleDummySolver::search(SearchPosition& current, int alpha, int beta) {
+        // looking at an atomic on every node is slow, so only look every 1024
+        if ((++nodes & 1023) == 0 && stop != nullptr && stop->load(std::memory_order_relaxed)) {
+                stopped = true;
+        }
+        if (stopped) {
+                return 0;
+        }
+        const PlayPosition& position = current.getPosition();
+        int tricksLeft = position.tricksLeft();
+        // the high card was scored with the last trick
+        if (tricksLeft == 0) {
+                return 0;
+        }
+        int maxPoints = 5 * tricksLeft + 5;
+        if (maxPoints <= alpha) {
+                return maxPoints;
+        }
+        if (beta <= 0) {
+                return 0;
+        }
+
+        bool atTrickStart = position.trickSize == 0;
+        uint64_t positionKey = current.getHash();
+        // bounds from the table, or bounds that say nothing
+        int lower = 0;
+        int upper = maxPoints;
+        if (atTrickStart && table->probe(positionKey, lower, upper)) {
+                if (lower >= beta || lower == upper) {
+                        return lower;
+                }
+                if (upper <= alpha) {
+                        return upper;
+                }
+                alpha = std::max(alpha, lower);
+                beta = std::min(beta, upper);
+        }
+        int windowAlpha = alpha;
+        int windowBeta = beta;
+
+        bool maximizing = position.toPlay() % 2 == 0;
+        Card moves[8];
+        int n = orderedMoves(position, moves);
+        if (helperIndex != 0 && current.movesMade() < 3 && n > 1) {
+                std::rotate(moves, moves + helperIndex % n, moves + n);
+        }
+        int best = maximizing ? -1 : maxPoints + 1;
+        for (int i = 0; i < n && alpha < beta; i++) {
+                int before = current.getPoints(0);
+                current.makeMove(moves[i]);
+                int gained = current.getPoints(0) - before;
+                int value = gained + search(current, alpha - gained, beta - gained);
+                current.unmakeMove();
+                if (stopped) {
+                        return 0;
+                }
+                if (maximizing) {
+                        best = std::max(best, value);
+                        alpha = std::max(alpha, best);
+                } else {
+                        best = std::min(best, value);
+                        beta = std::min(beta, best);
+                }
+        }
+
+        if (atTrickStart) {
+                if (best <= windowAlpha) {
+                        upper = std::min(upper, best);
+                } else if (best >= windowBeta) {
+                        lower = std::max(lower, best);
+                } else {
+                        lower = best;
+                        upper = best;
+                }
+                table->store(positionKey, lower, upper, tricksLeft);
+        }
+        return best;
+}
@@ -0,0 +1,62 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "card.hpp"
+#include "cardSet.hpp"
+#include "playPosition.hpp"
+#include "searchPosition.hpp"
+#include "suit.hpp"
+#include "transpositionTable.hpp"
+
+// Finds the points each team takes from a position when everyone can see every hand and plays
+// perfectly. Players 0 and 2 (team 0) maximize team 0's points, and players 1 and 3 minimize them.
+// The search is alpha-beta over the legal cards (see rules.hpp). Cards that are equivalent (the
+// non-trumps of a suit, which all tie, and trumps with no other card left between them) are
+// only searched once, moves that are likely to be best are searched first, and positions at the
+// start of a trick are kept in a transposition table, keyed on their Zobrist hash. Every
+// position is turned into its representative under swapping clubs and spades first (see
+// symmetry.hpp), so a deal and its mirror image share their entries.
+// The search plays and takes back cards on a single SearchPosition.
+// The table is kept between calls, so solving many deals with one solver is faster. Solvers on
+// different threads can share one table (see ParallelSolver).
+class DoubleDummySolver {
+ public:
+        // the solver's own transposition table has 2^tableBits entries of 16 bytes
+        explicit DoubleDummySolver(int tableBits = 18);
+        // uses a table shared with other solvers. The table has to outlive the solver
+        explicit DoubleDummySolver(TranspositionTable& sharedTable);
+
+        // the points team 0 takes from the rest of the hand: 5 for every trick left
+        // (including the current one) and 5 for the high card. Team 1 takes the rest
+        int solve(const PlayPosition& position);
+        // for a whole hand: the points out of 30 team 0 takes when leader leads the first trick
+        int solve(const std::array<CardSet, 4>& hands, Suit::Suit trump, int leader);
+
+        // positions searched since the solver was made
+        int64_t getNodes() const { return nodes; }
+        void clearTable();
+
+        // solve gives up as soon as *stop is true, and then its result means nothing.
+        // nullptr never stops
+        void setStopFlag(const std::atomic<bool>* inpStop) { stop = inpStop; }
+        // a helper with a different index searches the first few moves in a different order,
+        // so helpers sharing a table work on different parts of the tree. 0 is the normal order
+        void setHelperIndex(int index) { helperIndex = index; }
+
+ private:
+        // set when the solver owns its table
+        std::unique_ptr<TranspositionTable> ownTable;
+        TranspositionTable* table;
+        int64_t nodes;
+        const std::atomic<bool>* stop;
+        bool stopped;
+        int helperIndex;
+
+        int search(SearchPosition& current, int alpha, int beta);
+        // the legal cards of the player to play, one from each group of equivalent cards,
+        // most promising first. Returns how many there are
+        static int orderedMoves(const PlayPosition& position, Card* moves);
+};
@@ -0,0 +1,32 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <cstddef>
+
+// A view of contiguous items that someone else owns, like std::span in C++20.
+// It can be made from anything with data() and size(), e.g. std::vector, std::array and
+// FixedVector, so callers can pass whatever storage they have without copying it.
+template <class T>
+class Span {
+        T* ptr;
+        std::size_t count;
+
+ public:
+        using value_type = T;
+        using iterator = T*;
+
+        Span() : ptr(nullptr), count(0) {}
+        Span(T* inpPtr, std::size_t inpCount) : ptr(inpPtr), count(inpCount) {}
+        template <std::size_t N>
+        Span(T (&arr)[N]) : ptr(arr), count(N) {}  // NOLINT(runtime/explicit)
+        template <class Container>
+        Span(Container& c) : ptr(c.data()), count(c.size()) {}  // NOLINT(runtime/explicit)
+
+        T& operator[](std::size_t i) const { return ptr[i]; }
+        T* data() const { return ptr; }
+        std::size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        T* begin() const { return ptr; }
+        T* end() const { return ptr + count; }
+        T& front() const { return ptr[0]; }
+        T& back() const { return ptr[count - 1]; }
+};
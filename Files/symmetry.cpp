@@ -0,0 +1,181 @@
+// Copyright Andrew Bernal 2023
+#include "symmetry.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace {
+// the clubs and the spades, as 13 bit masks
+uint64_t clubsOf(CardSet cards) {
+        return (cards.getMask() >> Symmetry::kClubsShift) & 0x1FFF;
+}
+uint64_t spadesOf(CardSet cards) {
+        return cards.getMask() >> Symmetry::kSpadesShift;
+}
+
+// true if the clubs come first: more of them, or as many and a higher mask
+bool clubsFirst(uint64_t clubs, uint64_t spades) {
+        int clubCount = __builtin_popcountll(clubs);
+        int spadeCount = __builtin_popcountll(spades);
+        return clubCount != spadeCount ? clubCount > spadeCount : clubs >= spades;
+}
+
+// 1 if the swapped value comes first, -1 if the value does, 0 if they are the same
+int compareSwap(uint64_t value, uint64_t swapped) {
+        return swapped > value ? 1 : swapped < value ? -1 : 0;
+}
+
+// the position of a canonical black part among the blackOrbits(j) of them: by the number of
+// spades, then the ranks of the clubs and the spades. With as many of each, clubs >= spades, so
+// the pair is numbered like a triangle
+uint64_t blackOrbitIndex(uint64_t clubs, uint64_t spades) {
+        int spadeCount = __builtin_popcountll(spades);
+        int j = __builtin_popcountll(clubs) + spadeCount;
+        uint64_t index = 0;
+        for (int fewer = 0; fewer < spadeCount; fewer++) {
+                uint64_t clubSets = Ranking::choose(13, j - fewer);
+                index += 2 * fewer < j ? clubSets * Ranking::choose(13, fewer) :
+                        clubSets * (clubSets + 1) / 2;
+        }
+        uint64_t clubRank = Ranking::rank(CardSet(clubs));
+        uint64_t spadeRank = Ranking::rank(CardSet(spades));
+        if (2 * spadeCount < j) {
+                return index + clubRank * Ranking::choose(13, spadeCount) + spadeRank;
+        }
+        return index + clubRank * (clubRank + 1) / 2 + spadeRank;
+}
+
+// the black cards of j with that blackOrbitIndex
+CardSet blackOrbitAt(uint64_t index, int j) {
+        int spadeCount = 0;
+        uint64_t clubSets = Ranking::choose(13, j);
+        uint64_t count = clubSets;
+        while (index >= count) {
+                index -= count;
+                spadeCount++;
+                clubSets = Ranking::choose(13, j - spadeCount);
+                count = 2 * spadeCount < j ? clubSets * Ranking::choose(13, spadeCount) :
+                        clubSets * (clubSets + 1) / 2;
+        }
+        uint64_t clubRank;
+        uint64_t spadeRank;
+        if (2 * spadeCount < j) {
+                clubRank = index / Ranking::choose(13, spadeCount);
+                spadeRank = index % Ranking::choose(13, spadeCount);
+        } else {
+                clubRank = 0;
+                while ((clubRank + 1) * (clubRank + 2) / 2 <= index) {
+                        clubRank++;
+                }
+                spadeRank = index - clubRank * (clubRank + 1) / 2;
+        }
+        uint64_t clubs = Ranking::unrank(clubRank, j - spadeCount).getMask();
+        uint64_t spades = Ranking::unrank(spadeRank, spadeCount).getMask();
+        return CardSet((clubs << Symmetry::kClubsShift) | (spades << Symmetry::kSpadesShift));
+}
+
+// the first class of the hands with red red cards
+uint64_t redOffset(int red) {
+        uint64_t offset = 0;
+        for (int more = 5; more > red; more--) {
+                offset += Ranking::choose(26, more) * Symmetry::redBlock(5 - more);
+        }
+        return offset;
+}
+}  // namespace
+
+void Symmetry::SuitPermutation::apply(PlayPosition& position) const {
+        if (!swapsBlackSuits) {
+                return;
+        }
+        for (CardSet& hand : position.hands) {
+                hand = swapBlackSuits(hand);
+        }
+        for (int i = 0; i < position.trickSize; i++) {
+                position.trick[i] = swapBlackSuits(position.trick[i]);
+        }
+        position.highCard = swapBlackSuits(position.highCard);
+        position.trump = swapBlackSuits(position.trump);
+}
+
+Symmetry::CanonicalHand Symmetry::canonicalize(CardSet hand, Suit::Suit trump) {
+        SuitPermutation permutation;
+        if (trump == Suit::SPADES) {
+                permutation.swapsBlackSuits = true;
+        } else if (trump != Suit::CLUBS) {
+                permutation.swapsBlackSuits = !clubsFirst(clubsOf(hand), spadesOf(hand));
+        }
+        return {permutation.apply(hand), permutation.apply(trump), permutation};
+}
+
+Symmetry::SuitPermutation Symmetry::canonicalize(PlayPosition& position) {
+        SuitPermutation permutation;
+        if (position.trump == Suit::SPADES) {
+                permutation.swapsBlackSuits = true;
+        } else if (position.trump != Suit::CLUBS) {
+                // the first hand (or card of the trick) that the swap changes decides, so a
+                // position and its swap pick the same one
+                int order = 0;
+                for (int p = 0; p < 4 && order == 0; p++) {
+                        CardSet hand = position.hands[p];
+                        order = compareSwap(hand.getMask(), swapBlackSuits(hand).getMask());
+                }
+                for (int i = 0; i < position.trickSize && order == 0; i++) {
+                        const Card& c = position.trick[i];
+                        order = compareSwap(c.getIndex(), swapBlackSuits(c).getIndex());
+                }
+                permutation.swapsBlackSuits = order > 0;
+        }
+        permutation.apply(position);
+        return permutation;
+}
+
+int64_t Symmetry::handClassIndex(CardSet hand, Suit::Suit trump) {
+        if (hand.size() != 5) {
+                throw std::invalid_argument("a hand has 5 cards");
+        }
+        if (trump < Suit::HEARTS || trump > Suit::SPADES) {
+                throw std::invalid_argument("trump is not valid!");
+        }
+        CanonicalHand canonical = canonicalize(hand, trump);
+        CardSet red(canonical.hand.getMask() & kRedMask);
+        int j = 5 - red.size();
+        uint64_t index = redOffset(red.size()) + Ranking::rank(red) * redBlock(j);
+        uint64_t clubs = clubsOf(canonical.hand);
+        uint64_t spades = spadesOf(canonical.hand);
+        if (canonical.trump == Suit::CLUBS) {
+                // the black cards as they are, ranked among the 26 black cards
+                uint64_t black = canonical.hand.getMask() >> kClubsShift;
+                index += 2 * blackOrbits(j) + Ranking::rank(CardSet(black));
+        } else {
+                index += (canonical.trump == Suit::DIAMONDS ? blackOrbits(j) : 0) +
+                        blackOrbitIndex(clubs, spades);
+        }
+        return static_cast<int64_t>(index);
+}
+
+Symmetry::CanonicalHand Symmetry::handClassAt(int64_t index) {
+        if (index < 0 || index >= kNumHandClasses) {
+                throw std::out_of_range("there are " + std::to_string(kNumHandClasses) +
+                        " hand classes");
+        }
+        uint64_t rest = static_cast<uint64_t>(index);
+        int redCount = 5;
+        while (rest >= Ranking::choose(26, redCount) * redBlock(5 - redCount)) {
+                rest -= Ranking::choose(26, redCount) * redBlock(5 - redCount);
+                redCount--;
+        }
+        int j = 5 - redCount;
+        CardSet red = Ranking::unrank(rest / redBlock(j), redCount);
+        rest %= redBlock(j);
+        uint64_t orbits = blackOrbits(j);
+        CanonicalHand canonical;
+        if (rest < 2 * orbits) {
+                canonical.trump = rest < orbits ? Suit::HEARTS : Suit::DIAMONDS;
+                canonical.hand = red | blackOrbitAt(rest % orbits, j);
+        } else {
+                uint64_t black = Ranking::unrank(rest - 2 * orbits, j).getMask();
+                canonical.trump = Suit::CLUBS;
+                canonical.hand = red | CardSet(black << kClubsShift);
+        }
+        return canonical;
+}
@@ -0,0 +1,110 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <cstdint>
+#include "card.hpp"
+#include "cardSet.hpp"
+#include "playPosition.hpp"
+#include "ranking.hpp"
+#include "suit.hpp"
+
+// The suit symmetries of the rules, for sharing the entries of tables and caches between
+// positions that play the same way.
+// Most games can relabel any suits, but 45s can't: the red and black suits rank their cards in
+// different orders, and the ace of hearts is always a trump, so hearts and diamonds don't even
+// have the same number of cards. Clubs and spades are the only suits that can be swapped: with
+// every card, the trump and the suit led swapped, every trick has the same winner and every
+// hand takes the same points. So the symmetry group is just that swap and the identity.
+namespace Symmetry {
+        // the hearts and the diamonds (card indexes 0 to 25)
+        constexpr uint64_t kRedMask = (uint64_t{1} << 26) - 1;
+        constexpr int kClubsShift = 2 * 13;
+        constexpr int kSpadesShift = 3 * 13;
+
+        inline CardSet swapBlackSuits(CardSet cards) {
+                uint64_t mask = cards.getMask();
+                uint64_t clubs = (mask >> kClubsShift) & 0x1FFF;
+                uint64_t spades = mask >> kSpadesShift;
+                return CardSet((mask & kRedMask) | (spades << kClubsShift) |
+                        (clubs << kSpadesShift));
+        }
+        inline Suit::Suit swapBlackSuits(Suit::Suit suit) {
+                return suit == Suit::CLUBS ? Suit::SPADES :
+                        suit == Suit::SPADES ? Suit::CLUBS : suit;
+        }
+        // cards that aren't real cards are left alone
+        inline Card swapBlackSuits(const Card& c) {
+                int index = c.getIndex();
+                if (index < kClubsShift) {
+                        return c;
+                }
+                return Card::fromIndex(index < kSpadesShift ? index + 13 : index - 13);
+        }
+
+        // the identity, or swapping clubs and spades. It is its own inverse
+        struct SuitPermutation {
+                bool swapsBlackSuits = false;
+
+                CardSet apply(CardSet cards) const {
+                        return swapsBlackSuits ? swapBlackSuits(cards) : cards;
+                }
+                Card apply(const Card& c) const {
+                        return swapsBlackSuits ? swapBlackSuits(c) : c;
+                }
+                Suit::Suit apply(Suit::Suit suit) const {
+                        return swapsBlackSuits ? swapBlackSuits(suit) : suit;
+                }
+                // the hands, the trick, the high card and the trump
+                void apply(PlayPosition& position) const;
+        };
+
+        // a hand and trump that stands for every (hand, trump) its symmetry maps it to.
+        // The original is (permutation.apply(hand), permutation.apply(trump))
+        struct CanonicalHand {
+                CardSet hand;
+                Suit::Suit trump;
+                SuitPermutation permutation;
+        };
+
+        // The representative never has spades as trump. With a red trump it has at least as
+        // many clubs as spades, and if they have as many, the higher clubs (as a bit mask)
+        CanonicalHand canonicalize(CardSet hand, Suit::Suit trump);
+        // turns position into its representative, the same way, with the hands in seat order
+        // deciding when the trump is red. Returns the permutation that turns it back
+        SuitPermutation canonicalize(PlayPosition& position);
+
+        // The (5 card hand, trump) pairs that are different under the symmetry, numbered densely.
+        // The classes of hands with the same red cards are next to each other, hearts trump
+        // first, then diamonds, then clubs, and the hands with the most red cards come first
+        // (so the first 3 * 1287 classes are the hands of hearts, with every trump).
+        // With a red trump the class is the red cards and the black cards up to the swap, and
+        // with clubs it is the red cards and the black cards as they are
+
+        // the black parts of j cards that are different up to the swap
+        constexpr uint64_t blackOrbits(int j) {
+                uint64_t count = 0;
+                for (int spades = 0; 2 * spades <= j; spades++) {
+                        uint64_t clubSets = Ranking::choose(13, j - spades);
+                        count += 2 * spades < j ? clubSets * Ranking::choose(13, spades) :
+                                clubSets * (clubSets + 1) / 2;
+                }
+                return count;
+        }
+        // the classes of a hand's red cards, when it has j black cards
+        constexpr uint64_t redBlock(int j) {
+                return 2 * blackOrbits(j) + Ranking::choose(26, j);
+        }
+        constexpr int64_t buildNumHandClasses() {
+                uint64_t count = 0;
+                for (int red = 0; red <= 5; red++) {
+                        count += Ranking::choose(26, red) * redBlock(5 - red);
+                }
+                return static_cast<int64_t>(count);
+        }
+        // 5299528, about half of the 4 * 2598960 pairs
+        constexpr int64_t kNumHandClasses = buildNumHandClasses();
+
+        // the class of any (hand, trump). Throws std::invalid_argument unless hand has 5 cards
+        int64_t handClassIndex(CardSet hand, Suit::Suit trump);
+        // the representative of a class. Throws std::out_of_range unless index is a class
+        CanonicalHand handClassAt(int64_t index);
+}
@@ -0,0 +1,95 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include "../45s.hpp"
+#include "../player.hpp"
+#include "../card.hpp"
+#include "../suit.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+// counts every allocation in the test binary, so the tests below can check that a region of
+// code doesn't allocate
+static std::atomic<long> allocations(0);
+
+void* operator new(std::size_t size) {
+        allocations++;
+        void* p = std::malloc(size == 0 ? 1 : size);
+        if (p == nullptr) {
+                throw std::bad_alloc();
+        }
+        return p;
+}
+void* operator new[](std::size_t size) {
+        return operator new(size);
+}
+void operator delete(void* p) noexcept {
+        std::free(p);
+}
+void operator delete[](void* p) noexcept {
+        std::free(p);
+}
+void operator delete(void* p, [[maybe_unused]] std::size_t size) noexcept {
+        std::free(p);
+}
+void operator delete[](void* p, [[maybe_unused]] std::size_t size) noexcept {
+        std::free(p);
+}
+
+// plays the last legal card in its hand, and bids 15 if it has 3 or more of a suit
+class allocationFreePlayer : public Player {
+ public:
+        void discard() override {
+                while (hand.size() > 5) {
+                        hand.erase(hand.begin());
+                }
+        }
+        std::pair<int, Suit::Suit> getBid(Span<const int> bidHistory) override {
+                for (int i = Suit::HEARTS; i <= Suit::SPADES; i++) {
+                        Suit::Suit suit = static_cast<Suit::Suit>(i);
+                        if ((getHandSet() & CardSet::suitMask(suit)).size() >= 3) {
+                                return {bidHistory.empty() ? 15 : 0, suit};
+                        }
+                }
+                return {0, Suit::SPADES};
+        }
+        Suit::Suit bagged() override {
+                return Suit::HEARTS;
+        }
+        Card playCard([[maybe_unused]] const TrickState& trick) override {
+                return playLastLegalCard();
+        }
+};
+
+BOOST_AUTO_TEST_SUITE(AllocationTestSuite)
+
+// after the game is constructed, playing a hand never touches the heap
+BOOST_AUTO_TEST_CASE(HandDoesNotAllocate) {
+        allocationFreePlayer p1, p2, p3, p4;
+        x45s game(&p1, &p2, &p3, &p4);
+        game.seed(45);
+
+        long before = allocations;
+        for (int i = 0; i < 100; i++) {
+                game.reset();
+                game.shuffle();
+                game.dealBidAndFullFiveTricks();
+        }
+        BOOST_CHECK_EQUAL(allocations - before, 0);
+}
+
+// a full game to 120 never touches the heap either
+BOOST_AUTO_TEST_CASE(GameDoesNotAllocate) {
+        allocationFreePlayer p1, p2, p3, p4;
+        x45s game(&p1, &p2, &p3, &p4);
+        game.seed(45);
+
+        long before = allocations;
+        int hands = game.playGame();
+        BOOST_CHECK_EQUAL(allocations - before, 0);
+        BOOST_CHECK(game.hasWon());
+        BOOST_CHECK(hands > 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
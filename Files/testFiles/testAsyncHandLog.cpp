@@ -0,0 +1,165 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "../asyncHandLog.hpp"
+#include "../boundedQueue.hpp"
+#include "../handLog.hpp"
+#include "../player.hpp"
+#include "../simulator.hpp"
+
+namespace {
+// bids 20 in its first card's suit when nobody has bid yet, and plays its last legal card
+class openingBidder : public Player {
+public:
+        void discard() override {
+                while (hand.size() > 5) {
+                        hand.pop_back();
+                }
+        }
+        std::pair<int, Suit::Suit> getBid(Span<const int> bidHistory) override {
+                Suit::Suit suit = hand.front().getSuit();
+                bool opened = std::any_of(bidHistory.begin(), bidHistory.end(),
+                        [](int bid) { return bid != 0; });
+                return {opened ? 0 : 20, suit};
+        }
+        Suit::Suit bagged() override {
+                return Suit::SPADES;
+        }
+        Card playCard([[maybe_unused]] const TrickState& trick) override {
+                return playLastLegalCard();
+        }
+};
+
+// the records of the games, logged from numThreads threads, in byte order
+std::vector<std::string> simulateAndRead(const std::string& path, int numThreads,
+        const AsyncHandLog::Options& options, int64_t& hands) {
+        std::remove(path.c_str());
+        {
+                AsyncHandLog log(path, options);
+                Simulator simulator([]{return new openingBidder;}, []{return new openingBidder;},
+                        []{return new openingBidder;}, []{return new openingBidder;});
+                simulator.setHandLog(&log);
+                hands = simulator.run(200, numThreads, 45).hands;
+                log.flush();
+                BOOST_TEST(log.getWritten() == hands);
+                BOOST_TEST(log.getDropped() == 0);
+        }
+        HandLogReader reader(path);
+        std::vector<std::string> records;
+        for (const HandRecord& record : reader) {
+                records.emplace_back(reinterpret_cast<const char*>(&record), sizeof(record));
+        }
+        std::sort(records.begin(), records.end());
+        std::remove(path.c_str());
+        return records;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(AsyncHandLogTests)
+
+// every item pushed from any thread is popped exactly once
+BOOST_AUTO_TEST_CASE(BoundedQueuePassesEveryItemOnce) {
+        BoundedQueue<int> small(5);
+        BOOST_TEST(small.capacity() == 8u);
+        for (int i = 0; i < 8; i++) {
+                BOOST_TEST(small.tryPush(i));
+        }
+        BOOST_TEST(!small.tryPush(8));
+        int item = -1;
+        BOOST_TEST(small.tryPop(item));
+        BOOST_TEST(item == 0);
+
+        const int kThreads = 4;
+        const int kPerThread = 20000;
+        BoundedQueue<int> queue(64);
+        std::vector<std::atomic<int>> seen(kThreads * kPerThread);
+        std::atomic<int> popped(0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; t++) {
+                threads.emplace_back([&queue, t] {
+                        for (int i = t * kPerThread; i < (t + 1) * kPerThread; i++) {
+                                while (!queue.tryPush(i)) {
+                                        std::this_thread::yield();
+                                }
+                        }
+                });
+                threads.emplace_back([&queue, &seen, &popped] {
+                        int value;
+                        while (popped < kThreads * kPerThread) {
+                                if (queue.tryPop(value)) {
+                                        seen[value]++;
+                                        popped++;
+                                } else {
+                                        std::this_thread::yield();
+                                }
+                        }
+                });
+        }
+        for (std::thread& thread : threads) {
+                thread.join();
+        }
+        BOOST_TEST(std::all_of(seen.begin(), seen.end(), [](const std::atomic<int>& count) {
+                return count == 1;
+        }));
+}
+
+// the hands logged from many threads, with buffers small enough that they run out, are the same
+// as the hands logged from one
+BOOST_AUTO_TEST_CASE(LogsEveryHandFromManyThreads) {
+        AsyncHandLog::Options options;
+        options.bufferRecords = 7;
+        options.maxBuffers = 6;
+        int64_t oneThreadHands = 0;
+        int64_t manyThreadHands = 0;
+        std::vector<std::string> oneThread = simulateAndRead("testAsyncOne.bin", 1, options,
+                oneThreadHands);
+        std::vector<std::string> manyThreads = simulateAndRead("testAsyncMany.bin", 4, options,
+                manyThreadHands);
+        BOOST_TEST(oneThreadHands == manyThreadHands);
+        BOOST_TEST(static_cast<int64_t>(oneThread.size()) == oneThreadHands);
+        BOOST_TEST((oneThread == manyThreads));
+}
+
+// with DROP a producer never waits, and every record is either written or counted as dropped
+BOOST_AUTO_TEST_CASE(DropCountsTheRecordsItDrops) {
+        std::string path = "testAsyncDrop.bin";
+        std::remove(path.c_str());
+        AsyncHandLog::Options options;
+        options.bufferRecords = 1;
+        options.maxBuffers = 2;
+        options.overflow = AsyncHandLog::Overflow::DROP;
+        const int kRecords = 100000;
+        int64_t written = 0;
+        {
+                AsyncHandLog log(path, options);
+                {
+                        AsyncHandLog::Producer producer(log);
+                        BOOST_CHECK_THROW(AsyncHandLog::Producer second(log),
+                                std::invalid_argument);
+                        HandRecord record = {};
+                        for (int i = 0; i < kRecords; i++) {
+                                record.plays[0] = static_cast<uint8_t>(i % 52);
+                                producer.append(record);
+                        }
+                }
+                log.flush();
+                BOOST_TEST(log.getWritten() + log.getDropped() == kRecords);
+                written = log.getWritten();
+        }
+        BOOST_TEST(static_cast<int64_t>(HandLogReader(path).size()) == written);
+        std::remove(path.c_str());
+
+        options.maxBuffers = 1;
+        BOOST_CHECK_THROW(AsyncHandLog log(path, options), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -256,6 +256,18 @@ BOOST_AUTO_TEST_CASE(AceOfHeartsConstructorTest) {
         BOOST_TEST(card.getSuit() == Suit::HEARTS);
 }
 
+// 0xACE is only a value for the ace of hearts
+BOOST_AUTO_TEST_CASE(AceValueOfOtherSuitsIsNotACard) {
+        BOOST_TEST(Card(0xACE, Suit::HEARTS) == Card(1, Suit::HEARTS));
+        for (Suit::Suit suit : {Suit::DIAMONDS, Suit::CLUBS, Suit::SPADES}) {
+                Card card(0xACE, suit);
+                BOOST_TEST(!card.isValid());
+                BOOST_TEST(card.getValue() == -1000);
+                BOOST_TEST(card.getSuit() == suit);
+        }
+        BOOST_TEST(!Card(0xACE, Suit::INVALID).isValid());
+}
+
 BOOST_AUTO_TEST_CASE(CopyConstructorTest) {
         Card card1(1, Suit::DIAMONDS);
         Card card2(card1);
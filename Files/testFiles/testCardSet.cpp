@@ -0,0 +1,84 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include "../card.hpp"
+#include "../cardSet.hpp"
+#include "../suit.hpp"
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(CardSetTestSuite)
+
+BOOST_AUTO_TEST_CASE(InsertContainsRemove) {
+        CardSet set;
+        BOOST_TEST(set.empty());
+        set.insert(Card(5, Suit::HEARTS));
+        set.insert(Card(1, Suit::HEARTS));
+        BOOST_TEST(set.contains(Card(5, Suit::HEARTS)));
+        BOOST_TEST(set.contains(Card(0xACE, Suit::HEARTS)));
+        BOOST_TEST(!set.contains(Card(5, Suit::DIAMONDS)));
+        BOOST_TEST(!set.contains(Card()));
+        BOOST_TEST(set.size() == 2);
+        set.remove(Card(5, Suit::HEARTS));
+        BOOST_TEST(!set.contains(Card(5, Suit::HEARTS)));
+        BOOST_TEST(set.size() == 1);
+}
+
+BOOST_AUTO_TEST_CASE(AllCards) {
+        BOOST_TEST(CardSet::all().size() == 52);
+        BOOST_TEST((~CardSet::all()).empty());
+}
+
+BOOST_AUTO_TEST_CASE(SuitMasks) {
+        for (int suit = Suit::HEARTS; suit <= Suit::SPADES; suit++) {
+                CardSet mask = CardSet::suitMask(static_cast<Suit::Suit>(suit));
+                BOOST_TEST(mask.size() == 13);
+                for (Card c : mask) {
+                        BOOST_TEST(c.getSuit() == suit);
+                }
+        }
+}
+
+// the ace of hearts is trump in every suit, and never follows hearts when hearts isn't trump
+BOOST_AUTO_TEST_CASE(TrumpAndFollowMasks) {
+        Card aceOfHearts(1, Suit::HEARTS);
+        BOOST_TEST(CardSet::trumpMask(Suit::HEARTS).size() == 13);
+        for (int trump = Suit::DIAMONDS; trump <= Suit::SPADES; trump++) {
+                CardSet mask = CardSet::trumpMask(static_cast<Suit::Suit>(trump));
+                BOOST_TEST(mask.size() == 14);
+                BOOST_TEST(mask.contains(aceOfHearts));
+                BOOST_TEST(!CardSet::followMask(Suit::HEARTS,
+                        static_cast<Suit::Suit>(trump)).contains(aceOfHearts));
+        }
+        BOOST_TEST(CardSet::followMask(Suit::CLUBS, Suit::CLUBS).contains(aceOfHearts));
+}
+
+BOOST_AUTO_TEST_CASE(IteratesInIndexOrder) {
+        CardSet set(Card(13, Suit::SPADES), Card(2, Suit::DIAMONDS), Card(1, Suit::HEARTS));
+        std::vector<Card> cards = set.toVector();
+        BOOST_REQUIRE_EQUAL(cards.size(), 3);
+        BOOST_TEST(cards[0] == Card(1, Suit::HEARTS));
+        BOOST_TEST(cards[1] == Card(2, Suit::DIAMONDS));
+        BOOST_TEST(cards[2] == Card(13, Suit::SPADES));
+}
+
+// trumps come first from strongest to weakest, then the other cards
+BOOST_AUTO_TEST_CASE(IteratesInStrengthOrder) {
+        CardSet set(Card(2, Suit::CLUBS), Card(10, Suit::CLUBS), Card(1, Suit::HEARTS),
+                Card(11, Suit::CLUBS), Card(5, Suit::CLUBS), Card(4, Suit::DIAMONDS));
+        std::vector<Card> cards;
+        set.forEachByStrength(Suit::CLUBS, [&](Card c) { cards.push_back(c); });
+        std::vector<Card> expected = {Card(5, Suit::CLUBS), Card(11, Suit::CLUBS),
+                Card(1, Suit::HEARTS), Card(2, Suit::CLUBS), Card(10, Suit::CLUBS),
+                Card(4, Suit::DIAMONDS)};
+        BOOST_TEST(cards == expected);
+}
+
+BOOST_AUTO_TEST_CASE(SetOperations) {
+        CardSet hand(Card(5, Suit::HEARTS), Card(3, Suit::CLUBS), Card(9, Suit::CLUBS));
+        CardSet clubs = hand & CardSet::suitMask(Suit::CLUBS);
+        BOOST_TEST(clubs.size() == 2);
+        BOOST_TEST((hand - clubs).size() == 1);
+        BOOST_TEST((hand - clubs).lowest() == Card(5, Suit::HEARTS));
+        BOOST_CHECK((clubs | CardSet(Card(5, Suit::HEARTS))) == hand);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
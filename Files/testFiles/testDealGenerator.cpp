@@ -0,0 +1,130 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "../card.hpp"
+#include "../cardSet.hpp"
+#include "../dealGenerator.hpp"
+
+namespace {
+const uint64_t kAll = CardSet::all().getMask();
+
+struct MaskDeals {
+        std::vector<uint64_t> hands[4];
+        std::vector<uint64_t> decks;
+
+        MaskDeals(DealGenerator& generator, int count) : decks(count) {
+                for (auto& hand : hands) {
+                        hand.resize(count);
+                }
+                uint64_t* const pointers[4] = {hands[0].data(), hands[1].data(), hands[2].data(),
+                        hands[3].data()};
+                generator.deal(count, pointers, decks.data());
+        }
+};
+
+// the chi-squared statistic of counts against the expected counts
+double chiSquared(const std::vector<int64_t>& counts, const std::vector<double>& expected) {
+        double sum = 0;
+        for (size_t i = 0; i < counts.size(); i++) {
+                double difference = static_cast<double>(counts[i]) - expected[i];
+                sum += difference * difference / expected[i];
+        }
+        return sum;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(DealGeneratorTests)
+
+BOOST_AUTO_TEST_CASE(DealsEveryCardOnce) {
+        DealGenerator generator(1);
+        const int kCount = 1000;
+        MaskDeals deals(generator, kCount);
+        for (int k = 0; k < kCount; k++) {
+                uint64_t seen = 0;
+                for (int seat = 0; seat < 4; seat++) {
+                        uint64_t hand = deals.hands[seat][k];
+                        BOOST_TEST(__builtin_popcountll(hand) == DealGenerator::kHandSize);
+                        BOOST_TEST((seen & hand) == 0u);
+                        seen |= hand;
+                }
+                BOOST_TEST(__builtin_popcountll(deals.decks[k]) == DealGenerator::kDeckSize);
+                BOOST_TEST((seen & deals.decks[k]) == 0u);
+                BOOST_TEST((seen | deals.decks[k]) == kAll);
+        }
+
+        std::vector<uint8_t> cards(kCount * Card::kNumCards);
+        generator.deal(kCount, cards.data());
+        for (int k = 0; k < kCount; k++) {
+                std::vector<uint8_t> deal(cards.begin() + k * Card::kNumCards,
+                        cards.begin() + (k + 1) * Card::kNumCards);
+                std::sort(deal.begin(), deal.end());
+                for (int i = 0; i < Card::kNumCards; i++) {
+                        BOOST_REQUIRE(deal[i] == i);
+                }
+        }
+}
+
+BOOST_AUTO_TEST_CASE(SameSeedSameDeals) {
+        DealGenerator first(7);
+        DealGenerator second(7);
+        DealGenerator other(8);
+        MaskDeals a(first, 100);
+        MaskDeals b(second, 100);
+        MaskDeals c(other, 100);
+        BOOST_TEST(a.decks == b.decks);
+        BOOST_TEST(a.hands[2] == b.hands[2]);
+        BOOST_TEST(a.decks != c.decks);
+
+        first.seed(9);
+        second.seed(9);
+        std::vector<uint8_t> x(52 * 10);
+        std::vector<uint8_t> y(52 * 10);
+        first.deal(10, x.data());
+        second.deal(10, y.data());
+        BOOST_TEST(x == y);
+}
+
+BOOST_AUTO_TEST_CASE(EveryCardIsEquallyLikelyEverywhere) {
+        // with a fixed seed these are fixed numbers, and a biased shuffle would be far off.
+        // Where each card goes (4 hands or the deck) has 52 * 4 degrees of freedom, and where
+        // card 0 goes in the shuffled deck has 51. Both limits are far past the 99.99th
+        // percentile of a fair shuffle
+        const int kCount = 52000;
+        DealGenerator generator(45);
+        MaskDeals deals(generator, kCount);
+        std::vector<int64_t> counts(Card::kNumCards * 5);
+        std::vector<double> expected(Card::kNumCards * 5);
+        for (int c = 0; c < Card::kNumCards; c++) {
+                for (int seat = 0; seat < 4; seat++) {
+                        expected[5 * c + seat] = kCount * 5.0 / Card::kNumCards;
+                }
+                expected[5 * c + 4] = kCount * 32.0 / Card::kNumCards;
+        }
+        for (int k = 0; k < kCount; k++) {
+                for (int c = 0; c < Card::kNumCards; c++) {
+                        int where = 4;
+                        for (int seat = 0; seat < 4; seat++) {
+                                if ((deals.hands[seat][k] >> c) & 1) {
+                                        where = seat;
+                                }
+                        }
+                        counts[5 * c + where]++;
+                }
+        }
+        BOOST_TEST(chiSquared(counts, expected) < 300.0);
+
+        std::vector<uint8_t> cards(static_cast<size_t>(kCount) * Card::kNumCards);
+        generator.deal(kCount, cards.data());
+        std::vector<int64_t> positions(Card::kNumCards);
+        for (size_t i = 0; i < cards.size(); i++) {
+                if (cards[i] == 0) {
+                        positions[i % Card::kNumCards]++;
+                }
+        }
+        BOOST_TEST(chiSquared(positions, std::vector<double>(Card::kNumCards,
+                kCount / static_cast<double>(Card::kNumCards))) < 100.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
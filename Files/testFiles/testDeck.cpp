@@ -6,6 +6,7 @@
 #include <vector>
 #include <algorithm>
 #include <iostream>
+#include <random>
 
 BOOST_AUTO_TEST_SUITE(DeckTestSuite)
 
@@ -150,4 +151,118 @@ BOOST_AUTO_TEST_CASE(manyShufflesTestAll52CardsExist) {
         BOOST_REQUIRE(deck.containsCard(0xACE, Suit::HEARTS));
 }
 
+// the set of cards follows the pack through removeCard, pop_back and push_back
+BOOST_AUTO_TEST_CASE(CardSetTracksPack) {
+        Deck deck;
+        BOOST_CHECK(deck.getCardSet() == CardSet::all());
+        deck.removeCard(5, Suit::CLUBS);
+        BOOST_TEST(!deck.containsCard(5, Suit::CLUBS));
+        Card last = deck.pop_back();
+        BOOST_TEST(!deck.containsCard(last));
+        BOOST_TEST(deck.getCardSet().size() == 50);
+        deck.push_back(last);
+        BOOST_TEST(deck.containsCard(last));
+        BOOST_CHECK_THROW(deck.removeCard(5, Suit::CLUBS), std::invalid_argument);
+}
+
+// a card pushed back twice is still in the deck after one copy is removed
+BOOST_AUTO_TEST_CASE(RemoveDuplicateCard) {
+        Deck deck;
+        deck.push_back(Card(7, Suit::SPADES));
+        deck.removeCard(7, Suit::SPADES);
+        BOOST_TEST(deck.containsCard(7, Suit::SPADES));
+        deck.removeCard(7, Suit::SPADES);
+        BOOST_TEST(!deck.containsCard(7, Suit::SPADES));
+        BOOST_TEST(deck.getSize() == 51);
+}
+
+// a partial or default card goes in the pack and comes back out, but never into the set
+BOOST_AUTO_TEST_CASE(PushBackPartialCard) {
+        Deck deck;
+        deck.removeCard(7, Suit::SPADES);
+        deck.push_back(Card());
+        deck.push_back(Card(7, Suit::INVALID));
+        BOOST_TEST(deck.getSize() == 53);
+        BOOST_CHECK(deck.getCardSet() == CardSet::all() - CardSet(Card(7, Suit::SPADES)));
+        BOOST_TEST(!deck.containsCard(7, Suit::INVALID));
+        BOOST_TEST(!deck.pop_back().isValid());
+        BOOST_TEST(!deck.pop_back().isValid());
+        BOOST_TEST(deck.getCardSet().size() == 51);
+        BOOST_TEST(deck.pop_back().isValid());
+        BOOST_TEST(deck.getCardSet().size() == 50);
+}
+
+// decks with the same seed shuffle the same way, and different seeds shuffle differently
+BOOST_AUTO_TEST_CASE(SeededShuffleIsReproducible) {
+        Deck deck1(45), deck2(45), deck3(46);
+        deck1.shuffle();
+        deck2.shuffle();
+        deck3.shuffle();
+        BOOST_TEST(deck1.getPack() == deck2.getPack());
+        BOOST_TEST(deck1.getPack() != deck3.getPack());
+
+        deck1.reset();
+        deck1.seed(45);
+        deck1.shuffle();
+        BOOST_TEST(deck1.getPack() == deck2.getPack());
+}
+
+// two default constructed decks don't deal the same cards, even in the same second
+BOOST_AUTO_TEST_CASE(UnseededDecksAreIndependent) {
+        Deck deck1, deck2;
+        deck1.shuffle();
+        deck2.shuffle();
+        BOOST_TEST(deck1.getPack() != deck2.getPack());
+}
+
+BOOST_AUTO_TEST_CASE(ShuffleWithOtherGenerator) {
+        Deck deck;
+        std::mt19937_64 rng(45);
+        deck.shuffle(rng);
+        BOOST_TEST(deck.getCardSet() == CardSet::all());
+        BOOST_TEST(deck.getSize() == 52);
+}
+
+BOOST_AUTO_TEST_CASE(BoundedRandomStaysInRange) {
+        Xoshiro256StarStar rng(45);
+        for (uint32_t range = 1; range < 100; range++) {
+                for (int i = 0; i < 100; i++) {
+                        BOOST_REQUIRE(boundedRandom(rng, range) < range);
+                }
+        }
+}
+
+// every card ends up on top about 1/52 of the time
+BOOST_AUTO_TEST_CASE(ShuffleIsUniform) {
+        const int shuffles = 52000;
+        int counts[52] = {};
+        Deck deck(45);
+        for (int i = 0; i < shuffles; i++) {
+                deck.reset();
+                deck.shuffle();
+                counts[deck.peek_back().getIndex()]++;
+        }
+        // chi-squared with 51 degrees of freedom, p = 0.001 is about 87
+        double chiSquared = 0;
+        for (int count : counts) {
+                chiSquared += (count - 1000.0) * (count - 1000.0) / 1000.0;
+        }
+        BOOST_TEST(chiSquared < 87.0);
+}
+
+// stacked cards are dealt first, in order, and the rest of the deck is still there under them
+BOOST_AUTO_TEST_CASE(StackedCardsAreDealtFirst) {
+        Deck deck(45);
+        deck.shuffle();
+        std::vector<Card> top = {Card(5, Suit::HEARTS), Card(1, Suit::HEARTS),
+                deck.getPack().front()};
+        deck.stack(Span<const Card>(top));
+        BOOST_TEST(deck.getSize() == 52);
+        for (const Card& c : top) {
+                BOOST_TEST((deck.pop_back() == c));
+        }
+        BOOST_TEST(deck.getCardSet().size() == 49);
+        BOOST_CHECK_THROW(deck.stack(Span<const Card>(top)), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,95 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "../card.hpp"
+#include "../cardSet.hpp"
+#include "../equityTable.hpp"
+#include "../pimcPlayer.hpp"
+#include "../suit.hpp"
+#include "../symmetry.hpp"
+
+namespace {
+// every hand of hearts, with every trump (see Symmetry::handClassIndex)
+constexpr int64_t kTestClasses = 3 * 1287;
+
+// the top 5 trumps in hearts, which take every trick
+CardSet topHearts() {
+        return CardSet(Card(5, Suit::HEARTS), Card(11, Suit::HEARTS), Card(1, Suit::HEARTS),
+                Card(13, Suit::HEARTS), Card(12, Suit::HEARTS));
+}
+
+std::vector<char> readFile(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in),
+                std::istreambuf_iterator<char>());
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(EquityTableTests)
+
+// a small table is written, mapped and read back, and it doesn't depend on the threads
+BOOST_AUTO_TEST_CASE(GeneratesAndLoadsATable) {
+        std::string onePath = "testEquityOne.bin";
+        std::string manyPath = "testEquityMany.bin";
+        EquityTable::generate(onePath, 4, 1, 7, kTestClasses);
+        EquityTable::generate(manyPath, 4, 3, 7, kTestClasses);
+        BOOST_TEST((readFile(onePath) == readFile(manyPath)));
+        {
+                EquityTable table(onePath);
+                BOOST_TEST(table.getNumClasses() == kTestClasses);
+                BOOST_TEST(table.getSamples() == 4);
+                for (int64_t index = 0; index < kTestClasses; index++) {
+                        Symmetry::CanonicalHand canonical = Symmetry::handClassAt(index);
+                        const HandEquity& equity = table.lookup(canonical.hand, canonical.trump);
+                        BOOST_REQUIRE(equity.expectedPoints() <= 30);
+                        // a bid that is made makes every smaller bid
+                        for (int bid = 15; bid < 30; bid += 5) {
+                                BOOST_REQUIRE(equity.makeProbability(bid) >=
+                                        equity.makeProbability(bid + 5));
+                        }
+                }
+                const HandEquity& hearts = table.lookup(topHearts(), Suit::HEARTS);
+                BOOST_TEST(hearts.expectedPoints() == 30);
+                BOOST_TEST(hearts.makeProbability(30) == 1);
+                std::pair<int, Suit::Suit> bid = table.bestBid(topHearts(), 20, 0.9);
+                BOOST_TEST(bid.first == 30);
+                BOOST_TEST(bid.second == Suit::HEARTS);
+                BOOST_TEST(table.bestTrump(topHearts()) == Suit::HEARTS);
+                // with no black cards, spades is the same class as clubs
+                BOOST_TEST(&table.lookup(topHearts(), Suit::SPADES) ==
+                        &table.lookup(topHearts(), Suit::CLUBS));
+                Symmetry::CanonicalHand missing = Symmetry::handClassAt(kTestClasses);
+                BOOST_CHECK_THROW(table.lookup(missing.hand, missing.trump), std::out_of_range);
+
+                // a PimcPlayer bids from the table
+                PimcPlayer::Options options;
+                options.equityTable = &table;
+                PimcPlayer player(options);
+                for (Card c : topHearts()) {
+                        player.dealCard(c);
+                }
+                std::vector<int> bids = {25};
+                BOOST_TEST(player.getBid(Span<const int>(bids)).first == 30);
+                BOOST_TEST(player.getLastSamples() == 0);
+        }
+        std::remove(onePath.c_str());
+        std::remove(manyPath.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(RejectsFilesThatArentTables) {
+        BOOST_CHECK_THROW(EquityTable("noSuchEquityTable.bin"), std::runtime_error);
+        std::string path = "testNotEquity.bin";
+        {
+                std::ofstream out(path, std::ios::binary);
+                out << "this is not an equity table, but it is longer than the header";
+        }
+        BOOST_CHECK_THROW(EquityTable table(path), std::runtime_error);
+        std::remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
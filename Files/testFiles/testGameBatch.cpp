@@ -0,0 +1,213 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include <array>
+#include <stdexcept>
+#include <vector>
+#include "../card.hpp"
+#include "../cardSet.hpp"
+#include "../gameBatch.hpp"
+#include "../gameState.hpp"
+#include "../handTracker.hpp"
+#include "../random.hpp"
+#include "../suit.hpp"
+
+namespace {
+// the highest legal card, the same in every game that is in the same state
+uint8_t highestChoice(uint64_t choices) {
+        return static_cast<uint8_t>(63 - __builtin_clzll(choices));
+}
+
+// bids 20 with 3 trumps in some suit, keeps its trumps and plays its highest legal card
+class SimplePolicy : public BatchPolicy {
+ public:
+        void bid(const GameBatch& batch, Span<int8_t> amounts, Span<uint8_t> trumps) override {
+                for (int g = 0; g < batch.getNumGames(); g++) {
+                        CardSet hand(batch.getChoices()[g]);
+                        amounts[g] = 0;
+                        trumps[g] = Suit::HEARTS;
+                        for (int s = Suit::HEARTS; s <= Suit::SPADES; s++) {
+                                Suit::Suit suit = static_cast<Suit::Suit>(s);
+                                if ((hand & CardSet::trumpMask(suit)).size() >= 3) {
+                                        amounts[g] = 20;
+                                        trumps[g] = static_cast<uint8_t>(suit);
+                                }
+                        }
+                }
+        }
+        void discard(const GameBatch& batch, Span<uint64_t> keep) override {
+                for (int g = 0; g < batch.getNumGames(); g++) {
+                        Suit::Suit trump = static_cast<Suit::Suit>(batch.getTrumps()[g]);
+                        CardSet kept;
+                        CardSet(batch.getChoices()[g]).forEachByStrength(trump,
+                                [&kept](const Card& c) {
+                                        if (kept.size() < 5) {
+                                                kept.insert(c);
+                                        }
+                                });
+                        keep[g] = (kept & CardSet::trumpMask(trump)).getMask();
+                }
+        }
+        void play(const GameBatch& batch, Span<uint8_t> cards) override {
+                for (int g = 0; g < batch.getNumGames(); g++) {
+                        if (batch.getActive()[g]) {
+                                cards[g] = highestChoice(batch.getChoices()[g]);
+                        }
+                }
+        }
+};
+
+// plays random legal cards, and replays every hand on a GameState to check the batch follows
+// the same rules
+class CheckingPolicy final : public SimplePolicy {
+ public:
+        explicit CheckingPolicy(int numGames)
+                : rng(45), states(numGames), expected(numGames), checks(0) {}
+
+        void bid(const GameBatch& batch, Span<int8_t> amounts, Span<uint8_t> trumps) override {
+                checkScores(batch);
+                SimplePolicy::bid(batch, amounts, trumps);
+                for (int g = 0; g < batch.getNumGames(); g++) {
+                        if (boundedRandom(rng, 4) == 0) {
+                                amounts[g] = static_cast<int8_t>(15 + 5 * boundedRandom(rng, 4));
+                        }
+                }
+        }
+        void play(const GameBatch& batch, Span<uint8_t> cards) override {
+                for (int g = 0; g < batch.getNumGames(); g++) {
+                        if (!batch.getActive()[g]) {
+                                continue;
+                        }
+                        GameState& state = states[g];
+                        if (batch.getTricksPlayed() == 0 && batch.getTrickSize() == 0) {
+                                state = GameState();
+                                for (int seat = 0; seat < 4; seat++) {
+                                        state.play.hands[seat] = CardSet(batch.getHands(seat)[g]);
+                                }
+                                state.play.trump = static_cast<Suit::Suit>(batch.getTrumps()[g]);
+                                state.play.leader = static_cast<int8_t>(batch.getBidders()[g]);
+                                state.bidder = static_cast<int8_t>(batch.getBidders()[g]);
+                                state.bidAmount = batch.getBidAmounts()[g];
+                                state.teamScores[0] = batch.getTeamScores(0)[g];
+                                state.teamScores[1] = batch.getTeamScores(1)[g];
+                        }
+                        BOOST_REQUIRE(batch.getSeats()[g] == state.play.toPlay());
+                        BOOST_REQUIRE(CardSet(batch.getChoices()[g]) == legalMoves(state));
+                        BOOST_REQUIRE(batch.getHandScores(0)[g] == state.handScores[0]);
+                        BOOST_REQUIRE(batch.getHandScores(1)[g] == state.handScores[1]);
+
+                        std::vector<Card> legal = legalMoves(state).toVector();
+                        Card c = legal[boundedRandom(rng, legal.size())];
+                        cards[g] = static_cast<uint8_t>(c.getIndex());
+                        state = applyMove(state, c);
+                        if (state.tricksPlayed == kTricksPerHand) {
+                                expected[g] = scoreHand(state);
+                        }
+                        checks++;
+                }
+        }
+
+        // the scores of every game match the hand replayed on its GameState
+        void checkScores(const GameBatch& batch) {
+                for (int g = 0; g < batch.getNumGames(); g++) {
+                        if (batch.getHandsPlayed()[g] > 0) {
+                                BOOST_REQUIRE(batch.getTeamScores(0)[g] ==
+                                        expected[g].teamScores[0]);
+                                BOOST_REQUIRE(batch.getTeamScores(1)[g] ==
+                                        expected[g].teamScores[1]);
+                        }
+                }
+        }
+
+        int64_t getChecks() const { return checks; }
+
+ private:
+        Xoshiro256StarStar rng;
+        std::vector<GameState> states;
+        std::vector<GameState> expected;
+        int64_t checks;
+};
+
+// plays the first card it can't play
+class IllegalPolicy final : public SimplePolicy {
+ public:
+        void play(const GameBatch& batch, Span<uint8_t> cards) override {
+                for (int g = 0; g < batch.getNumGames(); g++) {
+                        uint64_t illegal = ~batch.getChoices()[g] & CardSet::all().getMask();
+                        cards[g] = static_cast<uint8_t>(__builtin_ctzll(illegal));
+                }
+        }
+};
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(GameBatchTests)
+
+BOOST_AUTO_TEST_CASE(FollowsTheRulesOfTheGameState) {
+        GameBatch batch(64, 45);
+        CheckingPolicy policy(batch.getNumGames());
+        int64_t hands = batch.playGames(policy);
+        policy.checkScores(batch);
+        BOOST_TEST(batch.done());
+        BOOST_TEST(policy.getChecks() == 20 * hands);
+        for (int g = 0; g < batch.getNumGames(); g++) {
+                int winner = batch.getWinners()[g];
+                BOOST_REQUIRE(winner != -1);
+                BOOST_REQUIRE(batch.getTeamScores(winner)[g] >= kWinningScore);
+        }
+}
+
+// the bidder has the kiddie when discarding, and everyone has 5 cards to play
+BOOST_AUTO_TEST_CASE(DealsTheKiddieAndRefills) {
+        GameBatch batch(32, 7);
+        SimplePolicy policy;
+        for (int i = 0; i < 4; i++) {
+                batch.step(policy);
+        }
+        BOOST_REQUIRE(batch.getPhase() == GameBatch::Phase::DISCARD);
+        for (int g = 0; g < batch.getNumGames(); g++) {
+                int bidder = batch.getBidders()[g];
+                uint64_t all = 0;
+                for (int seat = 0; seat < 4; seat++) {
+                        CardSet hand(batch.getHands(seat)[g]);
+                        BOOST_REQUIRE(hand.size() == (seat == bidder ? 8 : 5));
+                        BOOST_REQUIRE((all & hand.getMask()) == 0);
+                        all |= hand.getMask();
+                }
+        }
+        for (int i = 0; i < 4; i++) {
+                batch.step(policy);
+        }
+        BOOST_REQUIRE(batch.getPhase() == GameBatch::Phase::PLAY);
+        for (int g = 0; g < batch.getNumGames(); g++) {
+                BOOST_REQUIRE(batch.getSeats()[g] == batch.getBidders()[g]);
+                for (int seat = 0; seat < 4; seat++) {
+                        BOOST_REQUIRE(CardSet(batch.getHands(seat)[g]).size() == 5);
+                }
+        }
+}
+
+// a game is seeded by its number, so it plays the same in any batch
+BOOST_AUTO_TEST_CASE(GamesDontDependOnTheBatchSize) {
+        GameBatch small(5, 99);
+        GameBatch large(40, 99);
+        SimplePolicy policy;
+        small.playGames(policy);
+        large.playGames(policy);
+        for (int g = 0; g < small.getNumGames(); g++) {
+                BOOST_TEST(small.getWinners()[g] == large.getWinners()[g]);
+                BOOST_TEST(small.getHandsPlayed()[g] == large.getHandsPlayed()[g]);
+                BOOST_TEST(small.getTeamScores(0)[g] == large.getTeamScores(0)[g]);
+                BOOST_TEST(small.getTeamScores(1)[g] == large.getTeamScores(1)[g]);
+        }
+}
+
+BOOST_AUTO_TEST_CASE(RejectsIllegalAnswers) {
+        BOOST_CHECK_THROW(GameBatch(0, 1), std::invalid_argument);
+        GameBatch batch(8, 3);
+        IllegalPolicy policy;
+        for (int i = 0; i < 8; i++) {
+                batch.step(policy);
+        }
+        BOOST_CHECK_THROW(batch.step(policy), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
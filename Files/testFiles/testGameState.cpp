@@ -0,0 +1,128 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include <array>
+#include "../45s.hpp"
+#include "../card.hpp"
+#include "../cardSet.hpp"
+#include "../deck.hpp"
+#include "../gameState.hpp"
+#include "../player.hpp"
+#include "../suit.hpp"
+
+namespace {
+// a hand of 5 cards each, with spades trump and player 1 leading
+GameState dealtState() {
+        Deck deck(45);
+        deck.shuffle();
+        GameState state;
+        for (CardSet& hand : state.play.hands) {
+                for (int i = 0; i < 5; i++) {
+                        hand.insert(deck.pop_back());
+                }
+        }
+        state.play.trump = Suit::SPADES;
+        state.play.leader = 1;
+        state.bidder = 1;
+        state.bidAmount = 20;
+        return state;
+}
+
+class lowestCardPlayer : public Player {
+public:
+        void discard() override {
+                while (hand.size() > 5) {
+                        hand.pop_back();
+                }
+        }
+        std::pair<int, Suit::Suit> getBid([[maybe_unused]] Span<const int> bidHistory) override {
+                return {0, Suit::HEARTS};
+        }
+        Suit::Suit bagged() override {
+                return Suit::DIAMONDS;
+        }
+        Card playCard([[maybe_unused]] const TrickState& trick) override {
+                return playLastLegalCard();
+        }
+};
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(GameStateTests)
+
+BOOST_AUTO_TEST_CASE(ApplyMoveDoesNotChangeItsInput) {
+        GameState state = dealtState();
+        Card c = state.play.hands[1].lowest();
+        GameState next = applyMove(state, c);
+        BOOST_TEST(state.play.hands[1].contains(c));
+        BOOST_TEST(state.play.trickSize == 0);
+        BOOST_TEST(!next.play.hands[1].contains(c));
+        BOOST_TEST(next.played.contains(c));
+        BOOST_TEST(next.play.trickSize == 1);
+        BOOST_TEST(next.play.toPlay() == 2);
+        BOOST_TEST(next.suitLed == c.getSuit());
+}
+
+// playing a whole hand gives out all 30 points, 5 for each trick and 5 for the high card
+BOOST_AUTO_TEST_CASE(HandScoresAddUpToThirty) {
+        GameState state = dealtState();
+        int tricksWon[2] = {0, 0};
+        for (int trick = 0; trick < kTricksPerHand; trick++) {
+                for (int i = 0; i < 4; i++) {
+                        BOOST_REQUIRE(!legalMoves(state).empty());
+                        state = applyMove(state, legalMoves(state).lowest());
+                }
+                tricksWon[state.play.leader % 2]++;
+        }
+        BOOST_TEST(state.tricksPlayed == kTricksPerHand);
+        BOOST_TEST(state.handScores[0] + state.handScores[1] == 30);
+        int highCardTeam = state.play.highCardPlayer % 2;
+        BOOST_TEST(state.handScores[highCardTeam] == 5 * tricksWon[highCardTeam] + 5);
+        BOOST_TEST(state.played.size() == 20);
+}
+
+BOOST_AUTO_TEST_CASE(ScoreHandDeductsAFailedBid) {
+        GameState state;
+        state.bidder = 2;
+        state.bidAmount = 25;
+        state.handScores[0] = 20;
+        state.handScores[1] = 10;
+        BOOST_TEST(!madeBid(state));
+        state = scoreHand(state);
+        BOOST_TEST(state.teamScores[0] == -25);
+        BOOST_TEST(state.teamScores[1] == 10);
+
+        state.handScores[0] = 25;
+        state.handScores[1] = 5;
+        BOOST_TEST(madeBid(state));
+        state = scoreHand(state);
+        BOOST_TEST(state.teamScores[0] == 0);
+        BOOST_TEST(state.teamScores[1] == 15);
+}
+
+BOOST_AUTO_TEST_CASE(WinningTeam) {
+        GameState state;
+        BOOST_TEST(winningTeam(state) == -1);
+        state.teamScores[1] = kWinningScore;
+        BOOST_TEST(winningTeam(state) == 1);
+}
+
+// the engine keeps its rules state in a GameState, and a copy of it is independent of the game
+BOOST_AUTO_TEST_CASE(EngineStateCanBeCopied) {
+        x45s game([]{return new lowestCardPlayer;}, []{return new lowestCardPlayer;},
+                []{return new lowestCardPlayer;}, []{return new lowestCardPlayer;});
+        game.seed(45);
+        game.shuffle();
+        std::pair<int, bool> result = game.dealBidAndFullFiveTricks();
+
+        GameState snapshot = game.getState();
+        BOOST_TEST(snapshot.bidder == result.first);
+        BOOST_TEST(madeBid(snapshot) == result.second);
+        BOOST_TEST(snapshot.teamScores[0] == game.getTeamScore(0));
+        BOOST_TEST(snapshot.teamScores[1] == game.getTeamScore(1));
+        BOOST_TEST(snapshot.tricksPlayed == kTricksPerHand);
+        BOOST_TEST(snapshot.played.size() == 20);
+
+        snapshot.teamScores[0] = 100;
+        BOOST_TEST(game.getState().teamScores[0] != 100);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,236 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../basicX45s.hpp"
+#include "../card.hpp"
+#include "../cardSet.hpp"
+#include "../handArchive.hpp"
+#include "../handLog.hpp"
+#include "../player.hpp"
+#include "../suit.hpp"
+#include "../trickKernels.hpp"
+#include "testHelpers.hpp"
+
+namespace {
+// bids 20 or 25 in its longest suit if it is long enough, and keeps only its trumps, so the hands
+// have all sorts of bids, trumps and outcomes
+class trumpKeeper final : public Player {
+ public:
+        void discard() override {
+                CardSet trumps = getHandSet() & CardSet::trumpMask(trump);
+                for (auto it = hand.begin(); it != hand.end();) {
+                        bool keep = trumps.contains(*it) || (trumps.empty() && it == hand.begin());
+                        it = keep ? it + 1 : hand.erase(it);
+                }
+                while (hand.size() > 5) {
+                        hand.erase(hand.begin());
+                }
+        }
+        std::pair<int, Suit::Suit> getBid([[maybe_unused]] Span<const int> bidHistory) override {
+                Suit::Suit suit = longestSuit();
+                int length = (getHandSet() & CardSet::trumpMask(suit)).size();
+                return {length >= 4 ? 25 : length == 3 ? 20 : 0, suit};
+        }
+        Suit::Suit bagged() override {
+                return longestSuit();
+        }
+        void bidWon([[maybe_unused]] int bidder, [[maybe_unused]] int amount,
+                Suit::Suit inpTrump) override {
+                trump = inpTrump;
+        }
+        Card playCard([[maybe_unused]] const TrickState& trick) override {
+                return playLastLegalCard();
+        }
+
+ private:
+        Suit::Suit trump = Suit::HEARTS;
+
+        Suit::Suit longestSuit() {
+                Suit::Suit longest = Suit::HEARTS;
+                for (int i = Suit::DIAMONDS; i <= Suit::SPADES; i++) {
+                        Suit::Suit suit = static_cast<Suit::Suit>(i);
+                        if ((getHandSet() & CardSet::trumpMask(suit)).size() >
+                                (getHandSet() & CardSet::trumpMask(longest)).size()) {
+                                longest = suit;
+                        }
+                }
+                return longest;
+        }
+};
+
+class vectorSink : public HandLogSink {
+ public:
+        std::vector<HandRecord> records;
+        void append(const HandRecord& record) override { records.push_back(record); }
+};
+
+// the records of whole games, until there are at least count
+std::vector<HandRecord> playHands(int count) {
+        basic_x45s<trumpKeeper, trumpKeeper, trumpKeeper, trumpKeeper> game;
+        vectorSink sink;
+        game.setHandLog(&sink);
+        game.seed(45);
+        while (static_cast<int>(sink.records.size()) < count) {
+                game.newGame();
+                game.playGame();
+        }
+        game.setHandLog(nullptr);
+        return sink.records;
+}
+
+// counts the matches one record at a time, without the archive
+QueryResult bruteForce(const std::vector<HandRecord>& records, const HandQuery& query) {
+        QueryResult result;
+        for (const HandRecord& record : records) {
+                int bidder = record.bidder();
+                int points = record.points()[bidder % 2];
+                bool made = points >= record.bidAmount();
+                CardSet hand = record.playedHands()[bidder];
+                if (record.bidAmount() >= query.minBid && record.bidAmount() <= query.maxBid &&
+                        points >= query.minPoints && points <= query.maxPoints &&
+                        ((query.bidders >> bidder) & 1) &&
+                        ((query.trumps >> (record.trump() - 1)) & 1) &&
+                        ((query.outcomes >> made) & 1) &&
+                        (query.bidderHolds - hand).empty() &&
+                        (query.bidderLacks & hand).empty()) {
+                        result.matches++;
+                        result.made += made;
+                }
+        }
+        return result;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(HandArchiveTests)
+
+// the columns and summaries agree with the records they were written from
+BOOST_AUTO_TEST_CASE(WritesTheColumns) {
+        std::string prefix = "testArchiveColumns";
+        // not a whole number of blocks, so the last block is short
+        std::vector<HandRecord> records = playHands(2 * HandArchive::kBlockRows + 100);
+        HandArchive::write(prefix, Span<const HandRecord>(records), 3);
+        {
+                HandArchive archive(prefix);
+                BOOST_TEST(archive.size() == static_cast<int64_t>(records.size()));
+                BOOST_TEST(archive.numBlocks() == 3);
+                bool columnsMatch = true;
+                for (size_t i = 0; i < records.size(); i++) {
+                        const HandRecord& record = records[i];
+                        std::array<CardSet, 4> hands = record.playedHands();
+                        int points = record.points()[record.bidder() % 2];
+                        columnsMatch &= archive.bidders()[i] == record.bidder() &&
+                                archive.bidAmounts()[i] == record.bidAmount() &&
+                                archive.trumps()[i] == record.trump() &&
+                                archive.points()[i] == points &&
+                                archive.made()[i] == (points >= record.bidAmount()) &&
+                                archive.bidderHands()[i] == hands[record.bidder()].getMask();
+                        for (int seat = 0; seat < 4; seat++) {
+                                columnsMatch &= archive.hands(seat)[i] == hands[seat].getMask();
+                        }
+                }
+                BOOST_TEST(columnsMatch);
+
+                for (int64_t b = 0; b < archive.numBlocks(); b++) {
+                        const HandArchive::BlockSummary& summary = archive.summaries()[b];
+                        int64_t end = std::min<int64_t>(archive.size(),
+                                (b + 1) * HandArchive::kBlockRows);
+                        for (int64_t i = b * HandArchive::kBlockRows; i < end; i++) {
+                                BOOST_TEST(archive.bidAmounts()[i] >= summary.minBid);
+                                BOOST_TEST(archive.bidAmounts()[i] <= summary.maxBid);
+                                BOOST_TEST(archive.points()[i] >= summary.minPoints);
+                                BOOST_TEST(archive.points()[i] <= summary.maxPoints);
+                                BOOST_TEST(((summary.bidders >> archive.bidders()[i]) & 1));
+                                BOOST_TEST((archive.bidderHands()[i] & ~summary.anyBidderCards)
+                                        == 0u);
+                                BOOST_TEST((summary.allBidderCards & ~archive.bidderHands()[i])
+                                        == 0u);
+                        }
+                }
+        }
+        HandArchive::remove(prefix);
+}
+
+// every version, on any number of threads, counts what a scan of the records counts, and the
+// summaries skip the blocks nothing can match in
+BOOST_AUTO_TEST_CASE(CountsMatchABruteForceScan) {
+        IsaGuard guard;
+        std::string prefix = "testArchiveQueries";
+        std::vector<HandRecord> records = playHands(3 * HandArchive::kBlockRows + 45);
+        HandArchive::write(prefix, Span<const HandRecord>(records), 2);
+
+        std::vector<HandQuery> queries(6);
+        // the hands bid in clubs by a bidder holding the 5 and jack of clubs
+        queries[1].minBid = 20;
+        queries[1].trumps = 1 << (Suit::CLUBS - 1);
+        queries[1].bidderHolds.insert(Card(5, Suit::CLUBS));
+        queries[1].bidderHolds.insert(Card(11, Suit::CLUBS));
+        // failed bids from seats 0 and 2 without the ace of hearts
+        queries[2].bidders = 5;
+        queries[2].outcomes = 1;
+        queries[2].bidderLacks.insert(Card(1, Suit::HEARTS));
+        queries[3].minPoints = 15;
+        queries[3].maxPoints = 25;
+        queries[3].bidders = 2;
+        // bags, and bids nobody made
+        queries[4].maxBid = 15;
+        queries[5].minBid = 30;
+
+        {
+                HandArchive archive(prefix);
+                for (TrickKernels::Isa isa : supportedIsas()) {
+                        TrickKernels::setIsa(isa);
+                        for (int threads : {1, 3}) {
+                                for (const HandQuery& query : queries) {
+                                        QueryResult expected = bruteForce(records, query);
+                                        QueryResult result = archive.count(query, threads);
+                                        BOOST_TEST(result.matches == expected.matches);
+                                        BOOST_TEST(result.made == expected.made);
+                                        BOOST_TEST(result.blocksSkipped + result.blocksScanned ==
+                                                archive.numBlocks());
+                                }
+                        }
+                }
+                BOOST_TEST(bruteForce(records, queries[1]).matches > 0);
+                BOOST_TEST(archive.count(queries[0], 1).matches ==
+                        static_cast<int64_t>(records.size()));
+                // trumpKeeper never bids 30
+                QueryResult thirty = archive.count(queries[5], 1);
+                BOOST_TEST(thirty.matches == 0);
+                BOOST_TEST(thirty.blocksSkipped == archive.numBlocks());
+                BOOST_TEST(thirty.madeRate() == 0);
+        }
+        HandArchive::remove(prefix);
+}
+
+// a missing, damaged or short column isn't mapped
+BOOST_AUTO_TEST_CASE(RejectsABadArchive) {
+        std::string prefix = "testArchiveBad";
+        BOOST_CHECK_THROW(HandArchive archive(prefix), std::runtime_error);
+
+        std::vector<HandRecord> records = playHands(100);
+        HandArchive::write(prefix, Span<const HandRecord>(records), 1);
+        BOOST_CHECK_NO_THROW(HandArchive archive(prefix));
+        {
+                std::ofstream out(prefix + ".trump", std::ios::binary | std::ios::app);
+                out.put(1);
+        }
+        BOOST_CHECK_THROW(HandArchive archive(prefix), std::runtime_error);
+
+        // a column from an archive of fewer hands
+        HandArchive::write(prefix, Span<const HandRecord>(records), 1);
+        std::vector<HandRecord> fewer(records.begin(), records.begin() + 50);
+        HandArchive::write(prefix + "Short", Span<const HandRecord>(fewer), 1);
+        std::rename((prefix + "Short.made").c_str(), (prefix + ".made").c_str());
+        BOOST_CHECK_THROW(HandArchive archive(prefix), std::runtime_error);
+        HandArchive::remove(prefix + "Short");
+        HandArchive::remove(prefix);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
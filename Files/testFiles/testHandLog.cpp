@@ -0,0 +1,213 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../basicX45s.hpp"
+#include "../card.hpp"
+#include "../cardSet.hpp"
+#include "../handLog.hpp"
+#include "../handReplay.hpp"
+#include "../player.hpp"
+#include "../suit.hpp"
+
+namespace {
+// bids 20 or 25 in its longest suit if it is long enough, and keeps only its trumps, so the hands
+// have all sorts of bids, bags and draws
+class trumpKeeper final : public Player {
+ public:
+        void discard() override {
+                CardSet trumps = getHandSet() & CardSet::trumpMask(trump);
+                for (auto it = hand.begin(); it != hand.end();) {
+                        bool keep = trumps.contains(*it) || (trumps.empty() && it == hand.begin());
+                        it = keep ? it + 1 : hand.erase(it);
+                }
+                while (hand.size() > 5) {
+                        hand.erase(hand.begin());
+                }
+        }
+        std::pair<int, Suit::Suit> getBid([[maybe_unused]] Span<const int> bidHistory) override {
+                Suit::Suit suit = longestSuit();
+                int length = (getHandSet() & CardSet::trumpMask(suit)).size();
+                return {length >= 4 ? 25 : length == 3 ? 20 : 0, suit};
+        }
+        Suit::Suit bagged() override {
+                return longestSuit();
+        }
+        void bidWon([[maybe_unused]] int bidder, [[maybe_unused]] int amount,
+                Suit::Suit inpTrump) override {
+                trump = inpTrump;
+        }
+        Card playCard([[maybe_unused]] const TrickState& trick) override {
+                return playLastLegalCard();
+        }
+
+ private:
+        Suit::Suit trump = Suit::HEARTS;
+
+        Suit::Suit longestSuit() {
+                Suit::Suit longest = Suit::HEARTS;
+                for (int i = Suit::DIAMONDS; i <= Suit::SPADES; i++) {
+                        Suit::Suit suit = static_cast<Suit::Suit>(i);
+                        if ((getHandSet() & CardSet::trumpMask(suit)).size() >
+                                (getHandSet() & CardSet::trumpMask(longest)).size()) {
+                                longest = suit;
+                        }
+                }
+                return longest;
+        }
+};
+
+using LoggedGame = basic_x45s<trumpKeeper, trumpKeeper, trumpKeeper, trumpKeeper>;
+
+// keeps every record in memory
+class vectorSink : public HandLogSink {
+ public:
+        std::vector<HandRecord> records;
+        void append(const HandRecord& record) override { records.push_back(record); }
+};
+
+bool sameRecord(const HandRecord& a, const HandRecord& b) {
+        return std::memcmp(&a, &b, sizeof(HandRecord)) == 0;
+}
+
+// plays whole games from the seed, and returns the record of every hand
+std::vector<HandRecord> playGames(int games, uint64_t seed, LoggedGame& game) {
+        vectorSink sink;
+        game.setHandLog(&sink);
+        game.seed(seed);
+        for (int i = 0; i < games; i++) {
+                game.newGame();
+                game.playGame();
+        }
+        game.setHandLog(nullptr);
+        return sink.records;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(HandLogTests)
+
+// the record of a hand agrees with what the engine did
+BOOST_AUTO_TEST_CASE(RecordsTheHand) {
+        LoggedGame game;
+        game.seed(45);
+        bool sawBag = false;
+        bool sawDraw = false;
+        for (int hand = 0; hand < 200; hand++) {
+                game.reset();
+                game.shuffle();
+                std::pair<int, bool> result = game.dealBidAndFullFiveTricks();
+                const HandRecord& record = game.getHandRecord();
+                const GameState& state = game.getState();
+                BOOST_TEST(record.startsGame() == (hand == 0));
+                BOOST_TEST(record.bidder() == result.first);
+                BOOST_TEST(record.bidder() == state.bidder);
+                BOOST_TEST(record.bidAmount() == state.bidAmount);
+                BOOST_TEST(record.trump() == state.play.trump);
+                BOOST_TEST((record.dealer() + 1) % 4 == state.dealer);
+                BOOST_TEST(record.points()[0] == state.handScores[0]);
+                BOOST_TEST(record.points()[1] == state.handScores[1]);
+
+                // every card is dealt once, and every card played was held by its player
+                CardSet dealt = record.kiddie();
+                for (int seat = 0; seat < 4; seat++) {
+                        BOOST_TEST((dealt & record.firstHand(seat)).empty());
+                        dealt |= record.firstHand(seat);
+                }
+                BOOST_TEST(dealt.size() == HandRecord::kDealt);
+                std::array<CardSet, 4> played = record.playedHands();
+                CardSet allPlayed;
+                for (int seat = 0; seat < 4; seat++) {
+                        BOOST_TEST(played[seat].size() == 5);
+                        BOOST_TEST((record.kept(seat) - played[seat]).empty());
+                        sawDraw |= played[seat] != record.kept(seat);
+                        allPlayed |= played[seat];
+                }
+                BOOST_TEST(allPlayed == state.played);
+                sawBag |= record.bagged();
+                if (record.bagged()) {
+                        BOOST_TEST(record.bidAmount() == 15);
+                        BOOST_TEST(record.bidder() == record.dealer());
+                }
+        }
+        BOOST_TEST(sawBag);
+        BOOST_TEST(sawDraw);
+}
+
+// records written to a file are mapped back byte for byte, and a second writer adds to the end
+BOOST_AUTO_TEST_CASE(WritesAndReadsALog) {
+        std::string path = "testHandLog.bin";
+        std::remove(path.c_str());
+        LoggedGame game;
+        std::vector<HandRecord> records = playGames(3, 7, game);
+        size_t half = records.size() / 2;
+        {
+                HandLogWriter writer(path);
+                for (size_t i = 0; i < half; i++) {
+                        writer.append(records[i]);
+                }
+        }
+        {
+                // a record cut off at the end is skipped by the reader, and dropped by the writer
+                std::ofstream out(path, std::ios::binary | std::ios::app);
+                out.write("torn", 4);
+        }
+        BOOST_TEST(HandLogReader(path).size() == half);
+        {
+                HandLogWriter writer(path);
+                for (size_t i = half; i < records.size(); i++) {
+                        writer.append(records[i]);
+                }
+                writer.flush();
+        }
+
+        HandLogReader reader(path);
+        BOOST_REQUIRE(reader.size() == records.size());
+        size_t i = 0;
+        for (const HandRecord& record : reader) {
+                BOOST_REQUIRE(sameRecord(record, records[i++]));
+        }
+        std::remove(path.c_str());
+
+        std::string notLog = "testNotHandLog.bin";
+        {
+                std::ofstream out(notLog, std::ios::binary);
+                out << "not a hand log, but long enough to have a header";
+        }
+        BOOST_CHECK_THROW(HandLogReader reader2(notLog), std::runtime_error);
+        BOOST_CHECK_THROW(HandLogWriter writer(notLog), std::runtime_error);
+        std::remove(notLog.c_str());
+}
+
+// replaying a log plays every hand the same way, so it logs the same records and ends with the
+// same scores
+BOOST_AUTO_TEST_CASE(ReplaysALog) {
+        LoggedGame game;
+        std::vector<HandRecord> records = playGames(5, 45, game);
+        BOOST_REQUIRE(records.size() > 20u);
+
+        ReplayGame replay;
+        vectorSink sink;
+        replay.setHandLog(&sink);
+        for (const HandRecord& record : records) {
+                replayHand(replay, record);
+        }
+        BOOST_REQUIRE(sink.records.size() == records.size());
+        for (size_t i = 0; i < records.size(); i++) {
+                BOOST_REQUIRE(sameRecord(sink.records[i], records[i]));
+        }
+        BOOST_TEST(replay.getTeamScore(0) == game.getTeamScore(0));
+        BOOST_TEST(replay.getTeamScore(1) == game.getTeamScore(1));
+
+        // a hand can't be replayed with the wrong dealer
+        HandRecord second = records[1];
+        BOOST_REQUIRE(!second.startsGame());
+        ReplayGame fresh;
+        BOOST_CHECK_THROW(replayHand(fresh, second), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
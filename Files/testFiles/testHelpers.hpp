@@ -0,0 +1,39 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <array>
+#include <vector>
+#include "../card.hpp"
+#include "../cardSet.hpp"
+#include "../suit.hpp"
+#include "../trickKernels.hpp"
+#include "../trickState.hpp"
+
+// helpers shared by more than one test file
+
+// the trick in progress as the engine gives it to a player: cards by player, led by leader
+inline TrickState trickState(const std::array<Card, 4>& cards, int leader, Suit::Suit trump) {
+        TrickState state(trump, leader, 0, CardSet());
+        while (!state.complete() && cards[state.toPlay()].isValid()) {
+                state.play(cards[state.toPlay()]);
+        }
+        return state;
+}
+
+// every version of the trick kernels this CPU can run
+inline std::vector<TrickKernels::Isa> supportedIsas() {
+        std::vector<TrickKernels::Isa> isas;
+        for (int i = 0; i <= static_cast<int>(TrickKernels::bestIsa()); i++) {
+                isas.push_back(static_cast<TrickKernels::Isa>(i));
+        }
+        return isas;
+}
+
+// puts back the version in use when the test ends
+class IsaGuard {
+ public:
+        IsaGuard() : isa(TrickKernels::getIsa()) {}
+        ~IsaGuard() { TrickKernels::setIsa(isa); }
+
+ private:
+        TrickKernels::Isa isa;
+};
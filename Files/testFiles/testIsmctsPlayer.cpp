@@ -0,0 +1,120 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include <array>
+#include <memory>
+#include <vector>
+#include "../45s.hpp"
+#include "../card.hpp"
+#include "../cardSet.hpp"
+#include "../deck.hpp"
+#include "../ismctsPlayer.hpp"
+#include "../random.hpp"
+#include "../rules.hpp"
+#include "../suit.hpp"
+#include "../trickState.hpp"
+#include "testHelpers.hpp"
+
+namespace {
+// no time limit, so the decisions only depend on the seed
+IsmctsPlayer::Options fixedOptions(uint64_t seed, int iterations = 500) {
+        IsmctsPlayer::Options options;
+        options.iterations = iterations;
+        options.timeBudgetMs = 1e9;
+        options.seed = seed;
+        options.nodesPerThread = 1 << 14;
+        return options;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(IsmctsPlayerTests)
+
+// last to play, with the opponents winning the trick: take it with the 5 of trump
+BOOST_AUTO_TEST_CASE(TakesTheTrickWithTheFive) {
+        IsmctsPlayer player(fixedOptions(7));
+        player.seated(3);
+        player.bidWon(0, 20, Suit::SPADES);
+        for (int first : {2, 6}) {
+                std::array<Card, 4> cards = {Card(first, Suit::CLUBS), Card(first + 1, Suit::CLUBS),
+                        Card(first + 2, Suit::CLUBS), Card(first + 3, Suit::CLUBS)};
+                player.trickPlayed(Span<const Card>(cards), 0, 0);
+        }
+        player.dealCard(Card(2, Suit::DIAMONDS));
+        player.dealCard(Card(5, Suit::SPADES));
+        player.dealCard(Card(7, Suit::HEARTS));
+
+        std::array<Card, 4> current = {Card(1, Suit::DIAMONDS), Card(3, Suit::DIAMONDS),
+                Card(13, Suit::DIAMONDS), Card()};
+        BOOST_TEST(player.playCard(trickState(current, 0, Suit::SPADES)) == Card(5, Suit::SPADES));
+        BOOST_TEST(player.getLastIterations() == 500);
+}
+
+// the tree grows through the hand and is only emptied by resetHand
+BOOST_AUTO_TEST_CASE(KeepsTheTreeForTheHand) {
+        IsmctsPlayer searching(fixedOptions(1, 200));
+        searching.seated(0);
+        searching.bidWon(0, 15, Suit::HEARTS);
+        for (Card c : {Card(5, Suit::HEARTS), Card(2, Suit::CLUBS), Card(3, Suit::DIAMONDS),
+                Card(4, Suit::SPADES), Card(11, Suit::HEARTS)}) {
+                searching.dealCard(c);
+        }
+        std::array<Card, 4> noCards;
+        Card led = searching.playCard(trickState(noCards, 0, Suit::HEARTS));
+        int64_t nodes = searching.getNodes();
+        BOOST_TEST(nodes > 1);
+
+        // the rest of the trick, then the next lead goes on from the same tree
+        std::array<Card, 4> trick = {led, Card(6, Suit::SPADES), Card(7, Suit::SPADES),
+                Card(8, Suit::SPADES)};
+        searching.trickPlayed(Span<const Card>(trick), 0, 0);
+        searching.playCard(trickState(noCards, 0, Suit::HEARTS));
+        BOOST_TEST(searching.getNodes() > nodes);
+        searching.resetHand();
+        BOOST_TEST(searching.getNodes() == 0);
+        BOOST_TEST(searching.getSize() == 0);
+}
+
+// whatever is led, the card played is legal and leaves the hand
+BOOST_AUTO_TEST_CASE(PlaysLegalCards) {
+        Xoshiro256StarStar rng(45);
+        for (int deal = 0; deal < 20; deal++) {
+                Deck deck(rng());
+                deck.shuffle();
+                Suit::Suit trump = static_cast<Suit::Suit>(1 + deal % 4);
+                IsmctsPlayer player(fixedOptions(deal, 100));
+                player.seated(1);
+                player.bidWon(0, 15, trump);
+                for (int i = 0; i < 5; i++) {
+                        player.dealCard(deck.pop_back());
+                }
+                CardSet hand = player.getHandSet();
+                std::array<Card, 4> current;
+                current[0] = deck.pop_back();
+
+                Card c = player.playCard(trickState(current, 0, trump));
+                BOOST_TEST(Rules::legalPlays(hand, current[0], trump).contains(c));
+                BOOST_CHECK(player.getHandSet() == hand - CardSet(c));
+        }
+}
+
+// with no time limit, players with the same seeds play the same games, on any number of threads
+BOOST_AUTO_TEST_CASE(SameSeedPlaysTheSameGame) {
+        std::vector<std::unique_ptr<IsmctsPlayer>> first;
+        std::vector<std::unique_ptr<IsmctsPlayer>> second;
+        for (int i = 0; i < 4; i++) {
+                IsmctsPlayer::Options options = fixedOptions(i, 100);
+                options.numThreads = 2;
+                first.push_back(std::make_unique<IsmctsPlayer>(options));
+                second.push_back(std::make_unique<IsmctsPlayer>(options));
+        }
+        x45s game1(first[0].get(), first[1].get(), first[2].get(), first[3].get());
+        x45s game2(second[0].get(), second[1].get(), second[2].get(), second[3].get());
+        game1.seed(45);
+        game2.seed(45);
+        int hands = game1.playGame();
+        BOOST_TEST(hands == game2.playGame());
+        BOOST_TEST(game1.hasWon());
+        BOOST_TEST(game1.getTeamScore(0) == game2.getTeamScore(0));
+        BOOST_TEST(game1.getTeamScore(1) == game2.getTeamScore(1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,127 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include <array>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "../cardSet.hpp"
+#include "../deck.hpp"
+#include "../parallelSolver.hpp"
+#include "../random.hpp"
+#include "../solver.hpp"
+#include "../suit.hpp"
+#include "../transpositionTable.hpp"
+
+namespace {
+// deals 5 cards to everyone, and 3 more to extra if it is 0-3
+std::array<CardSet, 4> randomHands(Xoshiro256StarStar& rng, int extra = -1) {
+        Deck deck(rng());
+        deck.shuffle();
+        std::array<CardSet, 4> hands;
+        for (int player = 0; player < 4; player++) {
+                int cards = player == extra ? 8 : 5;
+                for (int i = 0; i < cards; i++) {
+                        hands[player].insert(deck.pop_back());
+                }
+        }
+        return hands;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(ParallelSolverTests)
+
+BOOST_AUTO_TEST_CASE(TableKeepsBounds) {
+        TranspositionTable table(8);
+        int lower = -1;
+        int upper = -1;
+        BOOST_TEST(!table.probe(12345, lower, upper));
+        table.store(12345, 10, 20, 3);
+        BOOST_TEST(table.probe(12345, lower, upper));
+        BOOST_TEST(lower == 10);
+        BOOST_TEST(upper == 20);
+        // storing the same key again replaces its bounds
+        table.store(12345, 15, 15, 3);
+        BOOST_TEST(table.probe(12345, lower, upper));
+        BOOST_TEST(lower == 15);
+        BOOST_TEST(upper == 15);
+        table.clear();
+        BOOST_TEST(!table.probe(12345, lower, upper));
+        BOOST_CHECK_THROW(TranspositionTable(1), std::invalid_argument);
+}
+
+// threads writing the same small table never read back bounds that were stored for another key
+BOOST_AUTO_TEST_CASE(TableIsSafeAcrossThreads) {
+        TranspositionTable table(4);
+        std::vector<std::thread> threads;
+        std::atomic<int> wrong(0);
+        for (int t = 0; t < 4; t++) {
+                threads.emplace_back([&table, &wrong, t] {
+                        Xoshiro256StarStar rng(t);
+                        for (int i = 0; i < 100000; i++) {
+                                // the bounds are a function of the key, so they can be checked
+                                uint64_t key = rng() % 64 + 1;
+                                int bound = static_cast<int>(key % 31);
+                                if (i % 2 == 0) {
+                                        table.store(key, bound, bound, 1);
+                                } else {
+                                        int lower, upper;
+                                        if (table.probe(key, lower, upper) &&
+                                                (lower != bound || upper != bound)) {
+                                                wrong++;
+                                        }
+                                }
+                        }
+                });
+        }
+        for (auto& thread : threads) {
+                thread.join();
+        }
+        BOOST_TEST(wrong == 0);
+}
+
+// Lazy SMP finds the same points as one thread
+BOOST_AUTO_TEST_CASE(ParallelSolveMatchesSerial) {
+        Xoshiro256StarStar rng(45);
+        DoubleDummySolver serial;
+        ParallelSolver parallel(4, 16);
+        BOOST_TEST(parallel.getNumThreads() == 4);
+        for (int i = 0; i < 40; i++) {
+                std::array<CardSet, 4> hands = randomHands(rng);
+                Suit::Suit trump = static_cast<Suit::Suit>(1 + i % 4);
+                BOOST_REQUIRE_EQUAL(parallel.solve(hands, trump, i % 4),
+                        serial.solve(hands, trump, i % 4));
+        }
+}
+
+BOOST_AUTO_TEST_CASE(AnalyzeDiscards) {
+        Xoshiro256StarStar rng(7);
+        std::array<CardSet, 4> hands = randomHands(rng, 1);
+        ParallelSolver parallel(3, 16);
+        std::vector<DiscardOption> options = parallel.analyzeDiscards(hands, 1, Suit::HEARTS);
+        // 8 choose 5
+        BOOST_REQUIRE_EQUAL(options.size(), 56u);
+
+        DoubleDummySolver serial;
+        for (size_t i = 0; i < options.size(); i++) {
+                BOOST_TEST(options[i].keep.size() == 5);
+                BOOST_TEST((options[i].keep - hands[1]).empty());
+                if (i > 0) {
+                        BOOST_TEST(options[i - 1].points >= options[i].points);
+                }
+                std::array<CardSet, 4> dealt = hands;
+                dealt[1] = options[i].keep;
+                BOOST_TEST(options[i].points == 30 - serial.solve(dealt, Suit::HEARTS, 1));
+        }
+
+        // more than the hand and the kiddie
+        std::array<CardSet, 4> tooMany = hands;
+        tooMany[1] |= hands[0];
+        BOOST_CHECK_THROW(parallel.analyzeDiscards(tooMany, 1, Suit::HEARTS),
+                std::invalid_argument);
+        tooMany[1] = CardSet::all();
+        BOOST_CHECK_THROW(parallel.analyzeDiscards(tooMany, 1, Suit::HEARTS),
+                std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
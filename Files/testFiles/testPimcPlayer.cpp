@@ -0,0 +1,173 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include <array>
+#include <memory>
+#include <vector>
+#include "../45s.hpp"
+#include "../card.hpp"
+#include "../cardSet.hpp"
+#include "../deck.hpp"
+#include "../ismctsPlayer.hpp"
+#include "../parallel.hpp"
+#include "../pimcPlayer.hpp"
+#include "../random.hpp"
+#include "../rules.hpp"
+#include "../suit.hpp"
+#include "../trickState.hpp"
+#include "testHelpers.hpp"
+
+namespace {
+// few samples and no time limit, so the decisions only depend on the seed
+PimcPlayer::Options fixedOptions(uint64_t seed) {
+        PimcPlayer::Options options;
+        options.maxSamples = 6;
+        options.timeBudgetMs = 1e9;
+        options.seed = seed;
+        options.tableBits = 12;
+        return options;
+}
+
+// a trick led by leader, with the cards in the order they were played
+std::array<Card, 4> trick(int leader, Card first, Card second, Card third, Card fourth) {
+        std::array<Card, 4> cards;
+        Card inOrder[4] = {first, second, third, fourth};
+        for (int i = 0; i < 4; i++) {
+                cards[(leader + i) % 4] = inOrder[i];
+        }
+        return cards;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(PimcPlayerTests)
+
+// the top 5 trumps take every trick and the high card, so they are always worth 30
+BOOST_AUTO_TEST_CASE(BidsThirtyWithTheTopTrumps) {
+        PimcPlayer player(fixedOptions(45));
+        player.seated(1);
+        for (int value : {5, 11, 1, 13, 12}) {
+                player.dealCard(Card(value, Suit::HEARTS));
+        }
+        std::vector<int> bids = {20};
+        std::pair<int, Suit::Suit> bid = player.getBid(Span<const int>(bids));
+        BOOST_TEST(bid.first == 30);
+        BOOST_TEST(bid.second == Suit::HEARTS);
+        BOOST_TEST(player.bagged() == Suit::HEARTS);
+        BOOST_TEST(player.getLastSamples() == 6);
+}
+
+// last to play, with the opponents winning the trick: take it with the 5 of trump
+BOOST_AUTO_TEST_CASE(TakesTheTrickWithTheFive) {
+        PimcPlayer player(fixedOptions(7));
+        player.seated(3);
+        player.bidWon(0, 20, Suit::SPADES);
+        std::array<std::array<Card, 4>, 3> tricks = {
+                trick(0, Card(2, Suit::HEARTS), Card(3, Suit::HEARTS), Card(4, Suit::HEARTS),
+                        Card(6, Suit::HEARTS)),
+                trick(0, Card(2, Suit::CLUBS), Card(3, Suit::CLUBS), Card(4, Suit::CLUBS),
+                        Card(5, Suit::CLUBS)),
+                trick(0, Card(6, Suit::CLUBS), Card(7, Suit::CLUBS), Card(8, Suit::CLUBS),
+                        Card(9, Suit::CLUBS))};
+        for (const auto& cards : tricks) {
+                player.trickPlayed(Span<const Card>(cards), 0, 0);
+        }
+        player.dealCard(Card(2, Suit::DIAMONDS));
+        player.dealCard(Card(5, Suit::SPADES));
+
+        std::array<Card, 4> current = {Card(1, Suit::DIAMONDS), Card(3, Suit::DIAMONDS),
+                Card(13, Suit::DIAMONDS), Card()};
+        BOOST_TEST(player.playCard(trickState(current, 0, Suit::SPADES)) == Card(5, Suit::SPADES));
+        BOOST_CHECK(player.getHandSet() == CardSet(Card(2, Suit::DIAMONDS)));
+}
+
+// whatever is led, the card played is legal and leaves the hand
+BOOST_AUTO_TEST_CASE(PlaysLegalCards) {
+        Xoshiro256StarStar rng(45);
+        for (int deal = 0; deal < 20; deal++) {
+                Deck deck(rng());
+                deck.shuffle();
+                Suit::Suit trump = static_cast<Suit::Suit>(1 + deal % 4);
+                PimcPlayer player(fixedOptions(deal));
+                player.seated(1);
+                player.bidWon(0, 15, trump);
+                for (int i = 0; i < 5; i++) {
+                        player.dealCard(deck.pop_back());
+                }
+                CardSet hand = player.getHandSet();
+                std::array<Card, 4> current;
+                current[0] = deck.pop_back();
+
+                Card c = player.playCard(trickState(current, 0, trump));
+                BOOST_TEST(Rules::legalPlays(hand, current[0], trump).contains(c));
+                BOOST_CHECK(player.getHandSet() == hand - CardSet(c));
+        }
+}
+
+// with no time limit, players with the same seeds play the same games
+BOOST_AUTO_TEST_CASE(SameSeedPlaysTheSameGame) {
+        std::vector<std::unique_ptr<PimcPlayer>> first;
+        std::vector<std::unique_ptr<PimcPlayer>> second;
+        for (int i = 0; i < 4; i++) {
+                first.push_back(std::make_unique<PimcPlayer>(fixedOptions(i)));
+                second.push_back(std::make_unique<PimcPlayer>(fixedOptions(i)));
+        }
+        x45s game1(first[0].get(), first[1].get(), first[2].get(), first[3].get());
+        x45s game2(second[0].get(), second[1].get(), second[2].get(), second[3].get());
+        game1.seed(45);
+        game2.seed(45);
+        int hands = game1.playGame();
+        BOOST_TEST(hands == game2.playGame());
+        BOOST_TEST(game1.hasWon());
+        BOOST_TEST(game1.getTeamScore(0) == game2.getTeamScore(0));
+        BOOST_TEST(game1.getTeamScore(1) == game2.getTeamScore(1));
+}
+
+// the clock is checked before every sample, so with no time at all only the first one is solved
+BOOST_AUTO_TEST_CASE(StopsAtTheTimeBudget) {
+        PimcPlayer::Options options = fixedOptions(45);
+        options.maxSamples = 1000;
+        options.timeBudgetMs = 0;
+        PimcPlayer player(options);
+        player.seated(0);
+        for (Card c : {Card(5, Suit::HEARTS), Card(11, Suit::HEARTS), Card(1, Suit::HEARTS),
+                Card(13, Suit::CLUBS), Card(2, Suit::SPADES)}) {
+                player.dealCard(c);
+        }
+        player.getBid(Span<const int>());
+        BOOST_TEST(player.getLastSamples() == 1);
+}
+
+// players sharing one pool play the same game as players with pools of their own
+BOOST_AUTO_TEST_CASE(PlayersShareAPool) {
+        ThreadPool pool(2);
+        std::vector<std::unique_ptr<Player>> shared;
+        std::vector<std::unique_ptr<Player>> own;
+        for (int i = 0; i < 4; i++) {
+                if (i % 2 == 0) {
+                        PimcPlayer::Options options = fixedOptions(i);
+                        options.numThreads = 2;
+                        own.push_back(std::make_unique<PimcPlayer>(options));
+                        options.pool = &pool;
+                        shared.push_back(std::make_unique<PimcPlayer>(options));
+                } else {
+                        IsmctsPlayer::Options options;
+                        options.iterations = 100;
+                        options.timeBudgetMs = 1e9;
+                        options.seed = i;
+                        options.nodesPerThread = 1 << 12;
+                        options.numThreads = 2;
+                        own.push_back(std::make_unique<IsmctsPlayer>(options));
+                        options.pool = &pool;
+                        shared.push_back(std::make_unique<IsmctsPlayer>(options));
+                }
+        }
+        x45s game1(shared[0].get(), shared[1].get(), shared[2].get(), shared[3].get());
+        x45s game2(own[0].get(), own[1].get(), own[2].get(), own[3].get());
+        game1.seed(45);
+        game2.seed(45);
+        int hands = game1.playGame();
+        BOOST_TEST(hands == game2.playGame());
+        BOOST_TEST(game1.getTeamScore(0) == game2.getTeamScore(0));
+        BOOST_TEST(game1.getTeamScore(1) == game2.getTeamScore(1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
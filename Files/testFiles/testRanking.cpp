@@ -0,0 +1,119 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "../cardSet.hpp"
+#include "../deck.hpp"
+#include "../random.hpp"
+#include "../ranking.hpp"
+
+namespace {
+// k random cards out of among
+CardSet randomCards(Xoshiro256StarStar& rng, int k, CardSet among = CardSet::all()) {
+        CardSet cards;
+        while (cards.size() < k) {
+                std::vector<Card> left = (among - cards).toVector();
+                cards.insert(left[boundedRandom(rng, left.size())]);
+        }
+        return cards;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(RankingTests)
+
+BOOST_AUTO_TEST_CASE(CountsAreRight) {
+        BOOST_TEST(Ranking::kNumHands == 2598960);
+        BOOST_TEST(Ranking::kNumKiddieHands == 752538150);
+        // 52! / (5!^4 3! 29!) = 7332183703639194339369830400
+        Ranking::DealRank deals = Ranking::kNumDeals;
+        BOOST_TEST(static_cast<uint64_t>(deals >> 64) == 397478475ULL);
+        BOOST_TEST(static_cast<uint64_t>(deals) == 505834170108364800ULL);
+}
+
+BOOST_AUTO_TEST_CASE(RankAndUnrankAreInverses) {
+        Xoshiro256StarStar rng(45);
+        for (int k = 1; k <= Ranking::kMaxCards; k++) {
+                uint64_t count = Ranking::choose(Card::kNumCards, k);
+                BOOST_CHECK(Ranking::unrank(0, k) == CardSet((uint64_t{1} << k) - 1));
+                BOOST_TEST(Ranking::rank(Ranking::unrank(count - 1, k)) == count - 1);
+                for (int i = 0; i < 200; i++) {
+                        CardSet cards = randomCards(rng, k);
+                        uint64_t index = Ranking::rank(cards);
+                        BOOST_REQUIRE(index < count);
+                        BOOST_REQUIRE(Ranking::unrank(index, k) == cards);
+
+                        CardSet among = randomCards(rng, 40) | cards;
+                        uint64_t within = Ranking::rankWithin(cards, among);
+                        BOOST_REQUIRE(within < Ranking::choose(among.size(), k));
+                        BOOST_REQUIRE(Ranking::unrankWithin(within, k, among) == cards);
+                }
+        }
+}
+
+// stepping with nextCombination goes through the ranks in order
+BOOST_AUTO_TEST_CASE(NextCombinationIsTheNextRank) {
+        CardSet cards = Ranking::unrank(0, 3);
+        for (uint64_t index = 0; index < Ranking::choose(20, 3); index++) {
+                BOOST_REQUIRE(Ranking::rank(cards) == index);
+                cards = Ranking::nextCombination(cards);
+        }
+}
+
+BOOST_AUTO_TEST_CASE(DealsRoundTrip) {
+        Xoshiro256StarStar rng(7);
+        for (int i = 0; i < 500; i++) {
+                Deck deck(rng());
+                deck.shuffle();
+                Ranking::Deal deal;
+                for (CardSet& hand : deal.hands) {
+                        for (int c = 0; c < 5; c++) {
+                                hand.insert(deck.pop_back());
+                        }
+                }
+                for (int c = 0; c < 3; c++) {
+                        deal.kiddie.insert(deck.pop_back());
+                }
+                Ranking::DealRank index = Ranking::rankDeal(deal);
+                BOOST_REQUIRE(index < Ranking::kNumDeals);
+                Ranking::Deal back = Ranking::unrankDeal(index);
+                for (int p = 0; p < 4; p++) {
+                        BOOST_REQUIRE(back.hands[p] == deal.hands[p]);
+                }
+                BOOST_REQUIRE(back.kiddie == deal.kiddie);
+        }
+        Ranking::Deal last = Ranking::unrankDeal(Ranking::kNumDeals - 1);
+        BOOST_CHECK(Ranking::rankDeal(last) == Ranking::kNumDeals - 1);
+        BOOST_CHECK(Ranking::rankDeal(Ranking::unrankDeal(0)) == 0);
+}
+
+// every 5 card hand is visited exactly once, whatever the threads
+BOOST_AUTO_TEST_CASE(ParallelEnumerationVisitsEveryHand) {
+        std::vector<std::atomic<uint8_t>> seen(Ranking::kNumHands);
+        std::atomic<int> wrong(0);
+        Ranking::parallelForEachCombination(5, 0, Ranking::kNumHands, 4,
+                [&](int, uint64_t index, CardSet hand) {
+                        if (Ranking::rank(hand) != index) {
+                                wrong++;
+                        }
+                        seen[index]++;
+                });
+        BOOST_TEST(wrong == 0);
+        for (const auto& count : seen) {
+                BOOST_REQUIRE(count == 1);
+        }
+        BOOST_CHECK_THROW(Ranking::parallelForEachCombination(5, 0, Ranking::kNumHands + 1, 1,
+                [](int, uint64_t, CardSet) {}), std::invalid_argument);
+}
+
+// a range that ends before it begins throws, and an empty one visits nothing
+BOOST_AUTO_TEST_CASE(ParallelEnumerationRejectsABackwardsRange) {
+        std::atomic<int> visited(0);
+        auto count = [&](int, uint64_t, CardSet) { visited++; };
+        BOOST_CHECK_THROW(Ranking::parallelForEachCombination(5, 10, 9, 2, count),
+                std::invalid_argument);
+        Ranking::parallelForEachCombination(5, 10, 10, 2, count);
+        BOOST_TEST(visited == 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,130 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include "../parallel.hpp"
+#include "../player.hpp"
+#include "../simulator.hpp"
+
+namespace {
+// bids 20 in hearts when nobody has bid yet, and plays its cards in the order it got them
+class firstBidder : public Player {
+public:
+        void discard() override {
+                while (hand.size() > 5) {
+                        hand.pop_back();
+                }
+        }
+        std::pair<int, Suit::Suit> getBid(Span<const int> bidHistory) override {
+                for (int bid : bidHistory) {
+                        if (bid != 0) {
+                                return {0, Suit::HEARTS};
+                        }
+                }
+                return {20, Suit::HEARTS};
+        }
+        Suit::Suit bagged() override {
+                return Suit::HEARTS;
+        }
+        Card playCard([[maybe_unused]] const TrickState& trick) override {
+                return playLastLegalCard();
+        }
+};
+
+Simulator makeSimulator() {
+        return Simulator([]{return new firstBidder;}, []{return new firstBidder;},
+                []{return new firstBidder;}, []{return new firstBidder;});
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(SimulatorTests)
+
+// every index is run exactly once, whatever the thread count and grain
+BOOST_AUTO_TEST_CASE(ParallelForRunsEveryIndexOnce) {
+        for (int threads : {1, 3, 8}) {
+                std::vector<std::atomic<int>> counts(1000);
+                parallelFor(0, 1000, threads, 7, [&](int t, int64_t i) {
+                        BOOST_REQUIRE(t >= 0 && t < threads);
+                        counts[i]++;
+                });
+                for (const auto& count : counts) {
+                        BOOST_REQUIRE_EQUAL(count.load(), 1);
+                }
+        }
+}
+
+BOOST_AUTO_TEST_CASE(ParallelForRethrows) {
+        BOOST_CHECK_THROW(parallelFor(0, 100, 4, 1, [](int, int64_t i) {
+                if (i == 50) {
+                        throw std::invalid_argument("50");
+                }
+        }), std::invalid_argument);
+}
+
+// every run calls the body once on every thread, and the pool is used again after a throw
+BOOST_AUTO_TEST_CASE(ThreadPoolRunsEveryThread) {
+        for (int threads : {1, 3}) {
+                ThreadPool pool(threads);
+                BOOST_TEST(pool.size() == threads);
+                std::vector<std::atomic<int>> calls(threads);
+                for (int run = 0; run < 100; run++) {
+                        pool.run([&](int t) {
+                                BOOST_REQUIRE(t >= 0 && t < threads);
+                                calls[t]++;
+                        });
+                }
+                for (const auto& count : calls) {
+                        BOOST_REQUIRE_EQUAL(count.load(), 100);
+                }
+                BOOST_CHECK_THROW(pool.run([](int t) {
+                        if (t == 0) {
+                                throw std::invalid_argument("0");
+                        }
+                }), std::invalid_argument);
+                std::atomic<int> after(0);
+                pool.run([&](int) { after++; });
+                BOOST_TEST(after == threads);
+        }
+}
+
+BOOST_AUTO_TEST_CASE(ResultsAddUp) {
+        Simulator simulator = makeSimulator();
+        SimulationResults results = simulator.run(200, 4, 45);
+        BOOST_TEST(results.games == 200);
+        BOOST_TEST(results.gamesWon[0] + results.gamesWon[1] + results.unfinishedGames == 200);
+        int64_t bids = 0;
+        for (int bid = 0; bid <= SimulationResults::kMaxBid; bid++) {
+                BOOST_TEST(results.bidsMade[bid] <= results.bidsAttempted[bid]);
+                bids += results.bidsAttempted[bid];
+        }
+        // every hand has exactly one bid
+        BOOST_TEST(bids == results.hands);
+        BOOST_TEST(results.averageHandsPerGame() > 1);
+        BOOST_TEST(results.winRate(0) + results.winRate(1) == 1,
+                boost::test_tools::tolerance(1e-9));
+}
+
+// the games are seeded by their number, so the thread count doesn't change the results
+BOOST_AUTO_TEST_CASE(ResultsDontDependOnThreads) {
+        Simulator simulator = makeSimulator();
+        SimulationResults one = simulator.run(100, 1, 7);
+        SimulationResults many = simulator.run(100, 6, 7);
+        BOOST_TEST(one.hands == many.hands);
+        BOOST_TEST(one.gamesWon[0] == many.gamesWon[0]);
+        BOOST_TEST(one.gamesWon[1] == many.gamesWon[1]);
+        for (int bid = 0; bid <= SimulationResults::kMaxBid; bid++) {
+                BOOST_TEST(one.bidsMade[bid] == many.bidsMade[bid]);
+                BOOST_TEST(one.bidsAttempted[bid] == many.bidsAttempted[bid]);
+        }
+}
+
+BOOST_AUTO_TEST_CASE(UnfinishedGamesAreCounted) {
+        Simulator simulator = makeSimulator();
+        simulator.setMaxHandsPerGame(1);
+        SimulationResults results = simulator.run(20, 2, 1);
+        BOOST_TEST(results.unfinishedGames == 20);
+        BOOST_TEST(results.hands == 20);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,232 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include "../card.hpp"
+#include "../cardSet.hpp"
+#include "../deck.hpp"
+#include "../random.hpp"
+#include "../rules.hpp"
+#include "../searchPosition.hpp"
+#include "../solver.hpp"
+#include "../suit.hpp"
+
+namespace {
+// plain minimax over every legal card, with no pruning or merging
+int referenceSolve(const PlayPosition& position) {
+        if (position.tricksLeft() == 0) {
+                return position.highCardPlayer % 2 == 0 ? 5 : 0;
+        }
+        bool maximizing = position.toPlay() % 2 == 0;
+        int best = maximizing ? -1 : 1000;
+        CardSet legal = Rules::legalPlays(position.hands[position.toPlay()], position.led(),
+                position.trump);
+        for (Card c : legal) {
+                PlayPosition next = position;
+                int value = next.play(c);
+                value += referenceSolve(next);
+                best = maximizing ? std::max(best, value) : std::min(best, value);
+        }
+        return best;
+}
+
+PlayPosition randomDeal(Xoshiro256StarStar& rng) {
+        Deck deck(rng());
+        deck.shuffle();
+        std::array<CardSet, 4> hands;
+        for (CardSet& hand : hands) {
+                for (int i = 0; i < 5; i++) {
+                        hand.insert(deck.pop_back());
+                }
+        }
+        Suit::Suit trump = static_cast<Suit::Suit>(1 + boundedRandom(rng, 4));
+        return PlayPosition(hands, trump, boundedRandom(rng, 4));
+}
+
+// plays random legal cards
+void playRandomly(PlayPosition& position, int plays, Xoshiro256StarStar& rng) {
+        for (int i = 0; i < plays; i++) {
+                CardSet legal = Rules::legalPlays(position.hands[position.toPlay()],
+                        position.led(), position.trump);
+                std::vector<Card> cards = legal.toVector();
+                position.play(cards[boundedRandom(rng, cards.size())]);
+        }
+}
+
+bool samePosition(const PlayPosition& lhs, const PlayPosition& rhs) {
+        bool same = lhs.hands == rhs.hands && lhs.trump == rhs.trump &&
+                lhs.leader == rhs.leader && lhs.trickSize == rhs.trickSize &&
+                lhs.highCardPlayer == rhs.highCardPlayer && lhs.highCard == rhs.highCard;
+        for (int i = 0; i < lhs.trickSize; i++) {
+                same = same && lhs.trick[i] == rhs.trick[i];
+        }
+        return same;
+}
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(SolverTests)
+
+BOOST_AUTO_TEST_CASE(MustFollowSuitOrTrump) {
+        // clubs are trump, the king of diamonds is led
+        CardSet hand(Card(2, Suit::DIAMONDS), Card(3, Suit::CLUBS), Card(4, Suit::SPADES),
+                Card(0xACE, Suit::HEARTS));
+        CardSet legal = Rules::legalPlays(hand, Card(13, Suit::DIAMONDS), Suit::CLUBS);
+        BOOST_CHECK(legal == CardSet(Card(2, Suit::DIAMONDS), Card(3, Suit::CLUBS),
+                Card(0xACE, Suit::HEARTS)));
+        // without a diamond anything goes
+        hand.remove(Card(2, Suit::DIAMONDS));
+        BOOST_CHECK(Rules::legalPlays(hand, Card(13, Suit::DIAMONDS), Suit::CLUBS) == hand);
+        // leading is always free
+        BOOST_CHECK(Rules::legalPlays(hand, Card(), Suit::CLUBS) == hand);
+}
+
+BOOST_AUTO_TEST_CASE(AceOfHeartsLedIsTrumpLed) {
+        CardSet hand(Card(2, Suit::HEARTS), Card(3, Suit::SPADES), Card(4, Suit::DIAMONDS));
+        CardSet legal = Rules::legalPlays(hand, Card(0xACE, Suit::HEARTS), Suit::SPADES);
+        BOOST_CHECK(legal == CardSet(Card(3, Suit::SPADES)));
+}
+
+BOOST_AUTO_TEST_CASE(TopTrumpsCanBeReneged) {
+        // the 5 of spades doesn't have to be played on a low trump
+        CardSet hand(Card(5, Suit::SPADES), Card(4, Suit::DIAMONDS));
+        BOOST_CHECK(Rules::legalPlays(hand, Card(7, Suit::SPADES), Suit::SPADES) == hand);
+        // but it does if the player has a lower trump too
+        hand.insert(Card(2, Suit::SPADES));
+        BOOST_CHECK(Rules::legalPlays(hand, Card(7, Suit::SPADES), Suit::SPADES) ==
+                CardSet(Card(5, Suit::SPADES), Card(2, Suit::SPADES)));
+        // the jack can't be reneged when the 5 is led
+        CardSet jack(Card(11, Suit::SPADES), Card(4, Suit::DIAMONDS));
+        BOOST_CHECK(Rules::legalPlays(jack, Card(5, Suit::SPADES), Suit::SPADES) ==
+                CardSet(Card(11, Suit::SPADES)));
+        // the ace of hearts can be reneged on the king, but not on the jack
+        CardSet ace(Card(0xACE, Suit::HEARTS), Card(4, Suit::DIAMONDS));
+        BOOST_CHECK(Rules::legalPlays(ace, Card(13, Suit::SPADES), Suit::SPADES) == ace);
+        BOOST_CHECK(Rules::legalPlays(ace, Card(11, Suit::SPADES), Suit::SPADES) ==
+                CardSet(Card(0xACE, Suit::HEARTS)));
+}
+
+BOOST_AUTO_TEST_CASE(PlayScoresTricksLikeTheEngine) {
+        std::array<CardSet, 4> hands = {CardSet(Card(5, Suit::CLUBS)),
+                CardSet(Card(2, Suit::CLUBS)), CardSet(Card(1, Suit::DIAMONDS)),
+                CardSet(Card(13, Suit::DIAMONDS))};
+        PlayPosition position(hands, Suit::CLUBS, 1);
+        BOOST_TEST(position.play(Card(2, Suit::CLUBS)) == 0);
+        BOOST_TEST(position.play(Card(1, Suit::DIAMONDS)) == 0);
+        BOOST_TEST(position.play(Card(13, Suit::DIAMONDS)) == 0);
+        // player 0 wins with the 5 of clubs
+        BOOST_TEST(position.play(Card(5, Suit::CLUBS)) == 5);
+        BOOST_TEST(position.leader == 0);
+        BOOST_TEST(position.highCardPlayer == 0);
+        BOOST_CHECK(position.highCard == Card(5, Suit::CLUBS));
+        BOOST_TEST(position.tricksLeft() == 0);
+}
+
+// the solver agrees with plain minimax from random positions of the last three tricks
+BOOST_AUTO_TEST_CASE(MatchesMinimax) {
+        Xoshiro256StarStar rng(45);
+        DoubleDummySolver solver(12);
+        for (int i = 0; i < 300; i++) {
+                PlayPosition position = randomDeal(rng);
+                playRandomly(position, 8 + boundedRandom(rng, 12), rng);
+                BOOST_REQUIRE_EQUAL(solver.solve(position), referenceSolve(position));
+        }
+}
+
+BOOST_AUTO_TEST_CASE(MatchesMinimaxOnFourTricks) {
+        Xoshiro256StarStar rng(7);
+        DoubleDummySolver solver(12);
+        for (int i = 0; i < 10; i++) {
+                PlayPosition position = randomDeal(rng);
+                playRandomly(position, 4, rng);
+                BOOST_REQUIRE_EQUAL(solver.solve(position), referenceSolve(position));
+        }
+}
+
+// a full hand is worth 30 points, in steps of 5, and the table doesn't change the answer
+BOOST_AUTO_TEST_CASE(FullDeals) {
+        Xoshiro256StarStar rng(3);
+        DoubleDummySolver solver;
+        DoubleDummySolver tinySolver(2);
+        for (int i = 0; i < 50; i++) {
+                PlayPosition position = randomDeal(rng);
+                int points = solver.solve(position);
+                BOOST_TEST(points >= 0);
+                BOOST_TEST(points <= 30);
+                BOOST_TEST(points % 5 == 0);
+                BOOST_TEST(solver.solve(position) == points);
+                BOOST_TEST(tinySolver.solve(position) == points);
+        }
+}
+
+// making moves gives the same position, points and hash as copying, and unmaking them
+// brings back the start
+BOOST_AUTO_TEST_CASE(MakeAndUnmakeMoves) {
+        Xoshiro256StarStar rng(11);
+        for (int deal = 0; deal < 200; deal++) {
+                PlayPosition start = randomDeal(rng);
+                SearchPosition current(start);
+                PlayPosition copied = start;
+                int copiedPoints = 0;
+                std::vector<PlayPosition> path = {start};
+                for (int i = 0; i < 20; i++) {
+                        CardSet legal = Rules::legalPlays(copied.hands[copied.toPlay()],
+                                copied.led(), copied.trump);
+                        std::vector<Card> cards = legal.toVector();
+                        Card c = cards[boundedRandom(rng, cards.size())];
+                        copiedPoints += copied.play(c);
+                        current.makeMove(c);
+                        path.push_back(copied);
+                        BOOST_REQUIRE(samePosition(current.getPosition(), copied));
+                        BOOST_REQUIRE_EQUAL(current.getHash(), SearchPosition::fullHash(copied));
+                }
+                // the copied positions don't score the high card, which is the other 5 points
+                BOOST_TEST(current.getPoints(0) + current.getPoints(1) == 30);
+                int bonus = copied.highCardPlayer % 2 == 0 ? 5 : 0;
+                BOOST_TEST(current.getPoints(0) == copiedPoints + bonus);
+
+                for (int i = 20; i > 0; i--) {
+                        current.unmakeMove();
+                        BOOST_REQUIRE(samePosition(current.getPosition(), path[i - 1]));
+                        BOOST_REQUIRE_EQUAL(current.getHash(),
+                                SearchPosition::fullHash(path[i - 1]));
+                }
+                BOOST_TEST(current.getPoints(0) == 0);
+                BOOST_TEST(current.movesMade() == 0);
+        }
+}
+
+// the same cards played in a different order give the same hash at the end of the trick
+BOOST_AUTO_TEST_CASE(TranspositionsHaveTheSameHash) {
+        std::array<CardSet, 4> hands = {
+                CardSet(Card(2, Suit::CLUBS), Card(3, Suit::CLUBS)),
+                CardSet(Card(4, Suit::CLUBS), Card(6, Suit::CLUBS)),
+                CardSet(Card(7, Suit::CLUBS), Card(8, Suit::CLUBS)),
+                CardSet(Card(9, Suit::CLUBS), Card(10, Suit::CLUBS))};
+        // diamonds are trump, so the first card of clubs led wins
+        SearchPosition first(PlayPosition(hands, Suit::DIAMONDS, 0));
+        SearchPosition second(PlayPosition(hands, Suit::DIAMONDS, 0));
+        for (Card c : {Card(2, Suit::CLUBS), Card(4, Suit::CLUBS), Card(7, Suit::CLUBS),
+                Card(9, Suit::CLUBS)}) {
+                first.makeMove(c);
+        }
+        for (Card c : {Card(2, Suit::CLUBS), Card(6, Suit::CLUBS), Card(7, Suit::CLUBS),
+                Card(10, Suit::CLUBS)}) {
+                second.makeMove(c);
+        }
+        BOOST_TEST(first.getHash() != second.getHash());
+        BOOST_TEST(first.getPosition().leader == 0);
+
+        // now the other way around, so both end with the same hands
+        first.makeMove(Card(3, Suit::CLUBS));
+        first.makeMove(Card(6, Suit::CLUBS));
+        first.makeMove(Card(8, Suit::CLUBS));
+        first.makeMove(Card(10, Suit::CLUBS));
+        second.makeMove(Card(3, Suit::CLUBS));
+        second.makeMove(Card(4, Suit::CLUBS));
+        second.makeMove(Card(8, Suit::CLUBS));
+        second.makeMove(Card(9, Suit::CLUBS));
+        BOOST_TEST(first.getHash() == second.getHash());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
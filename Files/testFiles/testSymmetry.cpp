@@ -0,0 +1,167 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include <array>
+#include <atomic>
+#include <vector>
+#include "../card.hpp"
+#include "../cardSet.hpp"
+#include "../deck.hpp"
+#include "../playPosition.hpp"
+#include "../random.hpp"
+#include "../ranking.hpp"
+#include "../rules.hpp"
+#include "../solver.hpp"
+#include "../suit.hpp"
+#include "../symmetry.hpp"
+#include "../trick.hpp"
+
+namespace {
+PlayPosition randomDeal(Xoshiro256StarStar& rng) {
+        Deck deck(rng());
+        deck.shuffle();
+        std::array<CardSet, 4> hands;
+        for (CardSet& hand : hands) {
+                for (int i = 0; i < 5; i++) {
+                        hand.insert(deck.pop_back());
+                }
+        }
+        Suit::Suit trump = static_cast<Suit::Suit>(1 + boundedRandom(rng, 4));
+        return PlayPosition(hands, trump, boundedRandom(rng, 4));
+}
+
+Card randomCard(CardSet cards, Xoshiro256StarStar& rng) {
+        std::vector<Card> all = cards.toVector();
+        return all[boundedRandom(rng, all.size())];
+}
+
+bool samePosition(const PlayPosition& lhs, const PlayPosition& rhs) {
+        bool same = lhs.hands == rhs.hands && lhs.trump == rhs.trump &&
+                lhs.leader == rhs.leader && lhs.trickSize == rhs.trickSize &&
+                lhs.highCardPlayer == rhs.highCardPlayer;
+        for (int i = 0; i < lhs.trickSize; i++) {
+                same = same && lhs.trick[i] == rhs.trick[i];
+        }
+        return same;
+}
+
+const Symmetry::SuitPermutation kSwap = {true};
+}  // namespace
+
+BOOST_AUTO_TEST_SUITE(SymmetryTests)
+
+BOOST_AUTO_TEST_CASE(SwapsClubsAndSpades) {
+        BOOST_CHECK(Symmetry::swapBlackSuits(Card(7, Suit::CLUBS)) == Card(7, Suit::SPADES));
+        BOOST_CHECK(Symmetry::swapBlackSuits(Card(13, Suit::SPADES)) == Card(13, Suit::CLUBS));
+        BOOST_CHECK(Symmetry::swapBlackSuits(Card(1, Suit::HEARTS)) == Card(1, Suit::HEARTS));
+        BOOST_CHECK(Symmetry::swapBlackSuits(Card()) == Card());
+        CardSet cards(Card(5, Suit::CLUBS), Card(2, Suit::DIAMONDS), Card(1, Suit::SPADES));
+        BOOST_CHECK(Symmetry::swapBlackSuits(cards) ==
+                CardSet(Card(5, Suit::SPADES), Card(2, Suit::DIAMONDS), Card(1, Suit::CLUBS)));
+        BOOST_TEST(Symmetry::swapBlackSuits(Suit::CLUBS) == Suit::SPADES);
+        BOOST_TEST(Symmetry::swapBlackSuits(Suit::HEARTS) == Suit::HEARTS);
+}
+
+// playing the same cards, swapped, gives the same legal cards, tricks and points
+BOOST_AUTO_TEST_CASE(TheSwapKeepsTheRules) {
+        Xoshiro256StarStar rng(45);
+        for (int deal = 0; deal < 2000; deal++) {
+                PlayPosition position = randomDeal(rng);
+                PlayPosition swapped = position;
+                kSwap.apply(swapped);
+                while (position.tricksLeft() > 0) {
+                        CardSet legal = Rules::legalPlays(position.hands[position.toPlay()],
+                                position.led(), position.trump);
+                        CardSet swappedLegal = Rules::legalPlays(
+                                swapped.hands[swapped.toPlay()], swapped.led(), swapped.trump);
+                        BOOST_REQUIRE(kSwap.apply(legal) == swappedLegal);
+                        Card c = randomCard(legal, rng);
+                        BOOST_REQUIRE(position.play(c) == swapped.play(kSwap.apply(c)));
+                        PlayPosition check = position;
+                        kSwap.apply(check);
+                        BOOST_REQUIRE(samePosition(check, swapped));
+                        BOOST_REQUIRE(position.highCard == kSwap.apply(swapped.highCard));
+                }
+        }
+}
+
+BOOST_AUTO_TEST_CASE(CanonicalHandsAreExact) {
+        Xoshiro256StarStar rng(7);
+        for (int i = 0; i < 20000; i++) {
+                PlayPosition deal = randomDeal(rng);
+                CardSet hand = deal.hands[0];
+                Symmetry::CanonicalHand canonical = Symmetry::canonicalize(hand, deal.trump);
+                BOOST_REQUIRE(canonical.trump != Suit::SPADES);
+                BOOST_REQUIRE(canonical.permutation.apply(canonical.hand) == hand);
+                BOOST_REQUIRE(canonical.permutation.apply(canonical.trump) == deal.trump);
+                // the swap has the same representative
+                Symmetry::CanonicalHand mirror = Symmetry::canonicalize(kSwap.apply(hand),
+                        kSwap.apply(deal.trump));
+                BOOST_REQUIRE(mirror.hand == canonical.hand);
+                BOOST_REQUIRE(mirror.trump == canonical.trump);
+                BOOST_REQUIRE(Symmetry::handClassIndex(hand, deal.trump) ==
+                        Symmetry::handClassIndex(mirror.permutation.apply(mirror.hand),
+                                mirror.permutation.apply(mirror.trump)));
+
+                PlayPosition position = deal;
+                Symmetry::SuitPermutation back = Symmetry::canonicalize(position);
+                PlayPosition mirrorPosition = deal;
+                kSwap.apply(mirrorPosition);
+                Symmetry::canonicalize(mirrorPosition);
+                BOOST_REQUIRE(samePosition(position, mirrorPosition));
+                back.apply(position);
+                BOOST_REQUIRE(samePosition(position, deal));
+        }
+}
+
+// a deal and its swap are solved the same, and share the table
+BOOST_AUTO_TEST_CASE(TheSolverSharesMirroredDeals) {
+        Xoshiro256StarStar rng(11);
+        DoubleDummySolver solver(16);
+        for (int i = 0; i < 200; i++) {
+                PlayPosition position = randomDeal(rng);
+                PlayPosition swapped = position;
+                kSwap.apply(swapped);
+                DoubleDummySolver fresh(16);
+                int points = fresh.solve(position);
+                BOOST_REQUIRE(solver.solve(swapped) == points);
+                int64_t nodes = solver.getNodes();
+                BOOST_REQUIRE(solver.solve(position) == points);
+                // the mirror image is all in the table already
+                BOOST_REQUIRE(solver.getNodes() - nodes == 1);
+        }
+}
+
+// every class is the class of exactly one representative, and handClassAt gives it back
+BOOST_AUTO_TEST_CASE(HandClassesAreDense) {
+        std::vector<std::atomic<uint8_t>> seen(Symmetry::kNumHandClasses);
+        std::atomic<int> wrong(0);
+        Ranking::parallelForEachCombination(5, 0, Ranking::kNumHands, 4,
+                [&](int, uint64_t, CardSet hand) {
+                        for (int s = Suit::HEARTS; s <= Suit::SPADES; s++) {
+                                Suit::Suit trump = static_cast<Suit::Suit>(s);
+                                Symmetry::CanonicalHand canonical =
+                                        Symmetry::canonicalize(hand, trump);
+                                if (canonical.permutation.swapsBlackSuits) {
+                                        continue;
+                                }
+                                int64_t index = Symmetry::handClassIndex(hand, trump);
+                                Symmetry::CanonicalHand back = Symmetry::handClassAt(index);
+                                if (index < 0 || index >= Symmetry::kNumHandClasses ||
+                                        !(back.hand == hand) || back.trump != trump) {
+                                        wrong++;
+                                        continue;
+                                }
+                                seen[index]++;
+                        }
+                });
+        BOOST_TEST(wrong == 0);
+        for (const auto& count : seen) {
+                BOOST_REQUIRE(count == 1);
+        }
+        BOOST_TEST(Symmetry::kNumHandClasses == 5299528);
+        BOOST_CHECK_THROW(Symmetry::handClassAt(Symmetry::kNumHandClasses), std::out_of_range);
+        BOOST_CHECK_THROW(Symmetry::handClassIndex(CardSet(uint64_t{0xF}), Suit::HEARTS),
+                std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
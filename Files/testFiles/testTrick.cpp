@@ -0,0 +1,145 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include "../card.hpp"
+#include "../suit.hpp"
+#include "../trick.hpp"
+#include "../trickState.hpp"
+#include <vector>
+#include <algorithm>
+#include <random>
+
+// the comparison that the strength tables replaced. It searches the trump order of every card
+static bool referenceLessThan(const Card& lhs, const Card& rhs, int suitLed, int trump) {
+        int hearts[14] = {5, 11, 0xACE, 13, 12, 10, 9, 8, 7, 6, 4, 3, 2, INT32_MIN};
+        int diamonds[14] = {5, 11,  0xACE, 1, 13, 12, 10, 9, 8, 7, 6, 4, 3, 2};
+        int clubsAndSpades[14] = {5, 11, 0xACE, 1, 13, 12, 2, 3, 4, 6, 7, 8, 9, 10};
+
+        bool lhsTrump = lhs.getSuit() == trump || lhs.isAceOfHearts();
+        bool rhsTrump = rhs.getSuit() == trump || rhs.isAceOfHearts();
+
+        // neither card is trump, only the suit led matters
+        if (!lhsTrump && !rhsTrump) {
+                return lhs.getSuit() != suitLed && rhs.getSuit() == suitLed;
+        }
+        if (lhsTrump && !rhsTrump) {
+                return false;
+        }
+        if (!lhsTrump && rhsTrump) {
+                return true;
+        }
+
+        int* order = trump == Suit::HEARTS ? hearts :
+                trump == Suit::DIAMONDS ? diamonds : clubsAndSpades;
+        for (int i = 0; i < 14; i++) {
+                if (lhs.getValue() == order[i]) {
+                        return false;
+                } else if (rhs.getValue() == order[i]) {
+                        return true;
+                }
+        }
+        return true;
+}
+
+BOOST_AUTO_TEST_SUITE(TrickTestSuite)
+
+// the strength tables agree with the reference for every pair of cards, trump and suit led
+BOOST_AUTO_TEST_CASE(strengthTablesMatchReferenceForAllPairs) {
+        int mismatches = 0;
+        for (int trump = Suit::HEARTS; trump <= Suit::SPADES; trump++) {
+                for (int suitLed = Suit::HEARTS; suitLed <= Suit::SPADES; suitLed++) {
+                        for (int i = 0; i < Card::kNumCards; i++) {
+                                for (int j = 0; j < Card::kNumCards; j++) {
+                                        Card lhs = Card::fromIndex(i);
+                                        Card rhs = Card::fromIndex(j);
+                                        bool fast = lessThan(lhs, rhs,
+                                                static_cast<Suit::Suit>(suitLed),
+                                                static_cast<Suit::Suit>(trump));
+                                        if (fast != referenceLessThan(lhs, rhs, suitLed, trump)) {
+                                                mismatches++;
+                                        }
+                                }
+                        }
+                }
+        }
+        BOOST_CHECK_EQUAL(mismatches, 0);
+}
+
+// trickWinner picks the same card as std::max_element with the reference comparison
+BOOST_AUTO_TEST_CASE(trickWinnerMatchesMaxElement) {
+        std::mt19937 rng(45);
+        std::vector<int> indexes(Card::kNumCards);
+        for (int i = 0; i < Card::kNumCards; i++) {
+                indexes[i] = i;
+        }
+
+        for (int round = 0; round < 20000; round++) {
+                std::shuffle(indexes.begin(), indexes.end(), rng);
+                Card cards[4];
+                for (int i = 0; i < 4; i++) {
+                        cards[i] = Card::fromIndex(indexes[i]);
+                }
+                Suit::Suit trump = static_cast<Suit::Suit>(round % 4 + 1);
+                Suit::Suit suitLed = cards[0].getSuit();
+
+                int expected = static_cast<int>(std::max_element(cards, cards + 4,
+                        [&](const Card& lhs, const Card& rhs) {
+                                return referenceLessThan(lhs, rhs, suitLed, trump);
+                        }) - cards);
+                BOOST_REQUIRE_EQUAL(trickWinner(cards, suitLed, trump), expected);
+        }
+}
+
+// two cards of the suit led are equally strong, so the first one played wins
+BOOST_AUTO_TEST_CASE(trickWinnerTiesGoToTheEarlierCard) {
+        Card cards[4] = {Card(2, Suit::DIAMONDS), Card(13, Suit::DIAMONDS),
+                Card(13, Suit::SPADES), Card(12, Suit::DIAMONDS)};
+        BOOST_CHECK_EQUAL(trickWinner(cards, Suit::DIAMONDS, Suit::CLUBS), 0);
+}
+
+// a single trump wins no matter where it is played
+BOOST_AUTO_TEST_CASE(trickWinnerTrumpWins) {
+        for (int position = 0; position < 4; position++) {
+                Card cards[4] = {Card(13, Suit::DIAMONDS), Card(12, Suit::DIAMONDS),
+                        Card(11, Suit::DIAMONDS), Card(10, Suit::DIAMONDS)};
+                cards[position] = Card(2, Suit::SPADES);
+                BOOST_CHECK_EQUAL(trickWinner(cards, Suit::DIAMONDS, Suit::SPADES), position);
+        }
+}
+
+// the ace of hearts beats the ace of trump
+BOOST_AUTO_TEST_CASE(trickWinnerAceOfHearts) {
+        Card cards[4] = {Card(1, Suit::CLUBS), Card(13, Suit::CLUBS),
+                Card(1, Suit::HEARTS), Card(4, Suit::CLUBS)};
+        BOOST_CHECK_EQUAL(trickWinner(cards, Suit::CLUBS, Suit::CLUBS), 2);
+}
+
+// the trick state follows the winner card by card, and the cards are stored by player
+BOOST_AUTO_TEST_CASE(trickStateFollowsTheWinner) {
+        TrickState trick(Suit::SPADES, 2, 1, CardSet(Card(9, Suit::HEARTS)));
+        BOOST_CHECK_EQUAL(trick.toPlay(), 2);
+        BOOST_CHECK_EQUAL(trick.winner, -1);
+        BOOST_CHECK(!trick.led().isValid());
+
+        trick.play(Card(13, Suit::DIAMONDS));
+        BOOST_CHECK_EQUAL(trick.suitLed, Suit::DIAMONDS);
+        BOOST_CHECK_EQUAL(trick.winner, 2);
+        BOOST_CHECK(!trick.partnerWinning());
+        // an equal card doesn't take the trick
+        trick.play(Card(12, Suit::DIAMONDS));
+        BOOST_CHECK_EQUAL(trick.winner, 2);
+        BOOST_CHECK(trick.partnerWinning());
+        trick.play(Card(2, Suit::SPADES));
+        BOOST_CHECK_EQUAL(trick.winner, 0);
+        BOOST_CHECK(trick.winningCard == Card(2, Suit::SPADES));
+        trick.play(Card(1, Suit::HEARTS));
+        BOOST_CHECK_EQUAL(trick.winner, 1);
+        BOOST_CHECK(trick.complete());
+
+        BOOST_CHECK(trick.cards[2] == Card(13, Suit::DIAMONDS));
+        BOOST_CHECK(trick.cards[1] == Card(1, Suit::HEARTS));
+        BOOST_CHECK(trick.led() == Card(13, Suit::DIAMONDS));
+        BOOST_CHECK_EQUAL(trick.played.size(), 5);
+        BOOST_CHECK_EQUAL(trick.trickNumber, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,96 @@
+// Copyright Andrew Bernal 2023
+#include <boost/test/unit_test.hpp>
+#include <stdexcept>
+#include <vector>
+#include "../card.hpp"
+#include "../cardSet.hpp"
+#include "../handTracker.hpp"
+#include "../random.hpp"
+#include "../rules.hpp"
+#include "../suit.hpp"
+#include "../trick.hpp"
+#include "../trickKernels.hpp"
+#include "testHelpers.hpp"
+
+BOOST_AUTO_TEST_SUITE(TrickKernelsTests)
+
+BOOST_AUTO_TEST_CASE(TrickWinnersMatchTrickWinner) {
+        IsaGuard guard;
+        // not a multiple of the vector widths, so the scalar tail is tested too
+        const int kCount = 4099;
+        Xoshiro256StarStar rng(17);
+        std::vector<uint8_t> cards[4];
+        std::vector<uint8_t> trumps(kCount);
+        std::vector<int> expected(kCount);
+        for (int g = 0; g < kCount; g++) {
+                CardSet deck = CardSet::all();
+                Card trick[4];
+                for (int i = 0; i < 4; i++) {
+                        uint64_t card = takeRandom(deck, 1, rng).getMask();
+                        trick[i] = Card::fromIndex(__builtin_ctzll(card));
+                        cards[i].push_back(static_cast<uint8_t>(trick[i].getIndex()));
+                }
+                trumps[g] = static_cast<uint8_t>(Suit::HEARTS + g % 4);
+                expected[g] = trickWinner(trick, trick[0].getSuit(),
+                        static_cast<Suit::Suit>(trumps[g]));
+        }
+        const uint8_t* const columns[4] = {cards[0].data(), cards[1].data(), cards[2].data(),
+                cards[3].data()};
+        for (TrickKernels::Isa isa : supportedIsas()) {
+                TrickKernels::setIsa(isa);
+                std::vector<uint8_t> winners(kCount, 0xFF);
+                TrickKernels::trickWinners(columns, trumps.data(), kCount, winners.data());
+                for (int g = 0; g < kCount; g++) {
+                        BOOST_REQUIRE_MESSAGE(winners[g] == expected[g],
+                                TrickKernels::isaName(isa) << " trick " << g);
+                }
+        }
+}
+
+BOOST_AUTO_TEST_CASE(LegalPlaysMatchRules) {
+        IsaGuard guard;
+        // every led card with every trump, 5 times, and 1 more so the count is odd
+        const int kCount = 52 * 4 * 5 + 1;
+        Xoshiro256StarStar rng(18);
+        std::vector<uint64_t> hands(kCount);
+        std::vector<uint8_t> led(kCount);
+        std::vector<uint8_t> trumps(kCount);
+        std::vector<uint64_t> expected(kCount);
+        for (int g = 0; g < kCount; g++) {
+                int card = g % 52;
+                CardSet deck = CardSet::all();
+                deck.remove(Card::fromIndex(card));
+                // small hands make not having the suit led common
+                CardSet hand = takeRandom(deck, 1 + g % 5, rng);
+                hands[g] = hand.getMask();
+                led[g] = static_cast<uint8_t>(card);
+                trumps[g] = static_cast<uint8_t>(Suit::HEARTS + g / 52 % 4);
+                expected[g] = Rules::legalPlays(hand, Card::fromIndex(card),
+                        static_cast<Suit::Suit>(trumps[g])).getMask();
+        }
+        for (TrickKernels::Isa isa : supportedIsas()) {
+                TrickKernels::setIsa(isa);
+                std::vector<uint64_t> legal(kCount);
+                TrickKernels::legalPlays(hands.data(), led.data(), trumps.data(), kCount,
+                        legal.data());
+                for (int g = 0; g < kCount; g++) {
+                        BOOST_REQUIRE_MESSAGE(legal[g] == expected[g],
+                                TrickKernels::isaName(isa) << " hand " << g);
+                }
+                TrickKernels::legalPlays(hands.data(), nullptr, trumps.data(), kCount,
+                        legal.data());
+                BOOST_TEST(legal == hands);
+        }
+}
+
+BOOST_AUTO_TEST_CASE(SetIsaRejectsWhatTheCpuCantRun) {
+        IsaGuard guard;
+        TrickKernels::setIsa(TrickKernels::Isa::SCALAR);
+        BOOST_TEST((TrickKernels::getIsa() == TrickKernels::Isa::SCALAR));
+        if (TrickKernels::bestIsa() != TrickKernels::Isa::AVX2) {
+                BOOST_CHECK_THROW(TrickKernels::setIsa(TrickKernels::Isa::AVX2),
+                        std::invalid_argument);
+        }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
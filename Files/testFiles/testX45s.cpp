@@ -5,37 +5,182 @@
 #include "../card.hpp"
 #include "../suit.hpp"
 #include "../45s.hpp"
+#include "../rules.hpp"
+#include "../trick.hpp"
 #include <vector>
 #include <algorithm>
 
 class nonBidder : public Player {
 public:
         void discard() override {}
-        std::pair<int, Suit::Suit> getBid([[maybe_unused]] const std::vector<int>& bidHistory) override {
+        std::pair<int, Suit::Suit> getBid([[maybe_unused]] Span<const int> bidHistory) override {
                 return {0, Suit::SPADES};
         }
         Suit::Suit bagged() override {
                 return Suit::SPADES;
         }
-        Card playCard([[maybe_unused]] const std::vector<Card>& cardsPlayedThisHand) override {
-                return hand.back();
+        Card playCard([[maybe_unused]] const TrickState& trick) override {
+                return playLastLegalCard();
         }
 };
 
 class bigBidder : public Player {
 public:
         void discard() override {}
-        std::pair<int, Suit::Suit> getBid([[maybe_unused]] const std::vector<int>& bidHistory) override {
+        std::pair<int, Suit::Suit> getBid([[maybe_unused]] Span<const int> bidHistory) override {
                 return {30, Suit::CLUBS};
         }
         Suit::Suit bagged() override {
                 return Suit::CLUBS;
         }
-        Card playCard([[maybe_unused]] const std::vector<Card>& cardsPlayedThisHand) override {
-                return hand.back();
+        Card playCard([[maybe_unused]] const TrickState& trick) override {
+                return playLastLegalCard();
         }
 };
 
+// plays the last legal card of its hand, and bids 20 in its longest suit if it has 3 of them.
+// It is final, so basic_x45s can call it directly
+class lastCardPlayer final : public Player {
+public:
+        void discard() override {
+                while (hand.size() > 5) {
+                        hand.erase(hand.begin());
+                }
+        }
+        std::pair<int, Suit::Suit> getBid(Span<const int> bidHistory) override {
+                Suit::Suit suit = longestSuit();
+                int length = (getHandSet() & CardSet::suitMask(suit)).size();
+                auto bid20 = std::find(bidHistory.begin(), bidHistory.end(), 20);
+                bool outbid = bid20 != bidHistory.end();
+                return {length >= 3 && !outbid ? 20 : 0, suit};
+        }
+        Suit::Suit bagged() override {
+                return longestSuit();
+        }
+        Card playCard([[maybe_unused]] const TrickState& trick) override {
+                return playLastLegalCard();
+        }
+
+private:
+        Suit::Suit longestSuit() {
+                Suit::Suit longest = Suit::HEARTS;
+                for (int i = Suit::DIAMONDS; i <= Suit::SPADES; i++) {
+                        Suit::Suit suit = static_cast<Suit::Suit>(i);
+                        if ((getHandSet() & CardSet::suitMask(suit)).size() >
+                                (getHandSet() & CardSet::suitMask(longest)).size()) {
+                                longest = suit;
+                        }
+                }
+                return longest;
+        }
+};
+
+// plays the last card of its hand, whether or not it can
+class ruleBreaker final : public Player {
+public:
+        void discard() override {
+                while (hand.size() > 5) {
+                        hand.erase(hand.begin());
+                }
+        }
+        std::pair<int, Suit::Suit> getBid([[maybe_unused]] Span<const int> bidHistory) override {
+                return {0, Suit::HEARTS};
+        }
+        Suit::Suit bagged() override {
+                return Suit::HEARTS;
+        }
+        Card playCard([[maybe_unused]] const TrickState& trick) override {
+                Card c = hand.back();
+                hand.pop_back();
+                return c;
+        }
+};
+
+// makes the bid and picks the suit it is given, whether or not they are allowed
+class badBidder final : public Player {
+public:
+        badBidder(std::pair<int, Suit::Suit> inpBid, Suit::Suit inpBagged)
+                : bid(inpBid), baggedSuit(inpBagged) {}
+        void discard() override {
+                while (hand.size() > 5) {
+                        hand.erase(hand.begin());
+                }
+        }
+        std::pair<int, Suit::Suit> getBid([[maybe_unused]] Span<const int> bidHistory) override {
+                return bid;
+        }
+        Suit::Suit bagged() override {
+                return baggedSuit;
+        }
+        Card playCard([[maybe_unused]] const TrickState& trick) override {
+                return playLastLegalCard();
+        }
+
+private:
+        std::pair<int, Suit::Suit> bid;
+        Suit::Suit baggedSuit;
+};
+
+// checks that every card it is told it can play is in its hand and follows the rules, and that
+// the trick state agrees with the cards of the trick
+class legalityChecker final : public Player {
+public:
+        void discard() override {
+                while (hand.size() > 5) {
+                        hand.erase(hand.begin());
+                }
+        }
+        std::pair<int, Suit::Suit> getBid([[maybe_unused]] Span<const int> bidHistory) override {
+                return {0, Suit::DIAMONDS};
+        }
+        Suit::Suit bagged() override {
+                return Suit::DIAMONDS;
+        }
+        void bidWon([[maybe_unused]] int bidder, [[maybe_unused]] int amount,
+                Suit::Suit inpTrump) override {
+                trump = inpTrump;
+                tricks = 0;
+                played = CardSet();
+        }
+        void trickPlayed(Span<const Card> cardsPlayed, [[maybe_unused]] int leader,
+                [[maybe_unused]] int winner) override {
+                tricks++;
+                played |= CardSet(cardsPlayed);
+        }
+        Card playCard(const TrickState& trick) override {
+                BOOST_TEST(trick.trump == trump);
+                BOOST_TEST(trick.trickNumber == tricks);
+                BOOST_TEST(((trick.played - CardSet(Span<const Card>(trick.cards))) == played));
+                BOOST_TEST(seat == trick.toPlay());
+                // the cards so far in the order they were played
+                std::array<Card, 4> inOrder;
+                for (int i = 0; i < trick.size; i++) {
+                        inOrder[i] = trick.cards[(trick.leader + i) % 4];
+                }
+                if (trick.size > 0) {
+                        BOOST_TEST(trick.suitLed == inOrder[0].getSuit());
+                        // the cards not played yet are weaker than anything
+                        int position = trickWinner(inOrder.data(), trick.suitLed, trump);
+                        BOOST_TEST(trick.winner == (trick.leader + position) % 4);
+                        BOOST_TEST(trick.winningCard == inOrder[position]);
+                }
+
+                BOOST_TEST(!getLegalPlays().empty());
+                CardSet expected = Rules::legalPlays(getHandSet(), trick.led(), trump);
+                BOOST_TEST((getLegalPlays() == expected));
+                return playLastLegalCard();
+        }
+        void seated(int inpSeat) override {
+                seat = inpSeat;
+        }
+
+private:
+        Suit::Suit trump = Suit::INVALID;
+        int seat = 0;
+        int tricks = 0;
+        CardSet played;
+};
+
 // Test that the deal_players method deals 5 cards to each player
 BOOST_AUTO_TEST_CASE(TestDealPlayers) {
         x45s game([]{return new nonBidder;}, []{return new nonBidder;},
@@ -90,3 +235,85 @@ BOOST_AUTO_TEST_CASE(TestGetBidder) {
         BOOST_CHECK_EQUAL(game.getTrump(), Suit::CLUBS);
         BOOST_CHECK_EQUAL(game.getBidAmount(), 30);
 }
+
+// games with the same seed deal the same hands
+BOOST_AUTO_TEST_CASE(TestSeededGamesDealTheSameHands) {
+        x45s game1([]{return new nonBidder;}, []{return new nonBidder;},
+                []{return new nonBidder;}, []{return new nonBidder;});
+        x45s game2([]{return new nonBidder;}, []{return new nonBidder;},
+                []{return new nonBidder;}, []{return new nonBidder;});
+        game1.seed(45);
+        game2.seed(45);
+        game1.shuffle();
+        game2.shuffle();
+        game1.deal_players();
+        game2.deal_players();
+        for (int i = 0; i < 4; i++) {
+                BOOST_CHECK(game1.getPlayer(i).getHandSet() == game2.getPlayer(i).getHandSet());
+        }
+}
+
+// the templated engine plays exactly the same game as the runtime engine
+BOOST_AUTO_TEST_CASE(TestTemplatedEngineMatchesRuntimeEngine) {
+        lastCardPlayer p1, p2, p3, p4;
+        x45s runtimeGame(&p1, &p2, &p3, &p4);
+        basic_x45s<lastCardPlayer, lastCardPlayer, lastCardPlayer, lastCardPlayer> templatedGame;
+        runtimeGame.seed(45);
+        templatedGame.seed(45);
+
+        BOOST_CHECK_EQUAL(runtimeGame.playGame(), templatedGame.playGame());
+        BOOST_CHECK_EQUAL(runtimeGame.getTeamScore(0), templatedGame.getTeamScore(0));
+        BOOST_CHECK_EQUAL(runtimeGame.getTeamScore(1), templatedGame.getTeamScore(1));
+        BOOST_CHECK_EQUAL(runtimeGame.whichTeamWon(), templatedGame.whichTeamWon());
+        BOOST_CHECK(runtimeGame.getPlayer(2).getHandSet() ==
+                templatedGame.getPlayer<2>().getHandSet());
+}
+
+// a card that doesn't follow the rules is never played
+BOOST_AUTO_TEST_CASE(TestIllegalCardsThrow) {
+        ruleBreaker p1, p2, p3, p4;
+        x45s game(&p1, &p2, &p3, &p4);
+        game.seed(45);
+        BOOST_CHECK_THROW(game.playGame(), std::invalid_argument);
+}
+
+// a bid that isn't 0, 15, 20, 25 or 30, or isn't in a real suit, is never taken
+BOOST_AUTO_TEST_CASE(TestIllegalBidsThrow) {
+        const std::pair<int, Suit::Suit> bids[] = {{200, Suit::CLUBS}, {-5, Suit::CLUBS},
+                {22, Suit::CLUBS}, {20, Suit::INVALID}};
+        for (const std::pair<int, Suit::Suit>& bid : bids) {
+                // player 0 deals, so player 1 bids first
+                badBidder p1(bid, Suit::CLUBS);
+                nonBidder p0, p2, p3;
+                x45s game(&p0, &p1, &p2, &p3);
+                game.reset();
+                game.deal_players();
+                BOOST_CHECK_THROW(game.biddingPhase(), std::invalid_argument);
+        }
+        // player 0 deals, so it is bagged
+        badBidder dealer({0, Suit::CLUBS}, Suit::INVALID);
+        nonBidder p2, p3, p4;
+        x45s game(&dealer, &p2, &p3, &p4);
+        game.reset();
+        game.deal_players();
+        BOOST_CHECK_THROW(game.biddingPhase(), std::invalid_argument);
+
+        badBidder passer({0, Suit::INVALID}, Suit::CLUBS);
+        x45s passing(&p2, &passer, &p3, &p4);
+        passing.reset();
+        passing.deal_players();
+        BOOST_CHECK_NO_THROW(passing.biddingPhase());
+        BOOST_TEST(passing.getBidAmount() == 15);
+}
+
+// every player is told the cards they can play, and the trick state is right at every card
+BOOST_AUTO_TEST_CASE(TestPlayersAreGivenTheirLegalPlays) {
+        legalityChecker p1, p2, p3, p4;
+        x45s game(&p1, &p2, &p3, &p4);
+        game.seed(45);
+        for (int i = 0; i < 20; i++) {
+                game.reset();
+                game.shuffle();
+                game.dealBidAndFullFiveTricks();
+        }
+}
@@ -0,0 +1,45 @@
+// Copyright Andrew Bernal 2023
+// Makes the bidding equity table that EquityTable loads.
+// usage: generateEquity [--samples=N] [--threads=N] [--seed=N] [--classes=N] output.bin
+// --classes only makes the first N classes, for trying it out. The full table takes a long time:
+// every class of hand and trump is sampled, so it is about 5.3 million * samples double dummy
+// solves
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "../equityTable.hpp"
+
+int main(int argc, char** argv) {
+        int samples = 32;
+        int threads = 0;
+        uint64_t seed = 45;
+        int64_t classes = EquityTable::kNumClasses;
+        std::string outputPath;
+        for (int i = 1; i < argc; i++) {
+                std::string arg = argv[i];
+                if (arg.rfind("--samples=", 0) == 0) {
+                        samples = std::atoi(arg.c_str() + 10);
+                } else if (arg.rfind("--threads=", 0) == 0) {
+                        threads = std::atoi(arg.c_str() + 10);
+                } else if (arg.rfind("--seed=", 0) == 0) {
+                        seed = std::strtoull(arg.c_str() + 7, nullptr, 10);
+                } else if (arg.rfind("--classes=", 0) == 0) {
+                        classes = std::atoll(arg.c_str() + 10);
+                } else {
+                        outputPath = arg;
+                }
+        }
+        if (outputPath.empty()) {
+                std::cerr << "usage: generateEquity [--samples=N] [--threads=N] [--seed=N] "
+                        "[--classes=N] output.bin\n";
+                return 1;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        EquityTable::generate(outputPath, samples, threads, seed, classes);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "wrote " << classes << " classes to " << outputPath << " in "
+                << elapsed.count() << " seconds\n";
+        return 0;
+}
@@ -0,0 +1,96 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+
+// A fixed-size transposition table that many threads can read and write at once, without locks.
+// The entries are in buckets of 4 that fill one 64 byte cache line, and the bucket is chosen by
+// the low bits of the key. Every entry is two 64 bit words: the data (the bounds and how many
+// tricks were left) and the key xored with the data. A reader only trusts an entry when the two
+// words xor back to its key, so an entry torn by two threads writing it at once is just a miss.
+// The table is lossy: when a bucket is full the entry with the fewest tricks left is replaced.
+class TranspositionTable {
+ public:
+        // the table has 2^entryBits entries of 16 bytes. entryBits is at least 2 (one bucket)
+        explicit TranspositionTable(int entryBits) {
+                if (entryBits < 2 || entryBits > 32) {
+                        throw std::invalid_argument("entryBits must be between 2 and 32");
+                }
+                bucketMask = (uint64_t{1} << (entryBits - 2)) - 1;
+                buckets = std::make_unique<Bucket[]>(bucketMask + 1);
+                clear();
+        }
+
+        // looks for key. If it is there, sets lower and upper to its bounds and returns true
+        bool probe(uint64_t key, int& lower, int& upper) const {
+                const Bucket& bucket = buckets[key & bucketMask];
+                for (int i = 0; i < kBucketSize; i++) {
+                        uint64_t data = bucket.data[i].load(std::memory_order_relaxed);
+                        uint64_t check = bucket.check[i].load(std::memory_order_relaxed);
+                        if ((check ^ data) == key) {
+                                lower = static_cast<int8_t>(data & 0xFF);
+                                upper = static_cast<int8_t>((data >> 8) & 0xFF);
+                                return true;
+                        }
+                }
+                return false;
+        }
+
+        // saves the bounds of key. tricksLeft is how much work the bounds took, so entries
+        // near the end of the hand are replaced first
+        void store(uint64_t key, int lower, int upper, int tricksLeft) {
+                Bucket& bucket = buckets[key & bucketMask];
+                int replace = 0;
+                int fewestTricks = 256;
+                for (int i = 0; i < kBucketSize; i++) {
+                        uint64_t data = bucket.data[i].load(std::memory_order_relaxed);
+                        uint64_t check = bucket.check[i].load(std::memory_order_relaxed);
+                        if ((check ^ data) == key) {
+                                replace = i;
+                                break;
+                        }
+                        int tricks = static_cast<int>((data >> 16) & 0xFF);
+                        if (tricks < fewestTricks) {
+                                fewestTricks = tricks;
+                                replace = i;
+                        }
+                }
+                uint64_t data = uint64_t{static_cast<uint8_t>(lower)} |
+                        uint64_t{static_cast<uint8_t>(upper)} << 8 |
+                        uint64_t{static_cast<uint8_t>(tricksLeft)} << 16;
+                bucket.data[replace].store(data, std::memory_order_relaxed);
+                bucket.check[replace].store(key ^ data, std::memory_order_relaxed);
+        }
+
+        // forgets every entry. Not safe while other threads use the table
+        void clear() {
+                // an empty entry has the key 0 and bounds that say nothing
+                uint64_t empty = kNoBounds;
+                for (uint64_t b = 0; b <= bucketMask; b++) {
+                        for (int i = 0; i < kBucketSize; i++) {
+                                buckets[b].data[i].store(empty, std::memory_order_relaxed);
+                                buckets[b].check[i].store(empty, std::memory_order_relaxed);
+                        }
+                }
+        }
+
+        uint64_t numEntries() const {
+                return (bucketMask + 1) * kBucketSize;
+        }
+
+ private:
+        static constexpr int kBucketSize = 4;
+        // a lower bound of 0 and an upper bound of 127, with no tricks left
+        static constexpr uint64_t kNoBounds = uint64_t{127} << 8;
+
+        struct alignas(64) Bucket {
+                std::atomic<uint64_t> data[kBucketSize];
+                std::atomic<uint64_t> check[kBucketSize];
+        };
+        static_assert(sizeof(Bucket) == 64, "a bucket should fill one cache line");
+
+        std::unique_ptr<Bucket[]> buckets;
+        uint64_t bucketMask;
+};
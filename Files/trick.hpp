@@ -0,0 +1,22 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include "card.hpp"
+#include "suit.hpp"
+
+// Returns the position (0-3) of the winning card of a trick of 4 cards.
+// The winner is found with three compares on the strength table of (suitLed, trump).
+// When two cards are equally strong the earlier position wins, the same as std::max_element.
+inline int trickWinner(const Card* cards, Suit::Suit suitLed, Suit::Suit trump) {
+        const CardRank::Row& strengths = CardRank::row(suitLed, trump);
+        int s0 = strengths[CardRank::slot(cards[0])];
+        int s1 = strengths[CardRank::slot(cards[1])];
+        int s2 = strengths[CardRank::slot(cards[2])];
+        int s3 = strengths[CardRank::slot(cards[3])];
+
+        // winner of the first two and the last two cards
+        int first = s1 > s0 ? 1 : 0;
+        int firstStrength = s1 > s0 ? s1 : s0;
+        int second = s3 > s2 ? 3 : 2;
+        int secondStrength = s3 > s2 ? s3 : s2;
+        return secondStrength > firstStrength ? second : first;
+}
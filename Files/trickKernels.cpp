@@ -0,0 +1,329 @@
+// Copyright Andrew Bernal 2023
+#include "trickKernels.hpp"
+#include <immintrin.h>
+#include <atomic>
+#include <stdexcept>
+#include "card.hpp"
+
+namespace {
+// The strength of every card of the trump suit, by its value - 1, for each kind of trump.
+// The ace of hearts is 13 with every trump, and value 1 of hearts is the ace of hearts.
+// Strengths are the same as CardRank: a trump is 2-15, a card of the suit led is 1, others 0
+struct TrumpTables {
+        uint8_t hearts[16];
+        uint8_t diamonds[16];
+        uint8_t black[16];
+};
+
+constexpr TrumpTables buildTrumpTables() {
+        TrumpTables tables{};
+        for (int r = 0; r < 13; r++) {
+                tables.hearts[r] = CardRank::kStrength[Suit::HEARTS - 1][0][r];
+                tables.diamonds[r] = CardRank::kStrength[Suit::DIAMONDS - 1][0][13 + r];
+                tables.black[r] = CardRank::kStrength[Suit::CLUBS - 1][0][26 + r];
+        }
+        return tables;
+}
+
+constexpr TrumpTables kTrumpTables = buildTrumpTables();
+constexpr int kAceOfHeartsStrength = 13;
+
+// the 13 cards of each suit (0-3)
+constexpr uint64_t kSuitMasks[4] = {uint64_t{0x1FFF}, uint64_t{0x1FFF} << 13,
+        uint64_t{0x1FFF} << 26, uint64_t{0x1FFF} << 39};
+
+std::atomic<TrickKernels::Isa> currentIsa(TrickKernels::bestIsa());
+
+void trickWinnersScalar(const uint8_t* const cards[4], const uint8_t* trumps, int begin,
+        int end, uint8_t* winners) {
+        for (int g = begin; g < end; g++) {
+                int trump = (trumps[g] - 1) & 3;
+                int first = cards[0][g];
+                int led = first < Card::kNumCards ? first / 13 + 1 : 0;
+                const CardRank::Row& strengths = CardRank::kStrength[trump][led];
+                int best = 0;
+                for (int i = 1; i < 4; i++) {
+                        if (strengths[cards[i][g] & 63] > strengths[cards[best][g] & 63]) {
+                                best = i;
+                        }
+                }
+                winners[g] = static_cast<uint8_t>(best);
+        }
+}
+
+uint64_t legalPlay(uint64_t hand, int led, int trumpSuit) {
+        if (led >= Card::kNumCards) {
+                return hand;
+        }
+        int t = (trumpSuit - 1) & 3;
+        uint64_t inTrump = hand & (kSuitMasks[t] | 1);
+        int ledSuit = led / 13;
+        if (ledSuit == t || led == 0) {
+                // the 5, the jack and the ace of hearts can be reneged, unless a stronger one
+                // of them was led
+                int five = 13 * t + 4;
+                int jack = 13 * t + 10;
+                uint64_t top = (uint64_t{1} << five) | (uint64_t{1} << jack) | 1;
+                uint64_t weakerTop = led == five ? (uint64_t{1} << jack) | 1 :
+                        led == jack ? 1 : 0;
+                uint64_t forced = (inTrump & ~top) | (hand & weakerTop);
+                return forced != 0 ? inTrump : hand;
+        }
+        uint64_t follow = hand & kSuitMasks[ledSuit] & ~uint64_t{1};
+        return follow != 0 ? follow | inTrump : hand;
+}
+
+void legalPlaysScalar(const uint64_t* hands, const uint8_t* led, const uint8_t* trumps,
+        int begin, int end, uint64_t* legal) {
+        for (int g = begin; g < end; g++) {
+                legal[g] = legalPlay(hands[g], led[g], trumps[g]);
+        }
+}
+
+// 16 tricks at a time. Each card's suit and value come from compares, and its strength as a
+// trump from a shuffle of the table of the game's kind of trump
+__attribute__((target("sse4.2")))
+__m128i suitsSse(__m128i c) {
+        __m128i m1 = _mm_cmpgt_epi8(c, _mm_set1_epi8(12));
+        __m128i m2 = _mm_cmpgt_epi8(c, _mm_set1_epi8(25));
+        __m128i m3 = _mm_cmpgt_epi8(c, _mm_set1_epi8(38));
+        return _mm_sub_epi8(_mm_sub_epi8(_mm_sub_epi8(_mm_setzero_si128(), m1), m2), m3);
+}
+
+__attribute__((target("sse4.2")))
+__m128i strengthsSse(__m128i c, __m128i t, __m128i ledSuit) {
+        __m128i suit = suitsSse(c);
+        // the value - 1: 13 off for every suit below this one
+        __m128i r = _mm_sub_epi8(c, _mm_and_si128(_mm_set1_epi8(13),
+                _mm_cmpgt_epi8(c, _mm_set1_epi8(12))));
+        r = _mm_sub_epi8(r, _mm_and_si128(_mm_set1_epi8(13), _mm_cmpgt_epi8(c, _mm_set1_epi8(25))));
+        r = _mm_sub_epi8(r, _mm_and_si128(_mm_set1_epi8(13), _mm_cmpgt_epi8(c, _mm_set1_epi8(38))));
+        __m128i hearts = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kTrumpTables.hearts));
+        __m128i diamonds = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(kTrumpTables.diamonds));
+        __m128i black = _mm_loadu_si128(reinterpret_cast<const __m128i*>(kTrumpTables.black));
+        __m128i trumpStrength = _mm_blendv_epi8(
+                _mm_blendv_epi8(_mm_shuffle_epi8(black, r), _mm_shuffle_epi8(diamonds, r),
+                        _mm_cmpeq_epi8(t, _mm_set1_epi8(1))),
+                _mm_shuffle_epi8(hearts, r), _mm_cmpeq_epi8(t, _mm_setzero_si128()));
+        __m128i aceOfHearts = _mm_cmpeq_epi8(c, _mm_setzero_si128());
+        trumpStrength = _mm_blendv_epi8(trumpStrength, _mm_set1_epi8(kAceOfHeartsStrength),
+                aceOfHearts);
+        __m128i isTrump = _mm_or_si128(_mm_cmpeq_epi8(suit, t), aceOfHearts);
+        __m128i follows = _mm_and_si128(_mm_cmpeq_epi8(suit, ledSuit), _mm_set1_epi8(1));
+        return _mm_blendv_epi8(follows, trumpStrength, isTrump);
+}
+
+__attribute__((target("sse4.2")))
+int trickWinnersSse(const uint8_t* const cards[4], const uint8_t* trumps, int count,
+        uint8_t* winners) {
+        int g = 0;
+        for (; g + 16 <= count; g += 16) {
+                __m128i t = _mm_and_si128(_mm_sub_epi8(
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(trumps + g)),
+                        _mm_set1_epi8(1)), _mm_set1_epi8(3));
+                __m128i c[4];
+                for (int i = 0; i < 4; i++) {
+                        c[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cards[i] + g));
+                }
+                __m128i ledSuit = suitsSse(c[0]);
+                __m128i best = strengthsSse(c[0], t, ledSuit);
+                __m128i position = _mm_setzero_si128();
+                for (int i = 1; i < 4; i++) {
+                        __m128i s = strengthsSse(c[i], t, ledSuit);
+                        __m128i stronger = _mm_cmpgt_epi8(s, best);
+                        best = _mm_max_epu8(best, s);
+                        position = _mm_blendv_epi8(position, _mm_set1_epi8(static_cast<char>(i)),
+                                stronger);
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(winners + g), position);
+        }
+        return g;
+}
+
+// the same, 32 tricks at a time
+__attribute__((target("avx2")))
+__m256i suitsAvx2(__m256i c) {
+        __m256i m1 = _mm256_cmpgt_epi8(c, _mm256_set1_epi8(12));
+        __m256i m2 = _mm256_cmpgt_epi8(c, _mm256_set1_epi8(25));
+        __m256i m3 = _mm256_cmpgt_epi8(c, _mm256_set1_epi8(38));
+        return _mm256_sub_epi8(_mm256_sub_epi8(_mm256_sub_epi8(_mm256_setzero_si256(), m1), m2),
+                m3);
+}
+
+__attribute__((target("avx2")))
+__m256i strengthsAvx2(__m256i c, __m256i t, __m256i ledSuit) {
+        __m256i suit = suitsAvx2(c);
+        // the value - 1: 13 off for every suit below this one
+        __m256i r = _mm256_sub_epi8(c, _mm256_and_si256(_mm256_set1_epi8(13),
+                _mm256_cmpgt_epi8(c, _mm256_set1_epi8(12))));
+        r = _mm256_sub_epi8(r, _mm256_and_si256(_mm256_set1_epi8(13),
+                _mm256_cmpgt_epi8(c, _mm256_set1_epi8(25))));
+        r = _mm256_sub_epi8(r, _mm256_and_si256(_mm256_set1_epi8(13),
+                _mm256_cmpgt_epi8(c, _mm256_set1_epi8(38))));
+        __m256i hearts = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(kTrumpTables.hearts)));
+        __m256i diamonds = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(kTrumpTables.diamonds)));
+        __m256i black = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(kTrumpTables.black)));
+        __m256i trumpStrength = _mm256_blendv_epi8(
+                _mm256_blendv_epi8(_mm256_shuffle_epi8(black, r),
+                        _mm256_shuffle_epi8(diamonds, r),
+                        _mm256_cmpeq_epi8(t, _mm256_set1_epi8(1))),
+                _mm256_shuffle_epi8(hearts, r), _mm256_cmpeq_epi8(t, _mm256_setzero_si256()));
+        __m256i aceOfHearts = _mm256_cmpeq_epi8(c, _mm256_setzero_si256());
+        trumpStrength = _mm256_blendv_epi8(trumpStrength,
+                _mm256_set1_epi8(kAceOfHeartsStrength), aceOfHearts);
+        __m256i isTrump = _mm256_or_si256(_mm256_cmpeq_epi8(suit, t), aceOfHearts);
+        __m256i follows = _mm256_and_si256(_mm256_cmpeq_epi8(suit, ledSuit),
+                _mm256_set1_epi8(1));
+        return _mm256_blendv_epi8(follows, trumpStrength, isTrump);
+}
+
+__attribute__((target("avx2")))
+int trickWinnersAvx2(const uint8_t* const cards[4], const uint8_t* trumps, int count,
+        uint8_t* winners) {
+        int g = 0;
+        for (; g + 32 <= count; g += 32) {
+                __m256i t = _mm256_and_si256(_mm256_sub_epi8(
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(trumps + g)),
+                        _mm256_set1_epi8(1)), _mm256_set1_epi8(3));
+                __m256i c[4];
+                for (int i = 0; i < 4; i++) {
+                        c[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cards[i] + g));
+                }
+                __m256i ledSuit = suitsAvx2(c[0]);
+                __m256i best = strengthsAvx2(c[0], t, ledSuit);
+                __m256i position = _mm256_setzero_si256();
+                for (int i = 1; i < 4; i++) {
+                        __m256i s = strengthsAvx2(c[i], t, ledSuit);
+                        __m256i stronger = _mm256_cmpgt_epi8(s, best);
+                        best = _mm256_max_epu8(best, s);
+                        position = _mm256_blendv_epi8(position,
+                                _mm256_set1_epi8(static_cast<char>(i)), stronger);
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(winners + g), position);
+        }
+        return g;
+}
+
+// 4 hands at a time, with the masks made by shifting each lane by its own amount
+__attribute__((target("avx2")))
+int legalPlaysAvx2(const uint64_t* hands, const uint8_t* led, const uint8_t* trumps, int count,
+        uint64_t* legal) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi64x(1);
+        const __m256i suitBits = _mm256_set1_epi64x(0x1FFF);
+        int g = 0;
+        for (; g + 4 <= count; g += 4) {
+                int32_t ledBytes;
+                int32_t trumpBytes;
+                __builtin_memcpy(&ledBytes, led + g, 4);
+                __builtin_memcpy(&trumpBytes, trumps + g, 4);
+                __m256i l = _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(ledBytes));
+                __m256i t = _mm256_and_si256(_mm256_sub_epi64(
+                        _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(trumpBytes)), one),
+                        _mm256_set1_epi64x(3));
+                __m256i hand = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hands + g));
+
+                // 13 * the trump, and 13 * the suit led
+                __m256i trumpShift = _mm256_add_epi64(_mm256_add_epi64(_mm256_slli_epi64(t, 3),
+                        _mm256_slli_epi64(t, 2)), t);
+                __m256i ledShift = _mm256_add_epi64(_mm256_add_epi64(
+                        _mm256_and_si256(_mm256_cmpgt_epi64(l, _mm256_set1_epi64x(12)),
+                                _mm256_set1_epi64x(13)),
+                        _mm256_and_si256(_mm256_cmpgt_epi64(l, _mm256_set1_epi64x(25)),
+                                _mm256_set1_epi64x(13))),
+                        _mm256_and_si256(_mm256_cmpgt_epi64(l, _mm256_set1_epi64x(38)),
+                                _mm256_set1_epi64x(13)));
+                __m256i inTrump = _mm256_and_si256(hand,
+                        _mm256_or_si256(_mm256_sllv_epi64(suitBits, trumpShift), one));
+                __m256i ledTrump = _mm256_or_si256(_mm256_cmpeq_epi64(ledShift, trumpShift),
+                        _mm256_cmpeq_epi64(l, zero));
+
+                __m256i five = _mm256_add_epi64(trumpShift, _mm256_set1_epi64x(4));
+                __m256i jack = _mm256_add_epi64(trumpShift, _mm256_set1_epi64x(10));
+                __m256i jackBit = _mm256_sllv_epi64(one, jack);
+                __m256i top = _mm256_or_si256(_mm256_or_si256(_mm256_sllv_epi64(one, five),
+                        jackBit), one);
+                __m256i weakerTop = _mm256_or_si256(
+                        _mm256_and_si256(_mm256_cmpeq_epi64(l, five),
+                                _mm256_or_si256(jackBit, one)),
+                        _mm256_and_si256(_mm256_cmpeq_epi64(l, jack), one));
+                __m256i forced = _mm256_or_si256(_mm256_andnot_si256(top, inTrump),
+                        _mm256_and_si256(hand, weakerTop));
+                __m256i trumpLed = _mm256_blendv_epi8(inTrump, hand,
+                        _mm256_cmpeq_epi64(forced, zero));
+
+                __m256i follow = _mm256_andnot_si256(one, _mm256_and_si256(hand,
+                        _mm256_sllv_epi64(suitBits, ledShift)));
+                __m256i otherLed = _mm256_blendv_epi8(_mm256_or_si256(follow, inTrump), hand,
+                        _mm256_cmpeq_epi64(follow, zero));
+                __m256i result = _mm256_blendv_epi8(otherLed, trumpLed, ledTrump);
+                result = _mm256_blendv_epi8(result, hand,
+                        _mm256_cmpgt_epi64(l, _mm256_set1_epi64x(Card::kNumCards - 1)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(legal + g), result);
+        }
+        return g;
+}
+}  // namespace
+
+TrickKernels::Isa TrickKernels::bestIsa() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+                return Isa::AVX2;
+        }
+        if (__builtin_cpu_supports("sse4.2")) {
+                return Isa::SSE42;
+        }
+        return Isa::SCALAR;
+}
+
+TrickKernels::Isa TrickKernels::getIsa() {
+        return currentIsa.load(std::memory_order_relaxed);
+}
+
+void TrickKernels::setIsa(Isa isa) {
+        if (static_cast<int>(isa) > static_cast<int>(bestIsa())) {
+                throw std::invalid_argument(std::string("this CPU can't run ") + isaName(isa));
+        }
+        currentIsa.store(isa, std::memory_order_relaxed);
+}
+
+const char* TrickKernels::isaName(Isa isa) {
+        switch (isa) {
+                case Isa::AVX2: return "avx2";
+                case Isa::SSE42: return "sse4.2";
+                default: return "scalar";
+        }
+}
+
+void TrickKernels::trickWinners(const uint8_t* const cards[4], const uint8_t* trumps, int count,
+        uint8_t* winners) {
+        int done = 0;
+        switch (getIsa()) {
+                case Isa::AVX2: done = trickWinnersAvx2(cards, trumps, count, winners); break;
+                case Isa::SSE42: done = trickWinnersSse(cards, trumps, count, winners); break;
+                default: break;
+        }
+        trickWinnersScalar(cards, trumps, done, count, winners);
+}
+
+void TrickKernels::legalPlays(const uint64_t* hands, const uint8_t* led, const uint8_t* trumps,
+        int count, uint64_t* legal) {
+        if (led == nullptr) {
+                for (int g = 0; g < count; g++) {
+                        legal[g] = hands[g];
+                }
+                return;
+        }
+        // SSE4.2 can't shift each lane by its own amount, and building the masks of every game
+        // in scalar code was slower than the scalar version, so it uses that
+        int done = 0;
+        switch (getIsa()) {
+                case Isa::AVX2: done = legalPlaysAvx2(hands, led, trumps, count, legal); break;
+                default: break;
+        }
+        legalPlaysScalar(hands, led, trumps, done, count, legal);
+}
@@ -0,0 +1,36 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <cstdint>
+
+// The rules of a trick, for many tricks at once: who wins each trick, and which cards each
+// player can play. They give the same answers as trickWinner (and so lessThan) and
+// Rules::legalPlays, but work on arrays, a game per element, like GameBatch stores its games.
+// Every function has a scalar version and an AVX2 version, and trickWinners has an SSE4.2 one.
+// legalPlays doesn't: SSE4.2 can't shift each lane by its own amount, and picking the suits'
+// masks with compares and blends took about 100 instructions for 2 hands, half the speed of the
+// scalar version, so with SSE4.2 legalPlays runs the scalar one.
+// The best one the CPU has is picked when the program starts, and setIsa picks another one (for
+// tests and benchmarks).
+// Cards are indexes (0-51) and trumps are suits (1-4). Other values give wrong answers, but
+// never read or write out of bounds.
+namespace TrickKernels {
+        enum class Isa { SCALAR, SSE42, AVX2 };
+
+        // the best version this CPU can run, and the one in use
+        Isa bestIsa();
+        Isa getIsa();
+        // throws std::invalid_argument if the CPU can't run it
+        void setIsa(Isa isa);
+        // "scalar", "sse4.2" or "avx2"
+        const char* isaName(Isa isa);
+
+        // winners[g] is the position (0-3) of the winning card of trick g, whose cards are
+        // cards[0][g] to cards[3][g] in the order they were played. The suit led is the suit of
+        // cards[0][g], and the earlier of two equal cards wins
+        void trickWinners(const uint8_t* const cards[4], const uint8_t* trumps, int count,
+                uint8_t* winners);
+        // legal[g] is the cards of hands[g] that can be played when led[g] was led.
+        // led is nullptr when every player is leading, and then legal is a copy of hands
+        void legalPlays(const uint64_t* hands, const uint8_t* led, const uint8_t* trumps, int count,
+                uint64_t* legal);
+}
@@ -0,0 +1,69 @@
+// Copyright Andrew Bernal 2023
+#pragma once
+#include <array>
+#include <cstdint>
+#include "card.hpp"
+#include "cardSet.hpp"
+#include "suit.hpp"
+
+// The trick being played, as every player can see it. The engine keeps it up to date as each
+// card lands, in O(1): the suit led, the winning card and who played it are worked out once per
+// card, so a player never has to scan the trick for them. Players get it in playCard.
+struct TrickState {
+        // the cards of this trick by player. Players who haven't played have a default Card()
+        std::array<Card, 4> cards;
+        // every card played this hand, including the ones in this trick
+        CardSet played;
+        Suit::Suit trump = Suit::INVALID;
+        // the suit of the first card, INVALID until it is played
+        Suit::Suit suitLed = Suit::INVALID;
+        int8_t leader = 0;
+        // the cards played to this trick (0-4), and the tricks finished before it this hand (0-4)
+        int8_t size = 0;
+        int8_t trickNumber = 0;
+        // the player with the strongest card so far, -1 before the lead. Ties go to the earlier
+        // card, like trickWinner
+        int8_t winner = -1;
+        Card winningCard;
+
+        TrickState() = default;
+        // a new trick, led by inpLeader, after the cards in inpPlayed
+        TrickState(Suit::Suit inpTrump, int inpLeader, int inpTrickNumber, CardSet inpPlayed)
+                : played(inpPlayed), trump(inpTrump), leader(static_cast<int8_t>(inpLeader)),
+                trickNumber(static_cast<int8_t>(inpTrickNumber)) {}
+
+        int toPlay() const {
+                return (leader + size) % 4;
+        }
+        // the first card of the trick, or a default Card if no card has been played
+        Card led() const {
+                return size == 0 ? Card() : cards[leader];
+        }
+        // true if the partner of the player to play has the strongest card so far
+        bool partnerWinning() const {
+                return winner >= 0 && winner != toPlay() && winner % 2 == toPlay() % 2;
+        }
+        bool complete() const {
+                return size == 4;
+        }
+
+        // c is played by the player to play. Needs a valid trump
+        void play(const Card& c) {
+                int seat = toPlay();
+                cards[seat] = c;
+                if (c.isValid()) {
+                        played.insert(c);
+                }
+                if (size++ == 0) {
+                        suitLed = c.getSuit();
+                        winner = static_cast<int8_t>(seat);
+                        winningCard = c;
+                        return;
+                }
+                const CardRank::Row& strengths = CardRank::row(suitLed, trump);
+                if (strengths[CardRank::slot(c)] > strengths[CardRank::slot(winningCard)]) {
+                        winner = static_cast<int8_t>(seat);
+                        winningCard = c;
+                }
+        }
+};